@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "arena.h"
+
+namespace game {
+
+Arena::Arena(std::size_t block_size)
+{
+    Block block;
+    block.size = std::max<std::size_t>(block_size, 64);
+    block.data = new char[block.size];
+    blocks_.push_back(block);
+    current_ = 0;
+    offset_ = 0;
+    used_ = 0;
+    high_water_ = 0;
+    overflows_ = 0;
+}
+
+
+Arena::~Arena()
+{
+    for (int i = 0; i < (int) blocks_.size(); i++) {
+        delete[] blocks_[i].data;
+    }
+}
+
+
+void *Arena::Allocate(std::size_t size, std::size_t alignment)
+{
+    while (true) {
+        Block &block = blocks_[current_];
+        uintptr_t base = (uintptr_t) block.data;
+        std::size_t start = (std::size_t) (((base + offset_ + alignment - 1) & ~(uintptr_t) (alignment - 1)) - base);
+        if (start + size <= block.size) {
+            used_ += start + size - offset_;
+            high_water_ = std::max(high_water_, used_);
+            offset_ = start + size;
+            return block.data + start;
+        }
+
+        // Move on to the next block, adding one if this was the last
+        current_++;
+        offset_ = 0;
+        if (current_ == (int) blocks_.size()) {
+            Block added;
+            added.size = std::max(blocks_.back().size, size + alignment);
+            added.data = new char[added.size];
+            blocks_.push_back(added);
+            overflows_++;
+        }
+    }
+}
+
+
+void Arena::Reset(void)
+{
+    // Blocks were added since the last reset: replace them all with one
+    // that holds as much, so the next frame fits without adding any
+    if (blocks_.size() > 1) {
+        std::size_t capacity = GetCapacity();
+        for (int i = 0; i < (int) blocks_.size(); i++) {
+            delete[] blocks_[i].data;
+        }
+        blocks_.resize(1);
+        blocks_[0].size = capacity;
+        blocks_[0].data = new char[capacity];
+    }
+    current_ = 0;
+    offset_ = 0;
+    used_ = 0;
+}
+
+
+std::size_t Arena::GetCapacity(void) const
+{
+    std::size_t capacity = 0;
+    for (int i = 0; i < (int) blocks_.size(); i++) {
+        capacity += blocks_[i].size;
+    }
+    return capacity;
+}
+
+
+FrameArenas::FrameArenas(void)
+{
+}
+
+
+FrameArenas::~FrameArenas()
+{
+    for (int i = 0; i < (int) arenas_.size(); i++) {
+        delete arenas_[i];
+    }
+}
+
+
+void FrameArenas::Init(int num_threads, std::size_t block_size)
+{
+    for (int i = (int) arenas_.size(); i < num_threads; i++) {
+        arenas_.push_back(new Arena(block_size));
+    }
+}
+
+
+void FrameArenas::Reset(void)
+{
+    for (int i = 0; i < (int) arenas_.size(); i++) {
+        arenas_[i]->Reset();
+    }
+}
+
+
+std::size_t FrameArenas::GetHighWater(void) const
+{
+    std::size_t high_water = 0;
+    for (int i = 0; i < (int) arenas_.size(); i++) {
+        high_water = std::max(high_water, arenas_[i]->GetHighWater());
+    }
+    return high_water;
+}
+
+
+std::size_t FrameArenas::GetCapacity(void) const
+{
+    std::size_t capacity = 0;
+    for (int i = 0; i < (int) arenas_.size(); i++) {
+        capacity += arenas_[i]->GetCapacity();
+    }
+    return capacity;
+}
+
+} // namespace game
@@ -0,0 +1,129 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace game {
+
+    // A linear allocator for data that only lives until a known point, such
+    // as the end of a tick or frame
+    // Allocation bumps an offset into a block; nothing is freed on its own,
+    // everything goes at once with Reset(). When a block fills up another is
+    // added, and the next Reset() merges them into one block big enough for
+    // all of it, so after the first few frames the arena stops touching the
+    // heap. Not thread safe: give each thread its own
+    class Arena {
+
+        public:
+            // Constructor and destructor; block_size is the size of the first block
+            Arena(std::size_t block_size = 64 * 1024);
+            ~Arena();
+
+            // Space for size bytes at the given alignment, a power of two
+            void *Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+            // Give back everything allocated; the memory is kept for reuse
+            void Reset(void);
+
+            // Bytes handed out since the last reset, alignment padding included
+            std::size_t GetUsed(void) const { return used_; }
+
+            // Most bytes ever in use at once
+            std::size_t GetHighWater(void) const { return high_water_; }
+
+            // Bytes held in blocks
+            std::size_t GetCapacity(void) const;
+
+            // Blocks added because the arena ran out of room
+            int GetNumOverflows(void) const { return overflows_; }
+
+        private:
+            Arena(const Arena&) = delete;
+            Arena &operator=(const Arena&) = delete;
+
+            struct Block {
+                char *data;
+                std::size_t size;
+            };
+            std::vector<Block> blocks_;
+
+            // Block being allocated from, and how far into it
+            int current_;
+            std::size_t offset_;
+
+            std::size_t used_;
+            std::size_t high_water_;
+            int overflows_;
+
+    }; // class Arena
+
+    // Allocator for standard containers that takes its memory from an arena
+    // Deallocation does nothing, so a container must be gone, or never be
+    // touched again, before its arena is reset
+    template <typename T>
+    class ArenaAllocator {
+
+        public:
+            typedef T value_type;
+
+            ArenaAllocator(Arena *arena) : arena_(arena) {}
+
+            template <typename U>
+            ArenaAllocator(const ArenaAllocator<U> &other) : arena_(other.GetArena()) {}
+
+            T *allocate(std::size_t count) { return static_cast<T*>(arena_->Allocate(count * sizeof(T), alignof(T))); }
+            void deallocate(T*, std::size_t) {}
+
+            Arena *GetArena(void) const { return arena_; }
+
+        private:
+            Arena *arena_;
+
+    }; // class ArenaAllocator
+
+    template <typename T, typename U>
+    bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) { return a.GetArena() == b.GetArena(); }
+
+    template <typename T, typename U>
+    bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) { return a.GetArena() != b.GetArena(); }
+
+    // Containers in an arena
+    template <typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T> >;
+    typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char> > ArenaString;
+
+    // One arena for each thread of a job system, indexed like the thread
+    // indices ParallelFor() hands out, all reset together at the end of a tick
+    class FrameArenas {
+
+        public:
+            // Constructor and destructor
+            FrameArenas(void);
+            ~FrameArenas();
+
+            // Make an arena for each of num_threads threads
+            void Init(int num_threads, std::size_t block_size = 64 * 1024);
+
+            Arena &Get(int thread_index) { return *arenas_[thread_index]; }
+            int GetNumArenas(void) const { return (int) arenas_.size(); }
+
+            // Reset every arena; no job may be running
+            void Reset(void);
+
+            // Most bytes any one arena has had in use, and the total held
+            std::size_t GetHighWater(void) const;
+            std::size_t GetCapacity(void) const;
+
+        private:
+            FrameArenas(const FrameArenas&) = delete;
+            FrameArenas &operator=(const FrameArenas&) = delete;
+
+            std::vector<Arena*> arenas_;
+
+    }; // class FrameArenas
+
+} // namespace game
+
+#endif // ARENA_H_
@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "asset_archive.h"
+
+namespace game {
+
+const uint32_t AssetArchive::VERSION;
+
+static const char archive_magic_g[8] = { 'G', '2', '5', '0', '1', 'P', 'A', 'K' };
+
+// Data of each entry starts on this boundary, so pixels and future binary
+// formats can be read in place
+static const std::size_t data_alignment_g = 16;
+
+static_assert(sizeof(ArchiveHeader) == 16, "archive header layout");
+static_assert(sizeof(ArchiveEntry) == 32, "archive entry layout");
+
+
+// Order of names in an archive: bytewise, with ASCII letters folded to lower case
+static int CompareNames(const char *a, const char *b)
+{
+    while (true) {
+        int ca = (unsigned char) *a++;
+        int cb = (unsigned char) *b++;
+        if (ca >= 'A' && ca <= 'Z') {
+            ca += 'a' - 'A';
+        }
+        if (cb >= 'A' && cb <= 'Z') {
+            cb += 'a' - 'A';
+        }
+        if (ca != cb || ca == 0) {
+            return ca - cb;
+        }
+    }
+}
+
+
+std::string NormalizeAssetName(const std::string &name)
+{
+    std::string normalized = name;
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    std::size_t start = normalized.find_first_not_of('/');
+    return start == std::string::npos ? std::string() : normalized.substr(start);
+}
+
+
+AssetArchive::AssetArchive(void)
+{
+    data_ = nullptr;
+    size_ = 0;
+    entries_ = nullptr;
+    num_entries_ = 0;
+    file_handle_ = nullptr;
+    mapping_handle_ = nullptr;
+}
+
+
+AssetArchive::~AssetArchive()
+{
+    Close();
+}
+
+
+bool AssetArchive::Open(const std::string &path, std::string &error)
+{
+    Close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "cannot open " + path;
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        error = "cannot read the size of " + path;
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void *data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!data) {
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        error = "cannot map " + path;
+        return false;
+    }
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    size_ = (std::size_t) file_size.QuadPart;
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size == 0) {
+        close(file);
+        error = "cannot read the size of " + path;
+        return false;
+    }
+    void *data = mmap(NULL, (std::size_t) status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    // The mapping keeps the file alive on its own
+    close(file);
+    if (data == MAP_FAILED) {
+        error = "cannot map " + path;
+        return false;
+    }
+    size_ = (std::size_t) status.st_size;
+#endif
+    data_ = (const unsigned char *) data;
+
+    if (!Validate(error)) {
+        error = path + ": " + error;
+        Close();
+        return false;
+    }
+    const ArchiveHeader *header = (const ArchiveHeader *) data_;
+    entries_ = (const ArchiveEntry *) (data_ + sizeof(ArchiveHeader));
+    num_entries_ = (int) header->num_entries;
+    return true;
+}
+
+
+void AssetArchive::Close(void)
+{
+    if (data_) {
+#if defined(_WIN32)
+        UnmapViewOfFile(data_);
+        CloseHandle((HANDLE) mapping_handle_);
+        CloseHandle((HANDLE) file_handle_);
+#else
+        munmap((void *) data_, size_);
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+    entries_ = nullptr;
+    num_entries_ = 0;
+    file_handle_ = nullptr;
+    mapping_handle_ = nullptr;
+}
+
+
+bool AssetArchive::Validate(std::string &error) const
+{
+    if (size_ < sizeof(ArchiveHeader)) {
+        error = "too small to be an archive";
+        return false;
+    }
+    const ArchiveHeader *header = (const ArchiveHeader *) data_;
+    if (memcmp(header->magic, archive_magic_g, sizeof(archive_magic_g)) != 0) {
+        error = "not an asset archive";
+        return false;
+    }
+    if (header->version != VERSION) {
+        error = "archive version " + std::to_string(header->version) + ", expected " + std::to_string(VERSION) + "; run the packer again";
+        return false;
+    }
+    if (header->num_entries > (size_ - sizeof(ArchiveHeader)) / sizeof(ArchiveEntry)) {
+        error = "index runs past the end of the file";
+        return false;
+    }
+
+    const ArchiveEntry *entries = (const ArchiveEntry *) (data_ + sizeof(ArchiveHeader));
+    for (uint32_t i = 0; i < header->num_entries; i++) {
+        const ArchiveEntry &entry = entries[i];
+        if (entry.name_offset >= size_ || !memchr(data_ + entry.name_offset, 0, size_ - entry.name_offset)) {
+            error = "entry " + std::to_string(i) + " has a bad name";
+            return false;
+        }
+        // Text keeps its terminating zero past the counted size
+        uint64_t extent = entry.size + (entry.type == ASSET_TEXT ? 1 : 0);
+        if (entry.offset > size_ || extent > size_ - entry.offset) {
+            error = std::string("entry ") + (const char *) (data_ + entry.name_offset) + " runs past the end of the file";
+            return false;
+        }
+        if (i > 0 && CompareNames((const char *) (data_ + entries[i - 1].name_offset), (const char *) (data_ + entry.name_offset)) >= 0) {
+            error = "index is not sorted";
+            return false;
+        }
+    }
+    return true;
+}
+
+
+bool AssetArchive::Find(const std::string &name, AssetView &view) const
+{
+    if (!data_) {
+        return false;
+    }
+    std::size_t start = name.find_first_not_of('/');
+    const char *key = start == std::string::npos ? "" : name.c_str() + start;
+
+    int low = 0, high = num_entries_ - 1;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        const ArchiveEntry &entry = entries_[middle];
+        int order = CompareNames((const char *) (data_ + entry.name_offset), key);
+        if (order < 0) {
+            low = middle + 1;
+        }
+        else if (order > 0) {
+            high = middle - 1;
+        }
+        else {
+            view.data = data_ + entry.offset;
+            view.size = (std::size_t) entry.size;
+            view.type = (int) entry.type;
+            view.width = (int) entry.width;
+            view.height = (int) entry.height;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+const char *AssetArchive::GetName(int index) const
+{
+    return (const char *) (data_ + entries_[index].name_offset);
+}
+
+
+void AssetArchiveWriter::Add(const std::string &name, int type, const void *data, std::size_t size, int width, int height)
+{
+    Entry entry;
+    entry.name = NormalizeAssetName(name);
+    entry.type = type;
+    entry.width = width;
+    entry.height = height;
+    entry.data.assign((const unsigned char *) data, (const unsigned char *) data + size);
+    entries_.push_back(entry);
+}
+
+
+bool AssetArchiveWriter::Write(const std::string &path, std::string &error) const
+{
+    // The index is sorted by name for the binary search of Find()
+    std::vector<const Entry*> sorted;
+    for (int i = 0; i < (int) entries_.size(); i++) {
+        sorted.push_back(&entries_[i]);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Entry *a, const Entry *b) { return CompareNames(a->name.c_str(), b->name.c_str()) < 0; });
+    for (int i = 1; i < (int) sorted.size(); i++) {
+        if (CompareNames(sorted[i - 1]->name.c_str(), sorted[i]->name.c_str()) == 0) {
+            error = "two entries are called " + sorted[i]->name;
+            return false;
+        }
+    }
+
+    // Lay out the names after the index, then the data
+    ArchiveHeader header;
+    memcpy(header.magic, archive_magic_g, sizeof(archive_magic_g));
+    header.version = AssetArchive::VERSION;
+    header.num_entries = (uint32_t) sorted.size();
+
+    std::vector<ArchiveEntry> index(sorted.size());
+    uint64_t offset = sizeof(ArchiveHeader) + sorted.size() * sizeof(ArchiveEntry);
+    for (int i = 0; i < (int) sorted.size(); i++) {
+        index[i].name_offset = (uint32_t) offset;
+        offset += sorted[i]->name.size() + 1;
+    }
+    for (int i = 0; i < (int) sorted.size(); i++) {
+        const Entry &entry = *sorted[i];
+        offset = (offset + data_alignment_g - 1) & ~(uint64_t) (data_alignment_g - 1);
+        index[i].type = (uint32_t) entry.type;
+        index[i].width = (uint32_t) entry.width;
+        index[i].height = (uint32_t) entry.height;
+        index[i].offset = offset;
+        index[i].size = entry.data.size();
+        offset += entry.data.size() + (entry.type == ASSET_TEXT ? 1 : 0);
+    }
+
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "cannot write " + path;
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (!index.empty()) {
+        ok = ok && fwrite(index.data(), sizeof(ArchiveEntry), index.size(), file) == index.size();
+    }
+    for (int i = 0; i < (int) sorted.size(); i++) {
+        ok = ok && fwrite(sorted[i]->name.c_str(), 1, sorted[i]->name.size() + 1, file) == sorted[i]->name.size() + 1;
+    }
+    static const unsigned char zeros[data_alignment_g] = { 0 };
+    uint64_t written = index.empty() ? sizeof(ArchiveHeader) : index.back().name_offset + sorted.back()->name.size() + 1;
+    for (int i = 0; i < (int) sorted.size() && ok; i++) {
+        const Entry &entry = *sorted[i];
+        ok = fwrite(zeros, 1, (std::size_t) (index[i].offset - written), file) == index[i].offset - written;
+        if (!entry.data.empty()) {
+            ok = ok && fwrite(entry.data.data(), 1, entry.data.size(), file) == entry.data.size();
+        }
+        if (entry.type == ASSET_TEXT) {
+            ok = ok && fputc(0, file) == 0;
+        }
+        written = index[i].offset + entry.data.size() + (entry.type == ASSET_TEXT ? 1 : 0);
+    }
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) {
+        error = "failed writing " + path;
+    }
+    return ok;
+}
+
+} // namespace game
@@ -0,0 +1,122 @@
+#ifndef ASSET_ARCHIVE_H_
+#define ASSET_ARCHIVE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace game {
+
+    // What an entry of an asset archive holds
+    enum AssetType {
+        ASSET_DATA,        // bytes, as they were in the file
+        ASSET_TEXT,        // text followed by a terminating zero not counted in its size
+        ASSET_TEXTURE      // a texture ready to upload, laid out as in texture_data.h
+    };
+
+    // An entry of an open archive; the data points into the mapped file and
+    // stays valid until the archive is closed
+    struct AssetView {
+        const unsigned char *data;
+        std::size_t size;
+        int type;
+        int width;   // textures only, of the largest level
+        int height;
+    };
+
+    // Layout of an archive file, all little endian:
+    // an ArchiveHeader, num_entries ArchiveEntry records sorted by name, the
+    // zero terminated names, then the data of each entry on a 16 byte
+    // boundary. Names are paths relative to the resources directory, with
+    // forward slashes, compared without regard to case like the files
+    // they came from
+    struct ArchiveHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t num_entries;
+    };
+
+    struct ArchiveEntry {
+        uint32_t name_offset;  // from the start of the file
+        uint32_t type;
+        uint32_t width;
+        uint32_t height;
+        uint64_t offset;       // of the data, from the start of the file
+        uint64_t size;
+    };
+
+    // A read-only archive of game assets, memory mapped as a whole
+    // Opening it is one file open and a check of the index; after that
+    // every lookup is a binary search and hands out a view of the mapped
+    // bytes, so nothing is copied or parsed
+    class AssetArchive {
+
+        public:
+            // Constructor and destructor
+            AssetArchive(void);
+            ~AssetArchive();
+
+            // Map the archive at path; on failure error says why and the archive stays closed
+            bool Open(const std::string &path, std::string &error);
+            void Close(void);
+            bool IsOpen(void) const { return data_ != nullptr; }
+
+            // Find the entry called name; a leading slash is ignored
+            bool Find(const std::string &name, AssetView &view) const;
+
+            int GetNumEntries(void) const { return num_entries_; }
+            const char *GetName(int index) const;
+            std::size_t GetSize(void) const { return size_; }
+
+            // Version written by AssetArchiveWriter and accepted by Open()
+            static const uint32_t VERSION = 2;
+
+        private:
+            AssetArchive(const AssetArchive&) = delete;
+            AssetArchive &operator=(const AssetArchive&) = delete;
+
+            const unsigned char *data_;
+            std::size_t size_;
+            const ArchiveEntry *entries_;
+            int num_entries_;
+
+            // Handles of the mapping, where the platform needs them
+            void *file_handle_;
+            void *mapping_handle_;
+
+            // Check that every entry lies inside the file
+            bool Validate(std::string &error) const;
+
+    }; // class AssetArchive
+
+    // Collects entries and writes them out as an archive; used by the packer
+    class AssetArchiveWriter {
+
+        public:
+            // Add an entry; the data is copied
+            void Add(const std::string &name, int type, const void *data, std::size_t size, int width = 0, int height = 0);
+
+            // Write every entry added so far
+            bool Write(const std::string &path, std::string &error) const;
+
+            int GetNumEntries(void) const { return (int) entries_.size(); }
+
+        private:
+            struct Entry {
+                std::string name;
+                int type;
+                int width;
+                int height;
+                std::vector<unsigned char> data;
+            };
+            std::vector<Entry> entries_;
+
+    }; // class AssetArchiveWriter
+
+    // Name of an asset as stored in an archive: no leading slash, forward slashes
+    std::string NormalizeAssetName(const std::string &name);
+
+} // namespace game
+
+#endif // ASSET_ARCHIVE_H_
@@ -0,0 +1,138 @@
+#include <SOIL/SOIL.h>
+#include <iostream>
+
+#include "asset_loader.h"
+#include "file_utils.h"
+#include "texture_data.h"
+
+namespace game {
+
+AssetLoader::AssetLoader(void)
+{
+    archive_loads_ = 0;
+    file_loads_ = 0;
+    texture_bytes_ = 0;
+    s3tc_ = false;
+}
+
+
+void AssetLoader::Init(const std::string &resources_directory, const std::string &archive_path)
+{
+    resources_directory_ = resources_directory;
+    std::string error;
+    if (archive_.Open(archive_path, error)) {
+        std::cout << "Assets: mapped " << archive_path << ", " << archive_.GetNumEntries() << " entries" << std::endl;
+    }
+    else {
+        std::cout << "Assets: no archive (" << error << "), loading files from " << resources_directory << std::endl;
+    }
+
+    s3tc_ = GLEW_EXT_texture_compression_s3tc != 0;
+    if (!s3tc_) {
+        std::cout << "Assets: no S3TC support, compressed textures are expanded as they load" << std::endl;
+    }
+}
+
+
+bool AssetLoader::UploadTexture(const std::string &name)
+{
+    AssetView asset;
+    TextureView texture;
+    if (archive_.Find(name, asset) && asset.type == ASSET_TEXTURE && ReadTexture(asset.data, asset.size, texture)) {
+        // Every level straight from the mapped archive
+        std::vector<unsigned char> expanded;
+        for (int i = 0; i < texture.num_levels; i++) {
+            const TextureLevel &level = texture.levels[i];
+            if (texture.format == TEXTURE_RGBA8) {
+                glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, level.data);
+                texture_bytes_ += level.size;
+            }
+            else if (s3tc_) {
+                GLenum format = texture.format == TEXTURE_BC1 ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                glCompressedTexImage2D(GL_TEXTURE_2D, i, format, level.width, level.height, 0, (GLsizei) level.size, level.data);
+                texture_bytes_ += level.size;
+            }
+            else {
+                DecompressLevel(texture.format, level, expanded);
+                glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, expanded.data());
+                texture_bytes_ += expanded.size();
+            }
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.num_levels - 1);
+        archive_loads_++;
+    }
+    else {
+        // A loose file: premultiplied by LoadImage, mipmapped by the driver
+        ImageData image;
+        if (!LoadImage(name, image)) {
+            return false;
+        }
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        texture_bytes_ += (std::size_t) image.width * image.height * 4 * 4 / 3;
+        FreeImage(image);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return true;
+}
+
+
+bool AssetLoader::LoadImage(const std::string &name, ImageData &image)
+{
+    AssetView asset;
+    TextureView texture;
+    image.decoded = nullptr;
+    if (archive_.Find(name, asset) && asset.type == ASSET_TEXTURE && ReadTexture(asset.data, asset.size, texture)) {
+        const TextureLevel &level = texture.levels[0];
+        if (texture.format == TEXTURE_RGBA8) {
+            image.pixels = level.data;
+        }
+        else {
+            DecompressLevel(texture.format, level, image.expanded);
+            image.pixels = image.expanded.data();
+        }
+        image.width = level.width;
+        image.height = level.height;
+        archive_loads_++;
+        return true;
+    }
+
+    std::string path = resources_directory_ + "/" + NormalizeAssetName(name);
+    image.decoded = SOIL_load_image(path.c_str(), &image.width, &image.height, 0, SOIL_LOAD_RGBA);
+    image.pixels = image.decoded;
+    if (!image.decoded) {
+        image.width = image.height = 0;
+        return false;
+    }
+    PremultiplyAlpha(image.decoded, image.width, image.height);
+    file_loads_++;
+    return true;
+}
+
+
+void AssetLoader::FreeImage(ImageData &image) const
+{
+    if (image.decoded) {
+        SOIL_free_image_data(image.decoded);
+    }
+    image.pixels = image.decoded = nullptr;
+    image.expanded.clear();
+}
+
+
+const char *AssetLoader::LoadText(const std::string &name, std::string &storage)
+{
+    AssetView view;
+    if (archive_.Find(name, view) && view.type == ASSET_TEXT) {
+        archive_loads_++;
+        return (const char *) view.data;
+    }
+
+    storage = LoadTextFile((resources_directory_ + "/" + NormalizeAssetName(name)).c_str());
+    file_loads_++;
+    return storage.c_str();
+}
+
+} // namespace game
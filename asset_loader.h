@@ -0,0 +1,75 @@
+#ifndef ASSET_LOADER_H_
+#define ASSET_LOADER_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+#include "asset_archive.h"
+
+namespace game {
+
+    // An image as RGBA8 pixels premultiplied by alpha, rows from the top
+    struct ImageData {
+        const unsigned char *pixels;
+        int width;
+        int height;
+        unsigned char *decoded;  // set when decoded from a loose file; free with AssetLoader::FreeImage()
+        std::vector<unsigned char> expanded;  // holds the pixels of a compressed texture
+    };
+
+    // Where the game gets its textures and shaders
+    // Assets come from the packed archive when there is one, as views of
+    // the mapped file, and from the loose files in the resources directory
+    // otherwise, or for anything the archive does not hold. Names are paths
+    // relative to the resources directory
+    // Textures from either place are premultiplied by alpha and mipmapped;
+    // the archive has them that way already, and compressed when it was
+    // packed so, while loose files are converted as they load
+    class AssetLoader {
+
+        public:
+            // Constructor
+            AssetLoader(void);
+
+            // Load from resources_directory, and from the archive at archive_path if it opens
+            // Needs a GL context, to know whether compressed textures can be uploaded
+            void Init(const std::string &resources_directory, const std::string &archive_path);
+
+            // Upload a texture with all its mipmaps into the bound GL_TEXTURE_2D
+            // and set its filtering; the wrapping is left to the caller
+            bool UploadTexture(const std::string &name);
+
+            // Pixels of the largest level of a texture, for building textures on the CPU
+            bool LoadImage(const std::string &name, ImageData &image);
+            void FreeImage(ImageData &image) const;
+
+            // Zero terminated text of an asset; storage holds it when it comes
+            // from a loose file. Throws std::ios_base::failure if it cannot be read
+            const char *LoadText(const std::string &name, std::string &storage);
+
+            bool HasArchive(void) const { return archive_.IsOpen(); }
+
+            // Assets served so far from the archive and from loose files
+            int GetNumArchiveLoads(void) const { return archive_loads_; }
+            int GetNumFileLoads(void) const { return file_loads_; }
+
+            // Bytes of texture memory uploaded, mipmaps included
+            std::size_t GetTextureBytes(void) const { return texture_bytes_; }
+
+        private:
+            std::string resources_directory_;
+            AssetArchive archive_;
+            int archive_loads_;
+            int file_loads_;
+            std::size_t texture_bytes_;
+
+            // Whether the GPU takes S3TC textures; if not they are expanded to RGBA8 as they load
+            bool s3tc_;
+
+    }; // class AssetLoader
+
+} // namespace game
+
+#endif // ASSET_LOADER_H_
@@ -0,0 +1,149 @@
+// Packs the game's assets into one archive the game memory maps at startup
+// Reads a manifest of paths relative to the resources directory, one per
+// line with # starting a comment. Images are turned into textures ready to
+// upload: premultiplied by alpha, with every mipmap level, and with
+// --compress stored as S3TC (BC1 when opaque, BC3 otherwise) unless their
+// line also says "uncompressed". Shaders and other text are stored with a
+// terminating zero so they can be handed to OpenGL in place; anything else
+// is stored as it is
+//
+// Usage: asset_packer [--compress] resources_directory manifest output.pak
+
+#include <SOIL/SOIL.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "asset_archive.h"
+#include "texture_data.h"
+
+using namespace game;
+
+
+// Extension of a path in lower case, without the dot
+static std::string GetExtension(const std::string &path)
+{
+    std::size_t dot = path.find_last_of('.');
+    std::size_t slash = path.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return std::string();
+    }
+    std::string extension = path.substr(dot + 1);
+    for (int i = 0; i < (int) extension.size(); i++) {
+        if (extension[i] >= 'A' && extension[i] <= 'Z') {
+            extension[i] += 'a' - 'A';
+        }
+    }
+    return extension;
+}
+
+
+static bool ReadFile(const std::string &path, std::vector<unsigned char> &data)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    data.resize(size > 0 ? (std::size_t) size : 0);
+    bool ok = size >= 0 && (data.empty() || fread(data.data(), 1, data.size(), file) == data.size());
+    fclose(file);
+    return ok;
+}
+
+
+int main(int argc, char **argv)
+{
+    bool compress = argc > 1 && !strcmp(argv[1], "--compress");
+    int first_argument = compress ? 2 : 1;
+    if (argc - first_argument != 3) {
+        fprintf(stderr, "usage: asset_packer [--compress] resources_directory manifest output.pak\n");
+        return 2;
+    }
+    std::string resources = argv[first_argument];
+    const char *manifest_path = argv[first_argument + 1];
+    const char *output_path = argv[first_argument + 2];
+
+    std::ifstream manifest(manifest_path);
+    if (manifest.fail()) {
+        fprintf(stderr, "cannot open manifest %s\n", manifest_path);
+        return 1;
+    }
+
+    AssetArchiveWriter writer;
+    std::size_t image_bytes = 0, texture_bytes = 0, text_bytes = 0, data_bytes = 0;
+    int failures = 0;
+    std::string line;
+    while (std::getline(manifest, line)) {
+        // Trim comments
+        std::size_t hash = line.find('#');
+        if (hash != std::string::npos) {
+            line.erase(hash);
+        }
+        // The path, then any options
+        std::istringstream words(line);
+        std::string name, option;
+        if (!(words >> name)) {
+            continue;
+        }
+        name = NormalizeAssetName(name);
+        bool uncompressed = false;
+        while (words >> option) {
+            if (option == "uncompressed") {
+                uncompressed = true;
+            }
+            else {
+                fprintf(stderr, "unknown option %s for %s\n", option.c_str(), name.c_str());
+                failures++;
+            }
+        }
+        std::string path = resources + "/" + name;
+        std::string extension = GetExtension(name);
+
+        if (extension == "png" || extension == "jpg" || extension == "bmp" || extension == "tga") {
+            int width, height;
+            unsigned char *image = SOIL_load_image(path.c_str(), &width, &height, 0, SOIL_LOAD_RGBA);
+            if (!image) {
+                fprintf(stderr, "cannot decode %s: %s\n", path.c_str(), SOIL_last_result());
+                failures++;
+                continue;
+            }
+            std::vector<unsigned char> texture;
+            BuildTexture(image, width, height, compress && !uncompressed, texture);
+            writer.Add(name, ASSET_TEXTURE, texture.data(), texture.size(), width, height);
+            SOIL_free_image_data(image);
+            image_bytes += (std::size_t) width * height * 4;
+            texture_bytes += texture.size();
+            continue;
+        }
+
+        std::vector<unsigned char> data;
+        if (!ReadFile(path, data)) {
+            fprintf(stderr, "cannot read %s\n", path.c_str());
+            failures++;
+            continue;
+        }
+        bool text = extension == "glsl" || extension == "txt";
+        writer.Add(name, text ? ASSET_TEXT : ASSET_DATA, data.data(), data.size());
+        (text ? text_bytes : data_bytes) += data.size();
+    }
+    if (failures > 0) {
+        fprintf(stderr, "%d assets failed, no archive written\n", failures);
+        return 1;
+    }
+
+    std::string error;
+    if (!writer.Write(output_path, error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    printf("packed %d assets into %s: %.1f MB of textures with mipmaps from %.1f MB of pixels, %.1f KB of text, %.1f KB of data\n",
+           writer.GetNumEntries(), output_path, texture_bytes / (1024.0 * 1024.0), image_bytes / (1024.0 * 1024.0),
+           text_bytes / 1024.0, data_bytes / 1024.0);
+    return 0;
+}
@@ -0,0 +1,414 @@
+#include <cmath>
+
+#include "batch_kernels.h"
+
+// SSE2 is part of every x86-64 processor; AVX2 is checked for at run time
+#if defined(__x86_64__) || defined(_M_X64)
+#define BATCH_KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX2 instructions in functions marked for it;
+// MSVC emits them anywhere intrinsics are used
+#if defined(__GNUC__) || defined(__clang__)
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+#else
+#define AVX2_FUNCTION
+#endif
+
+namespace game {
+
+// Coefficients of the odd polynomial approximating atan(a) for a in [0, 1]
+static const float atan_c1_g = 0.99997726f;
+static const float atan_c3_g = -0.33262347f;
+static const float atan_c5_g = 0.19354346f;
+static const float atan_c7_g = -0.11643287f;
+static const float atan_c9_g = 0.05265332f;
+static const float atan_c11_g = -0.01172120f;
+
+static const float pi_g = 3.14159265f;
+static const float half_pi_g = 1.57079633f;
+
+// Distance from the target at which chasers start slowing down
+static const float arrival_radius_g = 0.5f;
+
+
+void BulletBatch::Resize(int size)
+{
+    x.resize(size); y.resize(size); z.resize(size);
+    vx.resize(size); vy.resize(size); vz.resize(size);
+}
+
+
+void ChaseBatch::Resize(int size)
+{
+    x.resize(size); y.resize(size); z.resize(size);
+    vx.resize(size); vy.resize(size); vz.resize(size);
+    tx.resize(size); ty.resize(size); tz.resize(size);
+    fx.resize(size); fy.resize(size); fz.resize(size);
+    speed.resize(size);
+    dt.resize(size);
+    angle.resize(size);
+}
+
+
+float FastAtan2(float y, float x)
+{
+    float ax = std::fabs(x);
+    float ay = std::fabs(y);
+    float high = ax > ay ? ax : ay;
+    float low = ax > ay ? ay : ax;
+
+    // Reduce to an angle in [0, pi/4], then unfold into the right octant
+    float a = high > 0.0f ? low / high : 0.0f;
+    float s = a * a;
+    float r = (((((atan_c11_g * s + atan_c9_g) * s + atan_c7_g) * s + atan_c5_g) * s + atan_c3_g) * s + atan_c1_g) * a;
+    if (ay > ax) r = half_pi_g - r;
+    if (x < 0.0f) r = pi_g - r;
+    if (y < 0.0f) r = -r;
+    return r;
+}
+
+
+// Scalar versions, also used for the elements left over after the vector loops
+
+static void IntegrateBulletsScalar(BulletBatch &b, float delta_time, int begin, int end)
+{
+    for (int i = begin; i < end; i++) {
+        b.x[i] += b.vx[i] * delta_time;
+        b.y[i] += b.vy[i] * delta_time;
+        b.z[i] += b.vz[i] * delta_time;
+    }
+}
+
+
+static void SteerChasersScalar(ChaseBatch &b, int begin, int end)
+{
+    for (int i = begin; i < end; i++) {
+        float speed = b.speed[i];
+        float dt = b.dt[i];
+
+        // Steering force towards the target
+        float dx = b.tx[i] - b.x[i];
+        float dy = b.ty[i] - b.y[i];
+        float dz = b.tz[i] - b.z[i];
+        float ax = (dx * speed - b.vx[i]) + b.fx[i];
+        float ay = (dy * speed - b.vy[i]) + b.fy[i];
+        float az = (dz * speed - b.vz[i]) + b.fz[i];
+        b.angle[i] = FastAtan2(ay, ax);
+
+        // Accelerate, then hold the velocity at full speed
+        float vx = b.vx[i] + ax * dt;
+        float vy = b.vy[i] + ay * dt;
+        float vz = b.vz[i] + az * dt;
+        float inv = 1.0f / std::sqrt((vx * vx + vy * vy) + vz * vz);
+        vx = speed * (vx * inv);
+        vy = speed * (vy * inv);
+        vz = speed * (vz * inv);
+
+        // Arrival: slow down in proportion to the distance left
+        float d = std::sqrt((dx * dx + dy * dy) + dz * dz);
+        if (d < arrival_radius_g) {
+            float arrival_speed = (speed * d) / arrival_radius_g;
+            inv = 1.0f / std::sqrt((vx * vx + vy * vy) + vz * vz);
+            vx = arrival_speed * (vx * inv);
+            vy = arrival_speed * (vy * inv);
+            vz = arrival_speed * (vz * inv);
+        }
+
+        b.vx[i] = vx;
+        b.vy[i] = vy;
+        b.vz[i] = vz;
+        b.x[i] += vx * dt;
+        b.y[i] += vy * dt;
+        b.z[i] += vz * dt;
+    }
+}
+
+
+#ifdef BATCH_KERNELS_X86
+
+// SSE versions, four elements at a time
+
+static inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+
+static inline __m128 FastAtan2(__m128 y, __m128 x)
+{
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    __m128 ax = _mm_andnot_ps(sign, x);
+    __m128 ay = _mm_andnot_ps(sign, y);
+    __m128 high = _mm_max_ps(ax, ay);
+    __m128 low = _mm_min_ps(ax, ay);
+
+    __m128 a = Select(_mm_cmpgt_ps(high, zero), _mm_div_ps(low, high), zero);
+    __m128 s = _mm_mul_ps(a, a);
+    __m128 r = _mm_set1_ps(atan_c11_g);
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(atan_c9_g));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(atan_c7_g));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(atan_c5_g));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(atan_c3_g));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(atan_c1_g));
+    r = _mm_mul_ps(r, a);
+
+    r = Select(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(half_pi_g), r), r);
+    r = Select(_mm_cmplt_ps(x, zero), _mm_sub_ps(_mm_set1_ps(pi_g), r), r);
+    r = Select(_mm_cmplt_ps(y, zero), _mm_xor_ps(r, sign), r);
+    return r;
+}
+
+
+static void IntegrateBulletsSSE(BulletBatch &b, float delta_time, int count)
+{
+    __m128 dt = _mm_set1_ps(delta_time);
+    for (int i = 0; i < count; i += 4) {
+        _mm_storeu_ps(&b.x[i], _mm_add_ps(_mm_loadu_ps(&b.x[i]), _mm_mul_ps(_mm_loadu_ps(&b.vx[i]), dt)));
+        _mm_storeu_ps(&b.y[i], _mm_add_ps(_mm_loadu_ps(&b.y[i]), _mm_mul_ps(_mm_loadu_ps(&b.vy[i]), dt)));
+        _mm_storeu_ps(&b.z[i], _mm_add_ps(_mm_loadu_ps(&b.z[i]), _mm_mul_ps(_mm_loadu_ps(&b.vz[i]), dt)));
+    }
+}
+
+
+static void SteerChasersSSE(ChaseBatch &b, int count)
+{
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 radius = _mm_set1_ps(arrival_radius_g);
+
+    for (int i = 0; i < count; i += 4) {
+        __m128 speed = _mm_loadu_ps(&b.speed[i]);
+        __m128 dt = _mm_loadu_ps(&b.dt[i]);
+        __m128 x = _mm_loadu_ps(&b.x[i]);
+        __m128 y = _mm_loadu_ps(&b.y[i]);
+        __m128 z = _mm_loadu_ps(&b.z[i]);
+        __m128 vx = _mm_loadu_ps(&b.vx[i]);
+        __m128 vy = _mm_loadu_ps(&b.vy[i]);
+        __m128 vz = _mm_loadu_ps(&b.vz[i]);
+
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&b.tx[i]), x);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&b.ty[i]), y);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(&b.tz[i]), z);
+        __m128 ax = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(dx, speed), vx), _mm_loadu_ps(&b.fx[i]));
+        __m128 ay = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(dy, speed), vy), _mm_loadu_ps(&b.fy[i]));
+        __m128 az = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(dz, speed), vz), _mm_loadu_ps(&b.fz[i]));
+        _mm_storeu_ps(&b.angle[i], FastAtan2(ay, ax));
+
+        vx = _mm_add_ps(vx, _mm_mul_ps(ax, dt));
+        vy = _mm_add_ps(vy, _mm_mul_ps(ay, dt));
+        vz = _mm_add_ps(vz, _mm_mul_ps(az, dt));
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)));
+        __m128 inv = _mm_div_ps(one, length);
+        vx = _mm_mul_ps(speed, _mm_mul_ps(vx, inv));
+        vy = _mm_mul_ps(speed, _mm_mul_ps(vy, inv));
+        vz = _mm_mul_ps(speed, _mm_mul_ps(vz, inv));
+
+        __m128 d = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+        __m128 arriving = _mm_cmplt_ps(d, radius);
+        if (_mm_movemask_ps(arriving)) {
+            __m128 arrival_speed = _mm_div_ps(_mm_mul_ps(speed, d), radius);
+            length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)));
+            inv = _mm_div_ps(one, length);
+            vx = Select(arriving, _mm_mul_ps(arrival_speed, _mm_mul_ps(vx, inv)), vx);
+            vy = Select(arriving, _mm_mul_ps(arrival_speed, _mm_mul_ps(vy, inv)), vy);
+            vz = Select(arriving, _mm_mul_ps(arrival_speed, _mm_mul_ps(vz, inv)), vz);
+        }
+
+        _mm_storeu_ps(&b.vx[i], vx);
+        _mm_storeu_ps(&b.vy[i], vy);
+        _mm_storeu_ps(&b.vz[i], vz);
+        _mm_storeu_ps(&b.x[i], _mm_add_ps(x, _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(&b.y[i], _mm_add_ps(y, _mm_mul_ps(vy, dt)));
+        _mm_storeu_ps(&b.z[i], _mm_add_ps(z, _mm_mul_ps(vz, dt)));
+    }
+}
+
+
+// AVX2 versions, eight elements at a time
+
+AVX2_FUNCTION static inline __m256 FastAtan2(__m256 y, __m256 x)
+{
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    __m256 ax = _mm256_andnot_ps(sign, x);
+    __m256 ay = _mm256_andnot_ps(sign, y);
+    __m256 high = _mm256_max_ps(ax, ay);
+    __m256 low = _mm256_min_ps(ax, ay);
+
+    __m256 a = _mm256_blendv_ps(zero, _mm256_div_ps(low, high), _mm256_cmp_ps(high, zero, _CMP_GT_OQ));
+    __m256 s = _mm256_mul_ps(a, a);
+    __m256 r = _mm256_set1_ps(atan_c11_g);
+    r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(atan_c9_g));
+    r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(atan_c7_g));
+    r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(atan_c5_g));
+    r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(atan_c3_g));
+    r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(atan_c1_g));
+    r = _mm256_mul_ps(r, a);
+
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(half_pi_g), r), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(pi_g), r), _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+    r = _mm256_blendv_ps(r, _mm256_xor_ps(r, sign), _mm256_cmp_ps(y, zero, _CMP_LT_OQ));
+    return r;
+}
+
+
+AVX2_FUNCTION static void IntegrateBulletsAVX2(BulletBatch &b, float delta_time, int count)
+{
+    __m256 dt = _mm256_set1_ps(delta_time);
+    for (int i = 0; i < count; i += 8) {
+        _mm256_storeu_ps(&b.x[i], _mm256_add_ps(_mm256_loadu_ps(&b.x[i]), _mm256_mul_ps(_mm256_loadu_ps(&b.vx[i]), dt)));
+        _mm256_storeu_ps(&b.y[i], _mm256_add_ps(_mm256_loadu_ps(&b.y[i]), _mm256_mul_ps(_mm256_loadu_ps(&b.vy[i]), dt)));
+        _mm256_storeu_ps(&b.z[i], _mm256_add_ps(_mm256_loadu_ps(&b.z[i]), _mm256_mul_ps(_mm256_loadu_ps(&b.vz[i]), dt)));
+    }
+}
+
+
+AVX2_FUNCTION static void SteerChasersAVX2(ChaseBatch &b, int count)
+{
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 radius = _mm256_set1_ps(arrival_radius_g);
+
+    for (int i = 0; i < count; i += 8) {
+        __m256 speed = _mm256_loadu_ps(&b.speed[i]);
+        __m256 dt = _mm256_loadu_ps(&b.dt[i]);
+        __m256 x = _mm256_loadu_ps(&b.x[i]);
+        __m256 y = _mm256_loadu_ps(&b.y[i]);
+        __m256 z = _mm256_loadu_ps(&b.z[i]);
+        __m256 vx = _mm256_loadu_ps(&b.vx[i]);
+        __m256 vy = _mm256_loadu_ps(&b.vy[i]);
+        __m256 vz = _mm256_loadu_ps(&b.vz[i]);
+
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&b.tx[i]), x);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&b.ty[i]), y);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(&b.tz[i]), z);
+        __m256 ax = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(dx, speed), vx), _mm256_loadu_ps(&b.fx[i]));
+        __m256 ay = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(dy, speed), vy), _mm256_loadu_ps(&b.fy[i]));
+        __m256 az = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(dz, speed), vz), _mm256_loadu_ps(&b.fz[i]));
+        _mm256_storeu_ps(&b.angle[i], FastAtan2(ay, ax));
+
+        vx = _mm256_add_ps(vx, _mm256_mul_ps(ax, dt));
+        vy = _mm256_add_ps(vy, _mm256_mul_ps(ay, dt));
+        vz = _mm256_add_ps(vz, _mm256_mul_ps(az, dt));
+        __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz)));
+        __m256 inv = _mm256_div_ps(one, length);
+        vx = _mm256_mul_ps(speed, _mm256_mul_ps(vx, inv));
+        vy = _mm256_mul_ps(speed, _mm256_mul_ps(vy, inv));
+        vz = _mm256_mul_ps(speed, _mm256_mul_ps(vz, inv));
+
+        __m256 d = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz)));
+        __m256 arriving = _mm256_cmp_ps(d, radius, _CMP_LT_OQ);
+        if (_mm256_movemask_ps(arriving)) {
+            __m256 arrival_speed = _mm256_div_ps(_mm256_mul_ps(speed, d), radius);
+            length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz)));
+            inv = _mm256_div_ps(one, length);
+            vx = _mm256_blendv_ps(vx, _mm256_mul_ps(arrival_speed, _mm256_mul_ps(vx, inv)), arriving);
+            vy = _mm256_blendv_ps(vy, _mm256_mul_ps(arrival_speed, _mm256_mul_ps(vy, inv)), arriving);
+            vz = _mm256_blendv_ps(vz, _mm256_mul_ps(arrival_speed, _mm256_mul_ps(vz, inv)), arriving);
+        }
+
+        _mm256_storeu_ps(&b.vx[i], vx);
+        _mm256_storeu_ps(&b.vy[i], vy);
+        _mm256_storeu_ps(&b.vz[i], vz);
+        _mm256_storeu_ps(&b.x[i], _mm256_add_ps(x, _mm256_mul_ps(vx, dt)));
+        _mm256_storeu_ps(&b.y[i], _mm256_add_ps(y, _mm256_mul_ps(vy, dt)));
+        _mm256_storeu_ps(&b.z[i], _mm256_add_ps(z, _mm256_mul_ps(vz, dt)));
+    }
+}
+
+
+static bool CpuHasAVX2(void)
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // The OS has to save the wide registers on context switches as well
+    __cpuid(info, 1);
+    bool avx = (info[2] & (1 << 28)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!avx || !osxsave || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif // BATCH_KERNELS_X86
+
+
+int GetBestKernelPath(void)
+{
+#ifdef BATCH_KERNELS_X86
+    static const int best = CpuHasAVX2() ? KERNEL_AVX2 : KERNEL_SSE;
+    return best;
+#else
+    return KERNEL_SCALAR;
+#endif
+}
+
+
+const char *GetKernelPathName(int path)
+{
+    static const char *names[NUM_KERNEL_PATHS] = { "scalar", "sse", "avx2" };
+    return names[path];
+}
+
+
+void IntegrateBullets(BulletBatch &batch, float delta_time, int path)
+{
+    int count = batch.Size();
+    int vector_count = 0;
+
+    // Paths the processor does not have fall back to the scalar loop
+    if (path > GetBestKernelPath()) {
+        path = KERNEL_SCALAR;
+    }
+#ifdef BATCH_KERNELS_X86
+    if (path == KERNEL_AVX2) {
+        vector_count = count & ~7;
+        IntegrateBulletsAVX2(batch, delta_time, vector_count);
+    }
+    else if (path == KERNEL_SSE) {
+        vector_count = count & ~3;
+        IntegrateBulletsSSE(batch, delta_time, vector_count);
+    }
+#endif
+    IntegrateBulletsScalar(batch, delta_time, vector_count, count);
+}
+
+
+void SteerChasers(ChaseBatch &batch, int path)
+{
+    int count = batch.Size();
+    int vector_count = 0;
+
+    if (path > GetBestKernelPath()) {
+        path = KERNEL_SCALAR;
+    }
+#ifdef BATCH_KERNELS_X86
+    if (path == KERNEL_AVX2) {
+        vector_count = count & ~7;
+        SteerChasersAVX2(batch, vector_count);
+    }
+    else if (path == KERNEL_SSE) {
+        vector_count = count & ~3;
+        SteerChasersSSE(batch, vector_count);
+    }
+#endif
+    SteerChasersScalar(batch, vector_count, count);
+}
+
+} // namespace game
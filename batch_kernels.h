@@ -0,0 +1,77 @@
+#ifndef BATCH_KERNELS_H_
+#define BATCH_KERNELS_H_
+
+#include <vector>
+
+namespace game {
+
+    // Instruction sets the kernels can run with, slowest first
+    enum KernelPath {
+        KERNEL_SCALAR,
+        KERNEL_SSE,
+        KERNEL_AVX2,
+        NUM_KERNEL_PATHS
+    };
+
+    // Bullets moving in a straight line, one array per component
+    // Filled by index after a Resize(), so refilling every tick reuses the
+    // arrays without growing them element by element
+    struct BulletBatch {
+        std::vector<float> x, y, z;    // position
+        std::vector<float> vx, vy, vz; // velocity: direction times speed
+
+        int Size(void) const { return (int) x.size(); }
+        void Resize(int size);
+        void Set(int i, float px, float py, float pz, float dx, float dy, float dz)
+        {
+            x[i] = px; y[i] = py; z[i] = pz;
+            vx[i] = dx; vy[i] = dy; vz[i] = dz;
+        }
+    };
+
+    // Enemies chasing a target, one array per component
+    // The steering matches EnemyGameObject in the intercepting state, but
+    // for headings, which come from FastAtan2() rather than atan2()
+    // Filled by index after a Resize(), like BulletBatch
+    struct ChaseBatch {
+        std::vector<float> x, y, z;    // position
+        std::vector<float> vx, vy, vz; // velocity
+        std::vector<float> tx, ty, tz; // target being chased
+        std::vector<float> fx, fy, fz; // extra steering force, such as from neighbours
+        std::vector<float> speed;
+        std::vector<float> dt;         // time step of each enemy
+        std::vector<float> angle;      // output: heading of the steering force, in (-pi, pi]
+
+        int Size(void) const { return (int) x.size(); }
+        void Resize(int size);
+        void Set(int i, float px, float py, float pz, float pvx, float pvy, float pvz,
+                 float ptx, float pty, float ptz, float pfx, float pfy, float pfz, float pspeed, float pdt)
+        {
+            x[i] = px; y[i] = py; z[i] = pz;
+            vx[i] = pvx; vy[i] = pvy; vz[i] = pvz;
+            tx[i] = ptx; ty[i] = pty; tz[i] = ptz;
+            fx[i] = pfx; fy[i] = pfy; fz[i] = pfz;
+            speed[i] = pspeed;
+            dt[i] = pdt;
+        }
+    };
+
+    // Fastest path this processor supports
+    int GetBestKernelPath(void);
+
+    // Name of a path, for logs and benchmarks
+    const char *GetKernelPathName(int path);
+
+    // Move every bullet by its velocity over delta_time
+    void IntegrateBullets(BulletBatch &batch, float delta_time, int path);
+
+    // Steer every enemy towards its target for its own time step
+    void SteerChasers(ChaseBatch &batch, int path);
+
+    // Arctangent of y/x, within about 2e-6 radians of atan2()
+    // Used by every path so they all agree on the headings
+    float FastAtan2(float y, float x);
+
+} // namespace game
+
+#endif // BATCH_KERNELS_H_
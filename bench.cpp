@@ -0,0 +1,387 @@
+// Microbenchmarks of the hot paths of a frame
+// Each benchmark builds a fixed random world, is warmed up, then timed
+// over a number of samples. The iterations in a sample are calibrated so a
+// sample lasts long enough for the clock to be accurate. Setup that must
+// not be timed, such as putting moved objects back, runs before each
+// sample. Results are printed and can be written as JSON for bench_compare
+//
+// Usage: bench [--filter text] [--reps samples] [--json file]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "bullet_game_object.h"
+#include "collision_system.h"
+#include "enemy_game_object.h"
+#include "flow_field.h"
+#include "hud.h"
+#include "particle_geometry.h"
+#include "render_command_buffer.h"
+#include "spatial_index.h"
+
+using namespace game;
+
+// Objects in the populated benchmarks
+static const int count_g = 10000;
+
+// Fixed tick of the simulation
+static const double tick_g = 1.0 / 30.0;
+
+// Time spent running a benchmark before it is measured
+static const double warmup_seconds_g = 0.05;
+
+// Shortest time a single sample may take
+static const double min_sample_seconds_g = 0.01;
+
+// A timed piece of work
+// run does items units of work; reset, if given, prepares the state for
+// the next sample and is not timed
+struct Benchmark {
+    const char *name;
+    int items;
+    std::function<void(void)> reset;
+    std::function<void(void)> run;
+};
+
+// Timings of one benchmark, all in nanoseconds per iteration
+struct Result {
+    std::string name;
+    int items;
+    long long iterations;
+    int samples;
+    double min_ns;
+    double median_ns;
+    double mean_ns;
+    double stddev_ns;
+};
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static float Random(float low, float high)
+{
+    return low + (high - low) * (float) rand() / (float) RAND_MAX;
+}
+
+// Seconds taken by the given number of iterations, after an untimed reset
+static double TimeIterations(const Benchmark &benchmark, long long iterations)
+{
+    if (benchmark.reset) {
+        benchmark.reset();
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < iterations; i++) {
+        benchmark.run();
+    }
+    return Seconds(start);
+}
+
+static Result Measure(const Benchmark &benchmark, int reps)
+{
+    // Warm the caches and the branch predictors, doubling the iterations
+    // until the warmup time is used; this also finds the sample length
+    long long iterations = 1;
+    double elapsed = 0.0;
+    for (;;) {
+        double seconds = TimeIterations(benchmark, iterations);
+        elapsed += seconds;
+        if (seconds >= min_sample_seconds_g && elapsed >= warmup_seconds_g) {
+            break;
+        }
+        if (seconds < min_sample_seconds_g) {
+            iterations *= 2;
+        }
+    }
+
+    std::vector<double> samples(reps);
+    for (int i = 0; i < reps; i++) {
+        samples[i] = TimeIterations(benchmark, iterations) * 1e9 / (double) iterations;
+    }
+
+    Result result;
+    result.name = benchmark.name;
+    result.items = benchmark.items;
+    result.iterations = iterations;
+    result.samples = reps;
+
+    double sum = 0.0;
+    for (int i = 0; i < reps; i++) {
+        sum += samples[i];
+    }
+    result.mean_ns = sum / reps;
+    double variance = 0.0;
+    for (int i = 0; i < reps; i++) {
+        variance += (samples[i] - result.mean_ns) * (samples[i] - result.mean_ns);
+    }
+    result.stddev_ns = reps > 1 ? std::sqrt(variance / (reps - 1)) : 0.0;
+
+    std::sort(samples.begin(), samples.end());
+    result.min_ns = samples[0];
+    result.median_ns = reps % 2 ? samples[reps / 2] : 0.5 * (samples[reps / 2 - 1] + samples[reps / 2]);
+    return result;
+}
+
+static bool WriteJson(const char *path, const std::vector<Result> &results, int reps)
+{
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "{\n");
+    fprintf(file, "  \"suite\": \"bench\",\n");
+#ifdef __VERSION__
+    fprintf(file, "  \"compiler\": \"%s\",\n", __VERSION__);
+#else
+    fprintf(file, "  \"compiler\": \"unknown\",\n");
+#endif
+    fprintf(file, "  \"reps\": %d,\n", reps);
+    fprintf(file, "  \"results\": [\n");
+    for (int i = 0; i < (int) results.size(); i++) {
+        const Result &r = results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"items\": %d, \"iterations\": %lld, \"samples\": %d, "
+                      "\"min_ns\": %.1f, \"median_ns\": %.1f, \"mean_ns\": %.1f, \"stddev_ns\": %.1f, \"ns_per_item\": %.3f}%s\n",
+                r.name.c_str(), r.items, r.iterations, r.samples, r.min_ns, r.median_ns, r.mean_ns, r.stddev_ns,
+                r.median_ns / r.items, i + 1 < (int) results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return true;
+}
+
+
+int main(int argc, char **argv)
+{
+    const char *filter = nullptr;
+    const char *json_path = nullptr;
+    int reps = 15;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+            filter = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--reps") && i + 1 < argc) {
+            reps = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+            json_path = argv[++i];
+        }
+        else {
+            reps = 0;
+            break;
+        }
+    }
+    if (reps <= 0) {
+        fprintf(stderr, "usage: bench [--filter text] [--reps samples] [--json file]\n");
+        return 1;
+    }
+
+    // The same random world for every run
+    srand(2501);
+    std::vector<Benchmark> benchmarks;
+
+    // Transformation and uniforms of every object, recorded into a draw list
+    std::vector<GameObject*> sprites;
+    for (int i = 0; i < count_g; i++) {
+        GameObject *object = new GameObject(glm::vec3(Random(-50.0f, 50.0f), Random(-50.0f, 50.0f), 0.0f), nullptr, nullptr, 0);
+        object->SetRotation(Random(0.0f, 6.2831853f));
+        sprites.push_back(object);
+    }
+    DrawList draw_list;
+    benchmarks.push_back({ "render_matrix", count_g, nullptr, [&]() {
+        draw_list.Clear();
+        for (int i = 0; i < count_g; i++) {
+            sprites[i]->Render(draw_list, 0, 1.0);
+        }
+    }});
+
+    // Angle normalisation, with angles well outside one turn
+    std::vector<float> angles(count_g);
+    for (int i = 0; i < count_g; i++) {
+        angles[i] = Random(-100.0f, 100.0f);
+    }
+    benchmarks.push_back({ "set_rotation", count_g, nullptr, [&]() {
+        for (int i = 0; i < count_g; i++) {
+            sprites[i]->SetRotation(angles[i]);
+        }
+    }});
+
+    // Chase steering, from the same starting places every sample
+    std::vector<EnemyGameObject*> enemies;
+    std::vector<glm::vec3> enemy_starts;
+    for (int i = 0; i < count_g; i++) {
+        glm::vec3 position(Random(-50.0f, 50.0f), Random(-50.0f, 50.0f), 0.0f);
+        EnemyGameObject *enemy = new EnemyGameObject(position, nullptr, nullptr, 0);
+        enemy->state_ = INTERCEPTING_;
+        enemy->updatePlayerPos(glm::vec3(Random(-5.0f, 5.0f), Random(-5.0f, 5.0f), -1.0f));
+        enemies.push_back(enemy);
+        enemy_starts.push_back(position);
+    }
+    benchmarks.push_back({ "enemy_update", count_g, [&]() {
+        for (int i = 0; i < count_g; i++) {
+            enemies[i]->SetPosition(enemy_starts[i]);
+            enemies[i]->velocity = glm::vec3(0.0f);
+        }
+    }, [&]() {
+        for (int i = 0; i < count_g; i++) {
+            enemies[i]->Update(tick_g);
+        }
+    }});
+
+    // Bullet movement and ageing
+    std::vector<BulletGameObject*> bullets;
+    std::vector<glm::vec3> bullet_starts;
+    for (int i = 0; i < count_g; i++) {
+        float angle = Random(0.0f, 6.2831853f);
+        glm::vec3 position(Random(-50.0f, 50.0f), Random(-50.0f, 50.0f), 0.0f);
+        bullets.push_back(new BulletGameObject(position, nullptr, nullptr, 0, glm::vec3(cos(angle), sin(angle), 0.0f), 10.0f, true));
+        bullet_starts.push_back(position);
+    }
+    benchmarks.push_back({ "bullet_update", count_g, [&]() {
+        for (int i = 0; i < count_g; i++) {
+            bullets[i]->SetPosition(bullet_starts[i]);
+        }
+    }, [&]() {
+        for (int i = 0; i < count_g; i++) {
+            bullets[i]->Update(tick_g);
+        }
+    }});
+
+    // The collision pass of a tick: index the proxies, then find contacts
+    // on one thread. A quarter of the objects are bullets and a few pickups
+    static const int kinds[] = { COLLIDER_ENEMY, COLLIDER_ORBIT_ENEMY, COLLIDER_FRIENDLY_BULLET, COLLIDER_ENEMY_BULLET,
+                                 COLLIDER_ENEMY, COLLIDER_FRIENDLY_BULLET, COLLIDER_ENEMY, COLLIDER_BONE };
+    std::vector<CollisionProxy> proxies(count_g);
+    for (int i = 0; i < count_g; i++) {
+        proxies[i].object = nullptr;
+        proxies[i].position = glm::vec2(Random(-50.0f, 50.0f), Random(-50.0f, 50.0f));
+        proxies[i].kind = i == 0 ? COLLIDER_PLAYER : kinds[i % 8];
+        proxies[i].collidable = true;
+        if (proxies[i].kind == COLLIDER_FRIENDLY_BULLET || proxies[i].kind == COLLIDER_ENEMY_BULLET) {
+            proxies[i].shape = CollisionShape::Capsule(0.15f, 0.075f).Transformed(glm::vec2(1.0f), Random(0.0f, 6.2831853f));
+        }
+        else if (proxies[i].kind == COLLIDER_BONE) {
+            proxies[i].shape = CollisionShape::Box(glm::vec2(0.4f, 0.4f));
+        }
+        else {
+            proxies[i].shape = CollisionShape::Circle(0.3f);
+        }
+    }
+    SpatialIndex spatial_index;
+    CollisionSystem collisions;
+    collisions.Init(nullptr);
+    std::vector<Contact> contacts;
+    benchmarks.push_back({ "collision_pass", count_g, nullptr, [&]() {
+        spatial_index.Build(proxies);
+        collisions.FindContacts(proxies, contacts);
+    }});
+
+    // The blast queries of a tick with a handful of bombs going off
+    static const int num_bombs = 16;
+    std::vector<glm::vec2> blasts(num_bombs);
+    for (int i = 0; i < num_bombs; i++) {
+        blasts[i] = glm::vec2(Random(-50.0f, 50.0f), Random(-50.0f, 50.0f));
+    }
+    std::vector<QueryHit> hits;
+    int blast_hits = 0;
+    benchmarks.push_back({ "bomb_explosions", num_bombs, [&]() {
+        spatial_index.Build(proxies);
+    }, [&]() {
+        for (int i = 0; i < num_bombs; i++) {
+            spatial_index.QueryRadius(blasts[i], 2.0f, QUERY_ENEMIES, hits);
+            blast_hits += (int) hits.size();
+        }
+    }});
+
+    // Flow fields around a hundred walls, with the goal stepping between two
+    // cells so every tick has a build to work on. flow_field_tick is the
+    // cost of a tick at the default budget, flow_field_rebuild a whole field
+    static const int field_size = 128;
+    FlowField tick_field(field_size, 1.0f);
+    FlowField build_field(field_size, 1.0f);
+    build_field.SetBudget(field_size * field_size);
+    for (int i = 0; i < 100; i++) {
+        glm::vec2 low(Random(-60.0f, 55.0f), Random(-60.0f, 55.0f));
+        glm::vec2 high = low + (i % 2 == 0 ? glm::vec2(Random(2.0f, 12.0f), 1.0f) : glm::vec2(1.0f, Random(2.0f, 12.0f)));
+        if (low.x > 2.0f || high.x < -1.0f || low.y > 2.0f || high.y < -1.0f) {
+            tick_field.SetBlocked(low, high, true);
+            build_field.SetBlocked(low, high, true);
+        }
+    }
+    int field_ticks = 0;
+    benchmarks.push_back({ "flow_field_tick", 1, nullptr, [&]() {
+        field_ticks++;
+        tick_field.Update(glm::vec2(0.5f + (float) (field_ticks % 2), 0.5f));
+    }});
+    int field_builds = 0;
+    benchmarks.push_back({ "flow_field_rebuild", field_size * field_size, nullptr, [&]() {
+        field_builds++;
+        build_field.Update(glm::vec2(0.5f + (float) (field_builds % 2), 0.5f));
+    }});
+
+    // Chase targets of every enemy through a finished field
+    glm::vec3 field_goal(0.5f, 0.5f, 0.0f);
+    glm::vec3 chase_sum(0.0f);
+    benchmarks.push_back({ "flow_field_lookup", count_g, [&]() {
+        build_field.Update(glm::vec2(field_goal));
+    }, [&]() {
+        for (int i = 0; i < count_g; i++) {
+            chase_sum += build_field.GetChaseTarget(enemy_starts[i], field_goal);
+        }
+    }});
+
+    // HUD digits and icons, with the values changing every call
+    HudTextures hud_textures;
+    memset(&hud_textures, 0, sizeof(hud_textures));
+    HUD hud(hud_textures, nullptr, nullptr, glm::mat4(1.0f), nullptr);
+    Arena hud_arena;
+    hud.SetFrameArena(&hud_arena);
+    int hud_calls = 0;
+    benchmarks.push_back({ "hud_update", 1, nullptr, [&]() {
+        hud_calls++;
+        hud_arena.Reset();
+        hud.Update(hud_calls % 10000, hud_calls % 4, hud_calls % 4, hud_calls % 2 == 0, 2.5f,
+                   glm::vec2((float) (hud_calls % 97) - 48.0f, (float) (hud_calls % 89) - 44.0f), hud_calls % 10, tick_g);
+    }});
+
+    // Vertices of a particle system
+    std::vector<GLfloat> vertices;
+    std::vector<GLuint> faces;
+    benchmarks.push_back({ "particle_geometry", 100, [&]() {
+        srand(2501);
+    }, [&]() {
+        BuildParticleVertices(100, 200.0, 0.6, vertices, faces);
+    }});
+
+    printf("%d samples per benchmark, times per iteration\n\n", reps);
+    printf("%-20s %8s %10s %12s %12s %12s %10s %12s\n", "benchmark", "items", "iters", "min us", "median us", "mean us", "stddev %", "ns/item");
+
+    std::vector<Result> results;
+    for (int i = 0; i < (int) benchmarks.size(); i++) {
+        if (filter && !strstr(benchmarks[i].name, filter)) {
+            continue;
+        }
+        Result r = Measure(benchmarks[i], reps);
+        printf("%-20s %8d %10lld %12.3f %12.3f %12.3f %10.2f %12.3f\n", r.name.c_str(), r.items, r.iterations,
+               r.min_ns / 1000.0, r.median_ns / 1000.0, r.mean_ns / 1000.0,
+               r.mean_ns > 0.0 ? 100.0 * r.stddev_ns / r.mean_ns : 0.0, r.median_ns / r.items);
+        results.push_back(r);
+    }
+    // Printed so the work cannot be optimized away
+    printf("\n(%d draws, %d contacts, %d blast hits, %d vertices, %d field builds, %.0f chase sum)\n",
+           (int) draw_list.GetRequests().size(), (int) contacts.size(), blast_hits, (int) vertices.size(),
+           tick_field.GetNumBuilds() + build_field.GetNumBuilds(), chase_sum.x + chase_sum.y);
+
+    if (json_path && !WriteJson(json_path, results, reps)) {
+        fprintf(stderr, "could not write %s\n", json_path);
+        return 1;
+    }
+    return 0;
+}
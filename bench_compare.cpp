@@ -0,0 +1,86 @@
+// Compares two result files written by bench --json
+// Reports the change in median time of every benchmark and flags those
+// that got slower by more than the threshold. Exits with 1 if any did, so
+// it can fail a build
+//
+// Usage: bench_compare baseline.json current.json [threshold percent]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+// Median time of each benchmark in a result file, by name
+// Reads only the flat result objects bench writes, not JSON in general
+static bool ReadResults(const char *path, std::map<std::string, double> &medians)
+{
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    std::string text;
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, read);
+    }
+    fclose(file);
+
+    size_t at = 0;
+    while ((at = text.find("\"name\":", at)) != std::string::npos) {
+        size_t open = text.find('"', at + 7);
+        size_t close = open == std::string::npos ? open : text.find('"', open + 1);
+        size_t end = text.find('}', at);
+        size_t median = text.find("\"median_ns\":", at);
+        if (close == std::string::npos || median == std::string::npos || median > end) {
+            return false;
+        }
+        medians[text.substr(open + 1, close - open - 1)] = atof(text.c_str() + median + 12);
+        at = end;
+    }
+    return !medians.empty();
+}
+
+
+int main(int argc, char **argv)
+{
+    double threshold = argc > 3 ? atof(argv[3]) : 5.0;
+    if (argc < 3 || argc > 4 || threshold <= 0.0) {
+        fprintf(stderr, "usage: bench_compare baseline.json current.json [threshold percent]\n");
+        return 2;
+    }
+
+    std::map<std::string, double> baseline, current;
+    if (!ReadResults(argv[1], baseline)) {
+        fprintf(stderr, "could not read results from %s\n", argv[1]);
+        return 2;
+    }
+    if (!ReadResults(argv[2], current)) {
+        fprintf(stderr, "could not read results from %s\n", argv[2]);
+        return 2;
+    }
+
+    printf("%-20s %14s %14s %9s\n", "benchmark", "baseline us", "current us", "change");
+    int regressions = 0;
+    for (std::map<std::string, double>::const_iterator it = baseline.begin(); it != baseline.end(); ++it) {
+        std::map<std::string, double>::const_iterator found = current.find(it->first);
+        if (found == current.end()) {
+            printf("%-20s %14.3f %14s\n", it->first.c_str(), it->second / 1000.0, "missing");
+            continue;
+        }
+        double change = it->second > 0.0 ? 100.0 * (found->second - it->second) / it->second : 0.0;
+        bool regressed = change > threshold;
+        printf("%-20s %14.3f %14.3f %+8.1f%%%s\n", it->first.c_str(), it->second / 1000.0, found->second / 1000.0,
+               change, regressed ? "  REGRESSION" : "");
+        regressions += regressed ? 1 : 0;
+    }
+    for (std::map<std::string, double>::const_iterator it = current.begin(); it != current.end(); ++it) {
+        if (baseline.find(it->first) == baseline.end()) {
+            printf("%-20s %14s %14.3f\n", it->first.c_str(), "new", it->second / 1000.0);
+        }
+    }
+
+    printf("\n%d regression%s beyond %.1f%%\n", regressions, regressions == 1 ? "" : "s", threshold);
+    return regressions > 0 ? 1 : 0;
+}
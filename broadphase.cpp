@@ -0,0 +1,11 @@
+#include "broadphase.h"
+
+namespace game {
+
+const char *GetBroadphaseName(int type)
+{
+    static const char *names[NUM_BROADPHASES] = { "grid", "sweep and prune" };
+    return names[type];
+}
+
+} // namespace game
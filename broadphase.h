@@ -0,0 +1,47 @@
+#ifndef BROADPHASE_H_
+#define BROADPHASE_H_
+
+#include <vector>
+
+namespace game {
+
+    // Defined in collision_system.h
+    struct CollisionProxy;
+
+    // Ways of finding the pairs of proxies worth an exact test
+    enum BroadphaseType {
+        BROADPHASE_GRID,            // uniform grid, suits objects spread across open ground
+        BROADPHASE_SWEEP_AND_PRUNE, // intervals sorted along x, suits dense clusters
+        NUM_BROADPHASES
+    };
+
+    // Name of a broadphase type, for logs and benchmarks
+    const char *GetBroadphaseName(int type);
+
+    // Two proxies whose bounds overlap (indices, a < b)
+    struct ProxyPair {
+        int a;
+        int b;
+    };
+
+    // Finds the pairs of proxies close enough to need an exact test
+    // Build() prepares a frame and splits the search into units of work;
+    // FindPairs() can then be called on ranges of units from several
+    // threads at once. Every pair whose bounding circles overlap is
+    // reported by exactly one unit
+    class Broadphase {
+
+        public:
+            virtual ~Broadphase(void) {}
+
+            // Prepare for the given proxies; returns the number of units of work
+            virtual int Build(const std::vector<CollisionProxy> &proxies) = 0;
+
+            // Append the pairs found by the units in [begin, end)
+            virtual void FindPairs(const std::vector<CollisionProxy> &proxies, int begin, int end, std::vector<ProxyPair> &pairs) const = 0;
+
+    }; // class Broadphase
+
+} // namespace game
+
+#endif // BROADPHASE_H_
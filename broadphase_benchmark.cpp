@@ -0,0 +1,192 @@
+// Benchmark of the collision broadphases on recorded scenarios
+// Each scenario is played forward once and every frame's proxies are
+// recorded; the recording is then replayed through the collision system
+// with each broadphase, so they all see exactly the same frames. Contact
+// counts are printed alongside the times and must match between broadphases
+//
+// Usage: broadphase_benchmark [objects] [frames]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "collision_system.h"
+
+using namespace game;
+
+// Fixed tick of the simulation
+static const float tick_g = 1.0f / 30.0f;
+
+// Objects per square unit on open ground
+static const float density_g = 0.25f;
+
+// Seconds elapsed since a starting point
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static float Random(float low, float high)
+{
+    return low + (high - low) * (float) rand() / (float) RAND_MAX;
+}
+
+// An object being recorded
+struct Mover {
+    GameObject *object;
+    glm::vec2 position;
+    glm::vec2 velocity;
+    glm::vec2 centre;   // orbit centre, for orbiting movers
+    float orbit_speed;  // radians per second; 0 moves in a straight line
+    int kind;
+    CollisionShape shape;
+};
+
+// Scenarios to record
+enum Scenario {
+    SCENARIO_OPEN_FIELD, // enemies spread out and wandering, with bullets crossing
+    SCENARIO_DISC_SWARM, // orbiting enemies packed around a few discs
+    SCENARIO_MIXED_SIZES, // open field with a few very large objects
+    SCENARIO_CHURN,      // open field where a share of objects is replaced every frame
+    NUM_SCENARIOS
+};
+
+static const char *scenario_names_g[NUM_SCENARIOS] = { "open field", "disc swarm", "mixed sizes", "churn" };
+
+static Mover MakeMover(int scenario, int index, float half)
+{
+    Mover mover;
+    mover.object = new GameObject(glm::vec3(0.0f), nullptr, nullptr, 0);
+    mover.orbit_speed = 0.0f;
+    mover.centre = glm::vec2(0.0f);
+    mover.shape = CollisionShape::Circle(0.3f);
+
+    // Every tenth object is a bullet and every twentieth a pickup
+    mover.kind = index % 10 == 0 ? COLLIDER_FRIENDLY_BULLET : (index % 20 == 5 ? COLLIDER_BONE : COLLIDER_ENEMY);
+    float speed = mover.kind == COLLIDER_FRIENDLY_BULLET ? 7.0f : (mover.kind == COLLIDER_BONE ? 0.0f : 1.5f);
+    float heading = Random(0.0f, 6.2831853f);
+    mover.velocity = glm::vec2(std::cos(heading), std::sin(heading)) * speed;
+    mover.position = glm::vec2(Random(-half, half), Random(-half, half));
+    if (mover.kind == COLLIDER_FRIENDLY_BULLET) {
+        mover.shape = CollisionShape::Capsule(0.15f, 0.075f);
+    }
+    else if (mover.kind == COLLIDER_BONE) {
+        mover.shape = CollisionShape::Box(glm::vec2(0.2f, 0.2f));
+    }
+
+    if (scenario == SCENARIO_DISC_SWARM && mover.kind == COLLIDER_ENEMY) {
+        // Rings of orbit enemies around four discs
+        static const glm::vec2 discs[4] = { glm::vec2(-20.0f, -20.0f), glm::vec2(20.0f, -20.0f), glm::vec2(-20.0f, 20.0f), glm::vec2(20.0f, 20.0f) };
+        mover.kind = COLLIDER_ORBIT_ENEMY;
+        mover.centre = discs[index % 4];
+        float radius = Random(1.0f, 6.0f);
+        mover.position = mover.centre + glm::vec2(std::cos(heading), std::sin(heading)) * radius;
+        mover.orbit_speed = Random(0.5f, 2.0f);
+    }
+    else if (scenario == SCENARIO_MIXED_SIZES && index % 500 == 1) {
+        mover.shape = CollisionShape::Circle(4.0f);
+    }
+    return mover;
+}
+
+static void MoveMover(Mover &mover, float half)
+{
+    if (mover.orbit_speed != 0.0f) {
+        glm::vec2 offset = mover.position - mover.centre;
+        float angle = mover.orbit_speed * tick_g;
+        float c = std::cos(angle);
+        float s = std::sin(angle);
+        mover.position = mover.centre + glm::vec2(c * offset.x - s * offset.y, s * offset.x + c * offset.y);
+        return;
+    }
+    mover.position += mover.velocity * tick_g;
+    // Stay on the field by bouncing off its edges
+    if (std::fabs(mover.position.x) > half) {
+        mover.velocity.x = -mover.velocity.x;
+    }
+    if (std::fabs(mover.position.y) > half) {
+        mover.velocity.y = -mover.velocity.y;
+    }
+}
+
+// Play a scenario forward and record each frame's proxies
+static void Record(int scenario, int count, int frames, std::vector<std::vector<CollisionProxy> > &recording, std::vector<GameObject*> &objects)
+{
+    srand(2501 + scenario);
+    float half = 0.5f * std::sqrt(count / density_g);
+    std::vector<Mover> movers;
+    for (int i = 0; i < count; i++) {
+        movers.push_back(MakeMover(scenario, i, half));
+    }
+
+    recording.resize(frames);
+    for (int f = 0; f < frames; f++) {
+        if (scenario == SCENARIO_CHURN) {
+            // Replace two percent of the objects; the new ones go at the end
+            for (int r = 0; r < count / 50; r++) {
+                int i = rand() % (int) movers.size();
+                objects.push_back(movers[i].object);
+                movers.erase(movers.begin() + i);
+                movers.push_back(MakeMover(scenario, rand(), half));
+            }
+        }
+
+        std::vector<CollisionProxy> &proxies = recording[f];
+        proxies.resize(movers.size());
+        for (int i = 0; i < (int) movers.size(); i++) {
+            MoveMover(movers[i], half);
+            proxies[i].object = movers[i].object;
+            proxies[i].position = movers[i].position;
+            proxies[i].shape = movers[i].shape;
+            proxies[i].kind = movers[i].kind;
+            proxies[i].collidable = true;
+        }
+    }
+    for (int i = 0; i < (int) movers.size(); i++) {
+        objects.push_back(movers[i].object);
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : 10000;
+    int frames = argc > 2 ? atoi(argv[2]) : 120;
+    if (count <= 0 || frames <= 0) {
+        fprintf(stderr, "usage: broadphase_benchmark [objects] [frames]\n");
+        return 1;
+    }
+
+    printf("%d objects, %d frames, times in milliseconds per frame\n\n", count, frames);
+    printf("%-12s %-16s %10s %10s\n", "scenario", "broadphase", "time", "contacts");
+
+    std::vector<Contact> contacts;
+    for (int scenario = 0; scenario < NUM_SCENARIOS; scenario++) {
+        std::vector<std::vector<CollisionProxy> > recording;
+        std::vector<GameObject*> objects;
+        Record(scenario, count, frames, recording, objects);
+
+        for (int type = 0; type < NUM_BROADPHASES; type++) {
+            CollisionSystem collisions;
+            collisions.SetBroadphase(type);
+
+            long long found = 0;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (int f = 0; f < frames; f++) {
+                collisions.FindContacts(recording[f], contacts);
+                found += contacts.size();
+            }
+            double seconds = Seconds(start);
+
+            printf("%-12s %-16s %10.3f %10lld\n", scenario_names_g[scenario], GetBroadphaseName(type), seconds * 1000.0 / frames, found);
+        }
+
+        for (int i = 0; i < (int) objects.size(); i++) {
+            delete objects[i];
+        }
+    }
+
+    return 0;
+}
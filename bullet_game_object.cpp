@@ -9,6 +9,8 @@ namespace game {
 
         isFriendly = isFriendlyProjectile;
         SetScale(glm::vec2(0.5, 0.5));
+        // Long and thin along the direction of travel
+        SetCollisionShape(CollisionShape::Capsule(0.3f, 0.15f));
         glm::vec3 normalizedDirection = glm::normalize(direction);
 
         // Calculate the angle in radians from the normalized direction vector
@@ -28,6 +30,10 @@ namespace game {
         if (!this->IsDisabled()) {
             position_ += direction_ * speed_ * static_cast<float>(delta_time);
         }
+        Age(delta_time);
+    }
+
+    void BulletGameObject::Age(double delta_time) {
         life_timer_ += static_cast<float>(delta_time);
 
         // Check if the bullet's life_timer_ exceeds its lifespan_
@@ -38,9 +44,9 @@ namespace game {
         GameObject::Update(delta_time);
     }
 
-    void BulletGameObject::Render(glm::mat4 view_matrix, double current_time) {
+    void BulletGameObject::Render(DrawList &draw_list, int layer, double current_time) {
 
-        GameObject::Render(view_matrix, current_time);
+        GameObject::Render(draw_list, layer, current_time);
 
     }
 
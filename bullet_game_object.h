@@ -12,7 +12,14 @@ namespace game {
         ~BulletGameObject();
         // Ensure the Update method matches the capitalization and parameter type of the base class
         void Update(double delta_time) override;
-        void Render(glm::mat4 view_matrix, double current_time) override;
+
+        // Distance covered per second; zero while disabled
+        glm::vec3 GetVelocity(void) const { return IsDisabled() ? glm::vec3(0.0f) : direction_ * speed_; }
+
+        // Everything an update does except moving; used when bullets are moved in a batch
+        void Age(double delta_time);
+
+        void Render(DrawList &draw_list, int layer, double current_time) override;
         void SetTrail(ParticleSystem* trail) { trail_ = trail; } //not used
         bool isFriendly; //used in collisions to check if its a player bullet
 
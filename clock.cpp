@@ -0,0 +1,22 @@
+#include <atomic>
+
+#include "clock.h"
+
+namespace game {
+
+// Written by the simulation thread, read by the window thread for the HUD
+static std::atomic<double> clock_time_g(0.0);
+
+
+double GetClockTime(void)
+{
+    return clock_time_g.load(std::memory_order_relaxed);
+}
+
+
+void SetClockTime(double time)
+{
+    clock_time_g.store(time, std::memory_order_relaxed);
+}
+
+} // namespace game
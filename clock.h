@@ -0,0 +1,18 @@
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+namespace game {
+
+    // Seconds of game time: how far the simulation has ticked
+    // Timers and cooldowns read time from here rather than from the window
+    // library or the wall clock, so a run without a window that ticks back
+    // to back sees the same game time a windowed run would. Safe to read
+    // from any thread
+    double GetClockTime(void);
+
+    // Set the game time; the simulation does this as it ticks
+    void SetClockTime(double time);
+
+} // namespace game
+
+#endif // CLOCK_H_
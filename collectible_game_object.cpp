@@ -10,7 +10,12 @@ namespace game {
 
 	CollectibleGameObject::CollectibleGameObject(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture)
 		: GameObject(position, geom, shader, texture)
-	{}
+	{
+		// Nothing to update until the player touches it
+		Sleep();
+		// Pickups stand upright, so a box fits them
+		SetCollisionShape(CollisionShape::Box(glm::vec2(0.4f, 0.4f)));
+	}
 
 	void CollectibleGameObject::Update(double delta_time) {
 		// Rotate the object
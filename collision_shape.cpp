@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <cmath>
+
+#include "collision_shape.h"
+
+namespace game {
+
+CollisionShape CollisionShape::Circle(float radius)
+{
+    CollisionShape shape;
+    shape.type = SHAPE_CIRCLE;
+    shape.radius = radius;
+    shape.half_extents = glm::vec2(radius, radius);
+    shape.axis = glm::vec2(0.0f, 0.0f);
+    shape.bounding_radius = radius;
+    return shape;
+}
+
+
+CollisionShape CollisionShape::Box(const glm::vec2 &half_extents)
+{
+    CollisionShape shape;
+    shape.type = SHAPE_AABB;
+    shape.radius = 0.0f;
+    shape.half_extents = half_extents;
+    shape.axis = glm::vec2(0.0f, 0.0f);
+    shape.bounding_radius = glm::length(half_extents);
+    return shape;
+}
+
+
+CollisionShape CollisionShape::Capsule(float half_length, float radius)
+{
+    CollisionShape shape;
+    shape.type = SHAPE_CAPSULE;
+    shape.radius = radius;
+    shape.half_extents = glm::vec2(radius, half_length + radius);
+    shape.axis = glm::vec2(0.0f, half_length);
+    shape.bounding_radius = half_length + radius;
+    return shape;
+}
+
+
+CollisionShape CollisionShape::Transformed(const glm::vec2 &scale, float angle) const
+{
+    switch (type) {
+        case SHAPE_AABB:
+            return Box(half_extents * scale);
+
+        case SHAPE_CAPSULE: {
+            CollisionShape shape = Capsule(axis.y * scale.y, radius * scale.x);
+            // Local y axis rotated by the object's angle
+            shape.axis = glm::vec2(-std::sin(angle), std::cos(angle)) * (axis.y * scale.y);
+            return shape;
+        }
+
+        default:
+            return Circle(radius * std::max(scale.x, scale.y));
+    }
+}
+
+
+CollisionShape CollisionShape::Swept(const glm::vec2 &motion) const
+{
+    glm::vec2 half_motion = 0.5f * motion;
+    float travel = glm::length(half_motion);
+    if (travel <= 0.0f) {
+        return *this;
+    }
+    glm::vec2 direction = half_motion / travel;
+
+    // Split the shape's own extent into parts along and across the motion
+    float along = 0.0f;
+    float across = bounding_radius;
+    if (type == SHAPE_CIRCLE) {
+        across = radius;
+    }
+    else if (type == SHAPE_CAPSULE) {
+        along = std::fabs(glm::dot(axis, direction));
+        across = radius + std::fabs(direction.x * axis.y - direction.y * axis.x);
+    }
+
+    CollisionShape shape = Capsule(along + travel, across);
+    shape.axis = direction * (along + travel);
+    return shape;
+}
+
+
+// Closest point to p on the segment from a to b
+static glm::vec2 ClosestOnSegment(const glm::vec2 &p, const glm::vec2 &a, const glm::vec2 &b)
+{
+    glm::vec2 ab = b - a;
+    float length_squared = glm::dot(ab, ab);
+    if (length_squared <= 0.0f) {
+        return a;
+    }
+    float t = glm::dot(p - a, ab) / length_squared;
+    t = std::min(1.0f, std::max(0.0f, t));
+    return a + ab * t;
+}
+
+
+// Closest point to p inside the box centred at c
+static glm::vec2 ClosestInBox(const glm::vec2 &p, const glm::vec2 &c, const glm::vec2 &half)
+{
+    return glm::vec2(std::min(c.x + half.x, std::max(c.x - half.x, p.x)),
+                     std::min(c.y + half.y, std::max(c.y - half.y, p.y)));
+}
+
+
+// Squared distance between the segments p0-p1 and q0-q1
+static float SegmentDistanceSquared(const glm::vec2 &p0, const glm::vec2 &p1, const glm::vec2 &q0, const glm::vec2 &q1)
+{
+    glm::vec2 d1 = p1 - p0;
+    glm::vec2 d2 = q1 - q0;
+    glm::vec2 r = p0 - q0;
+    float a = glm::dot(d1, d1);
+    float e = glm::dot(d2, d2);
+    float f = glm::dot(d2, r);
+    float s, t;
+
+    if (a <= 0.0f && e <= 0.0f) {
+        return glm::dot(r, r);
+    }
+    if (a <= 0.0f) {
+        s = 0.0f;
+        t = std::min(1.0f, std::max(0.0f, f / e));
+    }
+    else {
+        float c = glm::dot(d1, r);
+        if (e <= 0.0f) {
+            t = 0.0f;
+            s = std::min(1.0f, std::max(0.0f, -c / a));
+        }
+        else {
+            float b = glm::dot(d1, d2);
+            float denominator = a * e - b * b;
+            s = denominator > 0.0f ? std::min(1.0f, std::max(0.0f, (b * f - c * e) / denominator)) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = std::min(1.0f, std::max(0.0f, -c / a));
+            }
+            else if (t > 1.0f) {
+                t = 1.0f;
+                s = std::min(1.0f, std::max(0.0f, (b - c) / a));
+            }
+        }
+    }
+    glm::vec2 offset = (p0 + d1 * s) - (q0 + d2 * t);
+    return glm::dot(offset, offset);
+}
+
+
+// Whether the segment from a to b passes through the box centred at c
+// Clips the segment's parameter against the slab of each axis in turn
+static bool SegmentCrossesBox(const glm::vec2 &a, const glm::vec2 &b, const glm::vec2 &c, const glm::vec2 &half)
+{
+    float t_min = 0.0f;
+    float t_max = 1.0f;
+    glm::vec2 d = b - a;
+    for (int axis = 0; axis < 2; axis++) {
+        float low = c[axis] - half[axis] - a[axis];
+        float high = c[axis] + half[axis] - a[axis];
+        if (d[axis] == 0.0f) {
+            // Parallel to the slab: inside it throughout or never
+            if (low > 0.0f || high < 0.0f) {
+                return false;
+            }
+            continue;
+        }
+        float t0 = low / d[axis];
+        float t1 = high / d[axis];
+        t_min = std::max(t_min, std::min(t0, t1));
+        t_max = std::min(t_max, std::max(t0, t1));
+        if (t_min > t_max) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// A circle, or a capsule reduced to its segment, against a box
+// When the segment misses the box, the nearest points of the two are an
+// end of the segment and a point of the box, or a corner of the box and
+// a point of the segment, so those distances decide the overlap exactly
+static bool SegmentBoxOverlap(const glm::vec2 &a, const glm::vec2 &b, float radius, const glm::vec2 &centre, const glm::vec2 &half)
+{
+    if (SegmentCrossesBox(a, b, centre, half)) {
+        return true;
+    }
+    float radius_squared = radius * radius;
+    glm::vec2 gap = a - ClosestInBox(a, centre, half);
+    if (glm::dot(gap, gap) < radius_squared) {
+        return true;
+    }
+    gap = b - ClosestInBox(b, centre, half);
+    if (glm::dot(gap, gap) < radius_squared) {
+        return true;
+    }
+    for (int corner = 0; corner < 4; corner++) {
+        glm::vec2 point = centre + glm::vec2(corner & 1 ? half.x : -half.x, corner & 2 ? half.y : -half.y);
+        gap = point - ClosestOnSegment(point, a, b);
+        if (glm::dot(gap, gap) < radius_squared) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool ShapesOverlap(const CollisionShape &a, const glm::vec2 &position_a,
+                   const CollisionShape &b, const glm::vec2 &position_b)
+{
+    // Bounding circles first, on squared distances
+    glm::vec2 offset = position_b - position_a;
+    float distance_squared = glm::dot(offset, offset);
+    float reach = a.bounding_radius + b.bounding_radius;
+    if (distance_squared >= reach * reach) {
+        return false;
+    }
+
+    // Put the pair in a fixed order of kinds so each test is written once
+    const CollisionShape *s = &a;
+    const CollisionShape *t = &b;
+    glm::vec2 ps = position_a;
+    glm::vec2 pt = position_b;
+    if (s->type > t->type) {
+        std::swap(s, t);
+        std::swap(ps, pt);
+    }
+
+    if (s->type == SHAPE_CIRCLE && t->type == SHAPE_CIRCLE) {
+        // The bounding circles are the shapes
+        return true;
+    }
+    if (s->type == SHAPE_CIRCLE && t->type == SHAPE_AABB) {
+        glm::vec2 gap = ps - ClosestInBox(ps, pt, t->half_extents);
+        return glm::dot(gap, gap) < s->radius * s->radius;
+    }
+    if (s->type == SHAPE_CIRCLE && t->type == SHAPE_CAPSULE) {
+        glm::vec2 gap = ps - ClosestOnSegment(ps, pt - t->axis, pt + t->axis);
+        float r = s->radius + t->radius;
+        return glm::dot(gap, gap) < r * r;
+    }
+    if (s->type == SHAPE_AABB && t->type == SHAPE_AABB) {
+        return std::fabs(offset.x) < s->half_extents.x + t->half_extents.x &&
+               std::fabs(offset.y) < s->half_extents.y + t->half_extents.y;
+    }
+    if (s->type == SHAPE_AABB && t->type == SHAPE_CAPSULE) {
+        return SegmentBoxOverlap(pt - t->axis, pt + t->axis, t->radius, ps, s->half_extents);
+    }
+    // Two capsules
+    float r = s->radius + t->radius;
+    return SegmentDistanceSquared(ps - s->axis, ps + s->axis, pt - t->axis, pt + t->axis) < r * r;
+}
+
+} // namespace game
@@ -0,0 +1,48 @@
+#ifndef COLLISION_SHAPE_H_
+#define COLLISION_SHAPE_H_
+
+#include <glm/glm.hpp>
+
+namespace game {
+
+    // Kinds of collision shape
+    enum ShapeType {
+        SHAPE_CIRCLE,
+        SHAPE_AABB,
+        SHAPE_CAPSULE
+    };
+
+    // Outline an object collides with
+    // Shapes are given for an object of scale 1 facing along its local y
+    // axis; Transformed() places one in the world for an object's scale
+    // and rotation. Boxes stay aligned with the world axes
+    struct CollisionShape {
+        int type;
+        float radius;             // circle and capsule radius
+        glm::vec2 half_extents;   // box half size
+        glm::vec2 axis;           // capsule: half of the segment between the cap centres
+        float bounding_radius;    // circle around the whole shape, for quick rejection
+
+        // Constructors for each kind
+        static CollisionShape Circle(float radius);
+        static CollisionShape Box(const glm::vec2 &half_extents);
+        static CollisionShape Capsule(float half_length, float radius);
+
+        // The shape as it is in the world for the given scale and rotation
+        CollisionShape Transformed(const glm::vec2 &scale, float angle) const;
+
+        // A capsule covering the shape as it moves by motion, centred
+        // halfway along the move. Exact for circles and for capsules moving
+        // along their axis, and larger than needed otherwise
+        CollisionShape Swept(const glm::vec2 &motion) const;
+    };
+
+    // True if two shapes at the given positions overlap
+    // Quickly rejects pairs whose bounding circles are apart, then runs
+    // the exact test for the two kinds of shape
+    bool ShapesOverlap(const CollisionShape &a, const glm::vec2 &position_a,
+                       const CollisionShape &b, const glm::vec2 &position_b);
+
+} // namespace game
+
+#endif // COLLISION_SHAPE_H_
@@ -0,0 +1,146 @@
+#include <algorithm>
+
+#include "collision_system.h"
+
+namespace game {
+
+static bool IsEnemy(int kind)
+{
+    return kind == COLLIDER_ENEMY || kind == COLLIDER_ORBIT_ENEMY;
+}
+
+static bool IsPickup(int kind)
+{
+    return kind == COLLIDER_BONE || kind == COLLIDER_POTION || kind == COLLIDER_DISC;
+}
+
+
+CollisionSystem::CollisionSystem(void)
+{
+    jobs_ = nullptr;
+    SetBroadphase(BROADPHASE_GRID);
+}
+
+
+void CollisionSystem::Init(JobSystem *jobs)
+{
+    jobs_ = jobs;
+}
+
+
+void CollisionSystem::SetBroadphase(int type)
+{
+    broadphase_type_ = type;
+    if (type == BROADPHASE_SWEEP_AND_PRUNE) {
+        broadphase_ = &sweep_and_prune_;
+    }
+    else {
+        broadphase_type_ = BROADPHASE_GRID;
+        broadphase_ = &grid_;
+    }
+}
+
+
+void CollisionSystem::FindContacts(const std::vector<CollisionProxy> &proxies, std::vector<Contact> &contacts)
+{
+    contacts.clear();
+    int num_units = broadphase_->Build(proxies);
+
+    int num_threads = jobs_ ? jobs_->GetNumThreads() : 1;
+    if ((int) thread_contacts_.size() < num_threads) {
+        thread_pairs_.resize(num_threads);
+        thread_contacts_.resize(num_threads);
+    }
+    for (int i = 0; i < num_threads; i++) {
+        thread_contacts_[i].clear();
+    }
+
+    // Each chunk of work finds its pairs and tests them straight away, so
+    // the pair lists stay small
+    auto test_units = [&](int begin, int end, int thread_index) {
+        std::vector<ProxyPair> &pairs = thread_pairs_[thread_index];
+        pairs.clear();
+        broadphase_->FindPairs(proxies, begin, end, pairs);
+        for (int i = 0; i < (int) pairs.size(); i++) {
+            TestPair(proxies, pairs[i].a, pairs[i].b, thread_contacts_[thread_index]);
+        }
+    };
+    if (jobs_) {
+        jobs_->ParallelFor(num_units, 16, test_units);
+    }
+    else {
+        test_units(0, num_units, 0);
+    }
+
+    // Merge the per-thread lists and put them in a fixed order
+    for (int i = 0; i < num_threads; i++) {
+        contacts.insert(contacts.end(), thread_contacts_[i].begin(), thread_contacts_[i].end());
+    }
+    std::sort(contacts.begin(), contacts.end(), [](const Contact &x, const Contact &y) {
+        if (x.a != y.a) return x.a < y.a;
+        if (x.b != y.b) return x.b < y.b;
+        return x.type < y.type;
+    });
+}
+
+
+void CollisionSystem::TestPair(const std::vector<CollisionProxy> &proxies, int i, int j, std::vector<Contact> &out) const
+{
+    // Pairs come in index order, so contacts read the same whichever unit found them
+    const CollisionProxy &p = proxies[i];
+    const CollisionProxy &q = proxies[j];
+
+    // Skip pairs that can never interact before computing any distance
+    const CollisionProxy *player = nullptr;
+    const CollisionProxy *other = nullptr;
+    if (p.kind == COLLIDER_PLAYER) {
+        player = &p;
+        other = &q;
+    }
+    else if (q.kind == COLLIDER_PLAYER) {
+        player = &q;
+        other = &p;
+    }
+
+    bool bullet_pair = (p.kind == COLLIDER_FRIENDLY_BULLET && IsEnemy(q.kind)) || (q.kind == COLLIDER_FRIENDLY_BULLET && IsEnemy(p.kind));
+    if (!player && !bullet_pair) {
+        return;
+    }
+
+    // Shapes are tested once, whatever response the pair gets
+    bool touching = ShapesOverlap(p.shape, p.position, q.shape, q.position);
+
+    Contact contact;
+    contact.a = i;
+    contact.b = j;
+
+    if (bullet_pair) {
+        const CollisionProxy &enemy = IsEnemy(p.kind) ? p : q;
+        if (touching && enemy.collidable) {
+            contact.type = CONTACT_BULLET_HIT;
+            out.push_back(contact);
+        }
+        return;
+    }
+
+    if (IsEnemy(other->kind)) {
+        if (touching && player->collidable && other->collidable) {
+            contact.type = CONTACT_PLAYER_HIT;
+            out.push_back(contact);
+        }
+    }
+    else if (other->kind == COLLIDER_ENEMY_BULLET) {
+        if (touching) {
+            contact.type = CONTACT_PLAYER_SHOT;
+            out.push_back(contact);
+        }
+    }
+    else if (IsPickup(other->kind)) {
+        if (touching && other->collidable) {
+            contact.type = CONTACT_PICKUP;
+            out.push_back(contact);
+        }
+    }
+}
+
+} // namespace game
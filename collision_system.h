@@ -0,0 +1,99 @@
+#ifndef COLLISION_SYSTEM_H_
+#define COLLISION_SYSTEM_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "broadphase.h"
+#include "collision_shape.h"
+#include "game_object.h"
+#include "grid_broadphase.h"
+#include "job_system.h"
+#include "sweep_and_prune.h"
+
+namespace game {
+
+    // What kind of object a collision proxy stands for
+    enum ColliderKind {
+        COLLIDER_PLAYER,
+        COLLIDER_ENEMY,
+        COLLIDER_ORBIT_ENEMY,
+        COLLIDER_FRIENDLY_BULLET,
+        COLLIDER_ENEMY_BULLET,
+        COLLIDER_BONE,
+        COLLIDER_POTION,
+        COLLIDER_DISC
+    };
+
+    // What happened between two proxies
+    // Listed in the order responses for the same pair are applied
+    enum ContactType {
+        CONTACT_PLAYER_HIT,  // player touched an enemy
+        CONTACT_BULLET_HIT,  // player bullet hit an enemy
+        CONTACT_PLAYER_SHOT, // enemy bullet hit the player
+        CONTACT_PICKUP       // player touched a collectible
+    };
+
+    // An object taking part in collision detection this frame
+    struct CollisionProxy {
+        GameObject *object;
+        glm::vec2 position;
+        CollisionShape shape;   // as placed in the world
+        int kind;
+        bool collidable;
+    };
+
+    // A detected contact between proxies a and b (indices, a < b)
+    struct Contact {
+        int a;
+        int b;
+        int type;
+    };
+
+    // Finds contacts between collision proxies
+    // A broadphase, chosen at runtime, proposes pairs and the narrowphase
+    // tests them. Both run in parallel across the broadphase's units of
+    // work, each thread writing to its own contact list. The lists are merged and sorted by
+    // (a, b, type) afterwards, so the result is the same for any number of
+    // threads and matches a single threaded run exactly
+    class CollisionSystem {
+
+        public:
+            // Constructor
+            CollisionSystem(void);
+
+            // Use the given job system for the narrowphase; nullptr runs it serially
+            void Init(JobSystem *jobs);
+
+            // Choose the broadphase, one of BroadphaseType
+            void SetBroadphase(int type);
+            int GetBroadphaseType(void) const { return broadphase_type_; }
+
+            // Find all contacts between the proxies, sorted by (a, b, type)
+            // Proxies must be given in a stable order from frame to frame
+            void FindContacts(const std::vector<CollisionProxy> &proxies, std::vector<Contact> &contacts);
+
+            // Distance at which enemies notice the player; checked with a spatial query
+            static constexpr float AGGRO_DISTANCE = 2.0f;
+
+        private:
+            // Test a single pair and record any contacts
+            void TestPair(const std::vector<CollisionProxy> &proxies, int i, int j, std::vector<Contact> &out) const;
+
+            JobSystem *jobs_;
+
+            // Every broadphase, and the one in use
+            GridBroadphase grid_;
+            SweepAndPrune sweep_and_prune_;
+            Broadphase *broadphase_;
+            int broadphase_type_;
+
+            // One pair list and contact list per thread
+            std::vector<std::vector<ProxyPair> > thread_pairs_;
+            std::vector<std::vector<Contact> > thread_contacts_;
+
+    }; // class CollisionSystem
+
+} // namespace game
+
+#endif // COLLISION_SYSTEM_H_
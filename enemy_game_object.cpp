@@ -13,6 +13,9 @@ namespace game {
 		: GameObject(position, geom, shader, texture)
 	{
 		start_pos_ = position;
+		player_pos_ = position;
+		chase_target_ = position;
+		steering_force_ = glm::vec3(0.0f);
 		Timer update_timer_;
 		state_ = PATROLLING_;
 		wander_cool_down_ = 0.0;
@@ -51,32 +54,49 @@ namespace game {
 
 		}
 		if (state_ == INTERCEPTING_ && !IsDisabled()) {
-			// Chase steering behavior
+			// Most steps are steered in a batch by the simulation beforehand
+			if (steering_done_) {
+				steering_done_ = false;
+			}
+			else {
+				Steer(delta_time);
+			}
+		}
+	}
 
-			// Compute steering force (acceleration)
-			glm::vec3 desired = player_pos_ - position_;
-			glm::vec3 acc = desired * speed - velocity;
-			glm::vec3 direction = glm::normalize(acc);
-			float rotationAngle = atan2(direction.y, direction.x);
+	void EnemyGameObject::Steer(double delta_time) {
+		// Chase steering behavior
 
-			// Add steering to velocity
-			velocity += acc * ((float)delta_time);
+		// Compute steering force (acceleration)
+		glm::vec3 desired = chase_target_ - position_;
+		glm::vec3 acc = desired * speed - velocity + steering_force_;
+		glm::vec3 direction = glm::normalize(acc);
+		float rotationAngle = atan2(direction.y, direction.x);
 
-			velocity = speed * glm::normalize(velocity);
+		// Add steering to velocity
+		velocity += acc * ((float)delta_time);
 
-			// Perform arrival
-			float r = 0.5; // Distance threshold when arrival kicks in
-			float d = glm::length(player_pos_ - position_);
-			if (d < r) {
-				float z = map(d, 0, r, 0, speed);
-				velocity = z * glm::normalize(velocity);
-			}
+		velocity = speed * glm::normalize(velocity);
 
-			position_ += velocity* ((float)delta_time);
-
-			SetRotation(rotationAngle);
+		// Perform arrival
+		float r = 0.5; // Distance threshold when arrival kicks in
+		float d = glm::length(chase_target_ - position_);
+		if (d < r) {
+			float z = map(d, 0, r, 0, speed);
+			velocity = z * glm::normalize(velocity);
 		}
+
+		position_ += velocity* ((float)delta_time);
+
+		SetRotation(rotationAngle);
 	}
 
+	void EnemyGameObject::ApplySteering(const glm::vec3& position, const glm::vec3& new_velocity, float rotation) {
+		position_ = position;
+		velocity = new_velocity;
+		// Batched headings are in (-pi, pi], so wrapping them needs no fmod
+		angle_ = rotation < 0.0f ? rotation + 2.0f * glm::pi<float>() : rotation;
+		steering_done_ = true;
+	}
 
 } // namespace game
\ No newline at end of file
@@ -15,7 +15,21 @@ namespace game {
 
         // Update function for moving the enemy object around
         void Update(double delta_time) override;
-        void updatePlayerPos(glm::vec3 player_pos) { player_pos_ = player_pos; }
+
+        // Chase steering for one step of the intercepting state
+        void Steer(double delta_time);
+
+        // Take the result of a step steered in a batch outside the object,
+        // with rotation in (-pi, pi]. The next update then skips its own steering
+        void ApplySteering(const glm::vec3& position, const glm::vec3& new_velocity, float rotation);
+
+        void updatePlayerPos(glm::vec3 player_pos) { player_pos_ = player_pos; chase_target_ = player_pos; }
+
+        // Point to steer towards while intercepting; the player unless a path leads around obstacles
+        void SetChaseTarget(const glm::vec3& target) { chase_target_ = target; }
+
+        // Force added to the chase steering, such as from the rest of the flock
+        void SetSteeringForce(const glm::vec3& force) { steering_force_ = force; }
 
         int state_;
         float radius = 3.0f;
@@ -24,9 +38,13 @@ namespace game {
         float followTime = 2.0f;
         glm::vec3 velocity;
         glm::vec3 player_pos_;
+        glm::vec3 chase_target_;
+        glm::vec3 steering_force_;
+        int flock_index_ = -1;
         glm::vec3 start_pos_;
         double wander_cool_down_;
         bool isOrbititnObject = false;
+        bool steering_done_ = false;
 
         Timer update_timer_;
 
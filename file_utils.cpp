@@ -9,16 +9,18 @@ std::string LoadTextFile(const char *filename) {
 
     // Open file
     std::ifstream f;
-    f.open(filename);
+    f.open(filename, std::ios::in | std::ios::binary);
     if (f.fail()) {
         throw(std::ios_base::failure(std::string("Error opening file ") + std::string(filename)));
     }
 
-    // Read file into a string
-    std::string content;
-    std::string line;
-    while (std::getline(f, line)) {
-        content += line + "\n";
+    // Read the whole file into a string at once
+    f.seekg(0, std::ios::end);
+    std::streamoff size = f.tellg();
+    f.seekg(0, std::ios::beg);
+    std::string content(size > 0 ? (std::size_t) size : 0, '\0');
+    if (size > 0) {
+        f.read(&content[0], size);
     }
 
     // Close file
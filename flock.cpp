@@ -0,0 +1,126 @@
+#include <cmath>
+
+#include "flock.h"
+
+namespace game {
+
+// Angle between the directions members sitting on the same spot are
+// pushed in, so they fan out instead of all leaving the same way
+static const float golden_angle_g = 2.39996323f;
+
+// Cells searched around a member's own, starting with it
+static const int cell_offsets_g[9][2] = { {0, 0}, {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1} };
+
+
+Flock::Flock(void)
+    : grid_(NEIGHBOUR_RADIUS)
+{
+}
+
+
+void Flock::Clear(void)
+{
+    positions_.clear();
+    velocities_.clear();
+    grid_.Clear();
+}
+
+
+int Flock::Add(const glm::vec2 &position, const glm::vec2 &velocity)
+{
+    int member = (int) positions_.size();
+    positions_.push_back(position);
+    velocities_.push_back(velocity);
+    grid_.Insert(member, position);
+    return member;
+}
+
+
+void Flock::Build(void)
+{
+    grid_.Build();
+}
+
+
+glm::vec2 Flock::GetForce(int member) const
+{
+    glm::vec2 position = positions_[member];
+    glm::ivec2 coords = grid_.GetCoords(position);
+
+    // Nearest neighbours found so far, closest first
+    int neighbours[MAX_NEIGHBOURS];
+    float distances[MAX_NEIGHBOURS];
+    int num_neighbours = 0;
+    int candidates = 0;
+
+    // The grid cells are as large as the neighbour radius, so every
+    // neighbour is in the surrounding 3x3 cells. The member's own cell is
+    // searched first, since that is where the nearest ones usually are
+    for (int n = 0; n < 9 && candidates < MAX_CANDIDATES; n++) {
+        int cell = grid_.FindCell(coords.x + cell_offsets_g[n][0], coords.y + cell_offsets_g[n][1]);
+        if (cell < 0) {
+            continue;
+        }
+        const int *items = grid_.GetCellItems(cell);
+        int size = grid_.GetCellSize(cell);
+        for (int i = 0; i < size && candidates < MAX_CANDIDATES; i++) {
+            int other = items[i];
+            if (other == member) {
+                continue;
+            }
+            candidates++;
+
+            glm::vec2 offset = positions_[other] - position;
+            float distance_squared = glm::dot(offset, offset);
+            if (distance_squared > NEIGHBOUR_RADIUS * NEIGHBOUR_RADIUS) {
+                continue;
+            }
+            if (num_neighbours == MAX_NEIGHBOURS && distance_squared >= distances[MAX_NEIGHBOURS - 1]) {
+                continue;
+            }
+
+            // Insert in order, dropping the farthest when full
+            int slot = num_neighbours < MAX_NEIGHBOURS ? num_neighbours++ : MAX_NEIGHBOURS - 1;
+            while (slot > 0 && distances[slot - 1] > distance_squared) {
+                neighbours[slot] = neighbours[slot - 1];
+                distances[slot] = distances[slot - 1];
+                slot--;
+            }
+            neighbours[slot] = other;
+            distances[slot] = distance_squared;
+        }
+    }
+
+    if (num_neighbours == 0) {
+        return glm::vec2(0.0f);
+    }
+
+    glm::vec2 separation(0.0f);
+    glm::vec2 heading(0.0f);
+    glm::vec2 centre(0.0f);
+    for (int i = 0; i < num_neighbours; i++) {
+        glm::vec2 away = position - positions_[neighbours[i]];
+        float distance = std::sqrt(distances[i]);
+        if (distance < SEPARATION_DISTANCE) {
+            if (distance > 1e-4f) {
+                away /= distance;
+            }
+            else {
+                float angle = golden_angle_g * (float) member;
+                away = glm::vec2(cos(angle), sin(angle));
+            }
+            // Pushes harder the closer the neighbour is
+            separation += away * (1.0f - distance / SEPARATION_DISTANCE);
+        }
+        heading += velocities_[neighbours[i]];
+        centre += positions_[neighbours[i]];
+    }
+    heading /= (float) num_neighbours;
+    centre /= (float) num_neighbours;
+
+    return separation * SEPARATION_WEIGHT +
+           (heading - velocities_[member]) * ALIGNMENT_WEIGHT +
+           (centre - position) * COHESION_WEIGHT;
+}
+
+} // namespace game
@@ -0,0 +1,63 @@
+#ifndef FLOCK_H_
+#define FLOCK_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "spatial_grid.h"
+
+namespace game {
+
+    // Boids steering for a group of enemies
+    // Every tick the members' positions and velocities are added and
+    // bucketed in a grid. Each member is then steered by its nearest
+    // neighbours: away from those too close (separation), towards their
+    // heading (alignment) and towards their centre (cohesion). Only a
+    // fixed number of candidates is looked at per member, so the cost per
+    // member stays the same however tightly the flock is packed
+    class Flock {
+
+        public:
+            // Constructor
+            Flock(void);
+
+            // Remove all members
+            void Clear(void);
+
+            // Add a member and return its index
+            int Add(const glm::vec2 &position, const glm::vec2 &velocity);
+
+            // Bucket the members; call after the last Add()
+            void Build(void);
+
+            // Steering force on a member from its neighbours
+            glm::vec2 GetForce(int member) const;
+
+            // Number of members
+            int GetSize(void) const { return (int) positions_.size(); }
+
+            // Distance within which members are neighbours
+            static constexpr float NEIGHBOUR_RADIUS = 2.0f;
+
+            // Distance under which members push each other apart
+            static constexpr float SEPARATION_DISTANCE = 0.9f;
+
+            // Most neighbours steered by, and most candidates examined to find them
+            static const int MAX_NEIGHBOURS = 6;
+            static const int MAX_CANDIDATES = 32;
+
+            // Strength of each rule
+            static constexpr float SEPARATION_WEIGHT = 30.0f;
+            static constexpr float ALIGNMENT_WEIGHT = 0.5f;
+            static constexpr float COHESION_WEIGHT = 0.05f;
+
+        private:
+            std::vector<glm::vec2> positions_;
+            std::vector<glm::vec2> velocities_;
+            SpatialGrid grid_;
+
+    }; // class Flock
+
+} // namespace game
+
+#endif // FLOCK_H_
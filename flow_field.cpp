@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+
+#include "flow_field.h"
+
+namespace game {
+
+// Steps to the eight neighbours of a cell, straight ones first
+static const int step_x_g[8] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+static const int step_y_g[8] = { 0, 0, 1, -1, 1, 1, -1, -1 };
+static const float step_cost_g[8] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f };
+
+// Unit vectors of the steps
+static const float step_dir_x_g[8] = { 1.0f, -1.0f, 0.0f, 0.0f, 0.70710678f, -0.70710678f, 0.70710678f, -0.70710678f };
+static const float step_dir_y_g[8] = { 0.0f, 0.0f, 1.0f, -1.0f, 0.70710678f, 0.70710678f, -0.70710678f, -0.70710678f };
+
+// Cost of cells the search has not reached
+static const float unreached_g = 1e30f;
+
+const unsigned char FlowField::NO_DIRECTION;
+
+
+FlowField::FlowField(int size, float cell_size)
+{
+    size_ = size;
+    cell_size_ = cell_size;
+    budget_ = 4096;
+    current_ = 0;
+    ready_ = false;
+    building_ = false;
+    dirty_ = false;
+    builds_ = 0;
+
+    for (int i = 0; i < 2; i++) {
+        fields_[i].origin_x = fields_[i].origin_y = 0;
+        fields_[i].goal_x = fields_[i].goal_y = 0;
+        fields_[i].cost.assign(size * size, unreached_g);
+        fields_[i].direction.assign(size * size, NO_DIRECTION);
+        fields_[i].visible.assign(size * size, 0);
+        fields_[i].blocked.assign(size * size, 0);
+    }
+}
+
+
+int FlowField::CellOf(float coordinate) const
+{
+    return (int) std::floor(coordinate / cell_size_);
+}
+
+
+bool FlowField::GetIndex(const Field &field, const glm::vec3 &position, int &index) const
+{
+    int x = CellOf(position.x) - field.origin_x;
+    int y = CellOf(position.y) - field.origin_y;
+    if (x < 0 || y < 0 || x >= size_ || y >= size_) {
+        return false;
+    }
+    index = y * size_ + x;
+    return true;
+}
+
+
+void FlowField::SetBlocked(const glm::vec2 &position, bool blocked)
+{
+    std::pair<int, int> cell(CellOf(position.x), CellOf(position.y));
+    if (blocked) {
+        dirty_ |= obstacles_.insert(cell).second;
+    }
+    else {
+        dirty_ |= obstacles_.erase(cell) > 0;
+    }
+}
+
+
+void FlowField::SetBlocked(const glm::vec2 &low, const glm::vec2 &high, bool blocked)
+{
+    for (int y = CellOf(low.y); y <= CellOf(high.y); y++) {
+        for (int x = CellOf(low.x); x <= CellOf(high.x); x++) {
+            SetBlocked(glm::vec2((x + 0.5f) * cell_size_, (y + 0.5f) * cell_size_), blocked);
+        }
+    }
+}
+
+
+bool FlowField::IsBlocked(const glm::vec2 &position) const
+{
+    return obstacles_.count(std::make_pair(CellOf(position.x), CellOf(position.y))) > 0;
+}
+
+
+void FlowField::Update(const glm::vec2 &goal)
+{
+    // With nothing in the way every chaser heads straight for the goal
+    if (obstacles_.empty()) {
+        building_ = false;
+        return;
+    }
+
+    int goal_x = CellOf(goal.x);
+    int goal_y = CellOf(goal.y);
+
+    // A build in progress is finished even if the goal has moved on, so a
+    // goal that keeps changing cells cannot starve the field of updates
+    if (!building_) {
+        const Field &field = fields_[current_];
+        if (!ready_ || dirty_ || goal_x != field.goal_x || goal_y != field.goal_y) {
+            StartBuild(goal_x, goal_y);
+        }
+    }
+    if (building_) {
+        Expand(budget_);
+    }
+}
+
+
+void FlowField::StartBuild(int goal_x, int goal_y)
+{
+    const Field &old = fields_[current_];
+    Field &field = fields_[1 - current_];
+
+    // Keep the window where it is until the goal wanders towards its edge
+    field.origin_x = old.origin_x;
+    field.origin_y = old.origin_y;
+    int margin = size_ / 4;
+    if (!ready_ ||
+        goal_x - field.origin_x < margin || goal_x - field.origin_x >= size_ - margin ||
+        goal_y - field.origin_y < margin || goal_y - field.origin_y >= size_ - margin) {
+        field.origin_x = goal_x - size_ / 2;
+        field.origin_y = goal_y - size_ / 2;
+    }
+    field.goal_x = goal_x;
+    field.goal_y = goal_y;
+
+    // Copy in the obstacles that fall inside the window
+    std::fill(field.blocked.begin(), field.blocked.end(), 0);
+    for (std::set<std::pair<int, int> >::const_iterator it = obstacles_.begin(); it != obstacles_.end(); ++it) {
+        int x = it->first - field.origin_x;
+        int y = it->second - field.origin_y;
+        if (x >= 0 && y >= 0 && x < size_ && y < size_) {
+            field.blocked[y * size_ + x] = 1;
+        }
+    }
+    dirty_ = false;
+
+    std::fill(field.cost.begin(), field.cost.end(), unreached_g);
+    open_.clear();
+    int goal_index = (goal_y - field.origin_y) * size_ + (goal_x - field.origin_x);
+    field.cost[goal_index] = 0.0f;
+    open_.push_back(std::make_pair(0.0f, goal_index));
+    building_ = true;
+}
+
+
+void FlowField::Expand(int budget)
+{
+    Field &field = fields_[1 - current_];
+    std::greater<std::pair<float, int> > later;
+
+    // Dijkstra search outwards from the goal
+    while (budget > 0 && !open_.empty()) {
+        std::pop_heap(open_.begin(), open_.end(), later);
+        float cost = open_.back().first;
+        int index = open_.back().second;
+        open_.pop_back();
+
+        // Stale entry for a cell already reached more cheaply
+        if (cost > field.cost[index]) {
+            continue;
+        }
+        budget--;
+
+        int x = index % size_;
+        int y = index / size_;
+        for (int i = 0; i < 8; i++) {
+            int nx = x + step_x_g[i];
+            int ny = y + step_y_g[i];
+            if (nx < 0 || ny < 0 || nx >= size_ || ny >= size_) {
+                continue;
+            }
+            int neighbour = ny * size_ + nx;
+            if (field.blocked[neighbour]) {
+                continue;
+            }
+            // No cutting across the corner of a blocked cell
+            if (i >= 4 && (field.blocked[y * size_ + nx] || field.blocked[ny * size_ + x])) {
+                continue;
+            }
+            float next_cost = cost + step_cost_g[i];
+            if (next_cost < field.cost[neighbour]) {
+                field.cost[neighbour] = next_cost;
+                open_.push_back(std::make_pair(next_cost, neighbour));
+                std::push_heap(open_.begin(), open_.end(), later);
+            }
+        }
+    }
+
+    if (open_.empty()) {
+        Finish();
+    }
+}
+
+
+void FlowField::Finish(void)
+{
+    Field &field = fields_[1 - current_];
+
+    // Each cell steps to its cheapest neighbour
+    for (int y = 0; y < size_; y++) {
+        for (int x = 0; x < size_; x++) {
+            int index = y * size_ + x;
+            unsigned char best = NO_DIRECTION;
+            float best_cost = field.cost[index];
+            for (int i = 0; i < 8; i++) {
+                int nx = x + step_x_g[i];
+                int ny = y + step_y_g[i];
+                if (nx < 0 || ny < 0 || nx >= size_ || ny >= size_) {
+                    continue;
+                }
+                if (i >= 4 && (field.blocked[y * size_ + nx] || field.blocked[ny * size_ + x])) {
+                    continue;
+                }
+                float cost = field.cost[ny * size_ + nx];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best = (unsigned char) i;
+                }
+            }
+            field.direction[index] = best;
+        }
+    }
+
+    // Sight lines, in rings of growing distance from the goal. A cell sees
+    // the goal if it is open and the one or two cells the straight line
+    // to the goal passes through next also see it. This errs on the side
+    // of hiding cells that are barely in sight
+    std::fill(field.visible.begin(), field.visible.end(), 0);
+    int gx = field.goal_x - field.origin_x;
+    int gy = field.goal_y - field.origin_y;
+    field.visible[gy * size_ + gx] = 1;
+    for (int ring = 1; ring < size_; ring++) {
+        for (int y = std::max(0, gy - ring); y <= std::min(size_ - 1, gy + ring); y++) {
+            int dy = y - gy;
+            // Only the left and right ends of the inner rows are on the ring
+            int x_step = (std::abs(dy) == ring) ? 1 : 2 * ring;
+            for (int x = gx - ring; x <= gx + ring; x += x_step) {
+                if (x < 0 || x >= size_) {
+                    continue;
+                }
+                int dx = x - gx;
+                int index = y * size_ + x;
+                if (field.blocked[index]) {
+                    continue;
+                }
+                int sx = (dx > 0) - (dx < 0);
+                int sy = (dy > 0) - (dy < 0);
+                bool visible;
+                if (std::abs(dx) > std::abs(dy)) {
+                    visible = field.visible[y * size_ + (x - sx)] &&
+                              field.visible[(y - sy) * size_ + (x - sx)];
+                }
+                else if (std::abs(dy) > std::abs(dx)) {
+                    visible = field.visible[(y - sy) * size_ + x] &&
+                              field.visible[(y - sy) * size_ + (x - sx)];
+                }
+                else {
+                    visible = field.visible[(y - sy) * size_ + (x - sx)] &&
+                              field.visible[y * size_ + (x - sx)] &&
+                              field.visible[(y - sy) * size_ + x];
+                }
+                field.visible[index] = visible ? 1 : 0;
+            }
+        }
+    }
+
+    current_ = 1 - current_;
+    ready_ = true;
+    building_ = false;
+    builds_++;
+}
+
+
+glm::vec3 FlowField::GetChaseTarget(const glm::vec3 &position, const glm::vec3 &goal) const
+{
+    if (!ready_ || obstacles_.empty()) {
+        return goal;
+    }
+    const Field &field = fields_[current_];
+    int index;
+    if (!GetIndex(field, position, index) || field.visible[index] || field.direction[index] == NO_DIRECTION) {
+        return goal;
+    }
+
+    // A blocked cell was never reached, so it is priced by the open cell
+    // it steps out to
+    int step = field.direction[index];
+    float cost = field.cost[index];
+    if (field.blocked[index]) {
+        int x = index % size_ + step_x_g[step];
+        int y = index / size_ + step_y_g[step];
+        cost = field.cost[y * size_ + x] + step_cost_g[step];
+    }
+    float distance = cost * cell_size_;
+    return glm::vec3(position.x + step_dir_x_g[step] * distance, position.y + step_dir_y_g[step] * distance, goal.z);
+}
+
+} // namespace game
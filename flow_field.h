@@ -0,0 +1,105 @@
+#ifndef FLOW_FIELD_H_
+#define FLOW_FIELD_H_
+
+#include <set>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace game {
+
+    // Shared path towards one goal (the player) for every chasing enemy
+    // A square window of grid cells around the goal holds, for each cell,
+    // the length of the shortest path to the goal around blocked cells, the
+    // neighbour to step to next, and whether the goal is in plain sight.
+    // Enemies look up their cell in constant time instead of each searching
+    // for a path. When the goal moves to another cell the field is rebuilt
+    // a budgeted number of cells per tick, while the previous field keeps
+    // serving lookups until the new one is complete. With no obstacles at
+    // all nothing is built and chasers head straight for the goal
+    class FlowField {
+
+        public:
+            // Constructor; size is the number of cells on each side of the window
+            FlowField(int size, float cell_size);
+
+            // Block or unblock the cell containing a world position
+            void SetBlocked(const glm::vec2 &position, bool blocked);
+
+            // Block or unblock every cell overlapping the rectangle from low to high
+            void SetBlocked(const glm::vec2 &low, const glm::vec2 &high, bool blocked);
+            bool IsBlocked(const glm::vec2 &position) const;
+
+            // Most cells expanded by the path search in one tick
+            void SetBudget(int cells) { budget_ = cells; }
+
+            // Advance the field towards the current goal position
+            void Update(const glm::vec2 &goal);
+
+            // Point a chaser at position should steer towards to reach goal
+            // That is the goal itself when it is in sight or the field cannot
+            // help; otherwise a point along the path direction as far away as
+            // the path is long, so steering keeps the same strength
+            glm::vec3 GetChaseTarget(const glm::vec3 &position, const glm::vec3 &goal) const;
+
+            // True once a field has been completed
+            bool IsReady(void) const { return ready_; }
+
+            // Number of fields completed so far
+            int GetNumBuilds(void) const { return builds_; }
+
+            // Sentinel for cells with no next step
+            static const unsigned char NO_DIRECTION = 8;
+
+        private:
+            // A field for one goal over one window of cells
+            struct Field {
+                int origin_x, origin_y;           // world cell of the window's first cell
+                int goal_x, goal_y;               // world cell of the goal
+                std::vector<float> cost;          // path length to the goal, in cells
+                std::vector<unsigned char> direction; // neighbour to step to next
+                std::vector<unsigned char> visible;   // goal in a straight line without obstacles
+                std::vector<unsigned char> blocked;
+            };
+
+            // World cell containing a position
+            int CellOf(float coordinate) const;
+
+            // Index in the window of a world position; false if outside
+            bool GetIndex(const Field &field, const glm::vec3 &position, int &index) const;
+
+            // Begin building a field for a goal cell
+            void StartBuild(int goal_x, int goal_y);
+
+            // Expand up to budget cells of the path search
+            void Expand(int budget);
+
+            // Fill in the directions and sight lines, then publish the field
+            void Finish(void);
+
+            int size_;
+            float cell_size_;
+            int budget_;
+
+            // The published field and the one being built
+            Field fields_[2];
+            int current_;
+            bool ready_;
+            bool building_;
+
+            // Obstacles changed since the published field was started
+            bool dirty_;
+
+            // Blocked world cells
+            std::set<std::pair<int, int> > obstacles_;
+
+            // Open cells of the path search: (cost, index) min-heap
+            std::vector<std::pair<float, int> > open_;
+
+            int builds_;
+
+    }; // class FlowField
+
+} // namespace game
+
+#endif // FLOW_FIELD_H_
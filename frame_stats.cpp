@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cstdio>
+
+#include "frame_stats.h"
+
+namespace game {
+
+const int FrameHistogram::SUB_BUCKETS;
+const int FrameHistogram::NUM_BUCKETS;
+const int FrameStats::MAX_HITCHES;
+
+
+FrameHistogram::FrameHistogram(void)
+    : buckets_(NUM_BUCKETS, 0)
+{
+    count_ = 0;
+    total_ = 0;
+    max_ = 0;
+}
+
+
+int FrameHistogram::GetBucket(uint64_t value)
+{
+    if (value < SUB_BUCKETS) {
+        return (int) value;
+    }
+    // Shift the value down until it fits in the top half of the sub buckets
+    int shift = 0;
+    while ((value >> shift) >= SUB_BUCKETS) {
+        shift++;
+    }
+    int bucket = SUB_BUCKETS + (shift - 1) * (SUB_BUCKETS / 2) + (int) ((value >> shift) - SUB_BUCKETS / 2);
+    return std::min(bucket, NUM_BUCKETS - 1);
+}
+
+
+uint64_t FrameHistogram::GetBucketTop(int bucket)
+{
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    int shift = (bucket - SUB_BUCKETS) / (SUB_BUCKETS / 2) + 1;
+    uint64_t sub = (bucket - SUB_BUCKETS) % (SUB_BUCKETS / 2) + SUB_BUCKETS / 2;
+    return ((sub + 1) << shift) - 1;
+}
+
+
+void FrameHistogram::Record(uint64_t value)
+{
+    buckets_[GetBucket(value)]++;
+    count_++;
+    total_ += value;
+    max_ = std::max(max_, value);
+}
+
+
+void FrameHistogram::Reset(void)
+{
+    std::fill(buckets_.begin(), buckets_.end(), 0);
+    count_ = 0;
+    total_ = 0;
+    max_ = 0;
+}
+
+
+uint64_t FrameHistogram::GetPercentile(double percent) const
+{
+    if (count_ == 0) {
+        return 0;
+    }
+    // Rank of the value wanted, counting from 1
+    uint64_t rank = (uint64_t) (percent / 100.0 * count_ + 0.5);
+    rank = std::max<uint64_t>(1, std::min(rank, count_));
+
+    uint64_t seen = 0;
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            // The top bucket holds the largest value, which is known exactly
+            return std::min(GetBucketTop(i), max_);
+        }
+    }
+    return max_;
+}
+
+
+FrameStats::FrameStats(double budget)
+{
+    budget_ = budget;
+    num_hitches_ = 0;
+}
+
+
+static bool SlowerHitch(const Hitch &a, const Hitch &b)
+{
+    return a.seconds > b.seconds;
+}
+
+
+void FrameStats::AddFrame(double seconds)
+{
+    // Profile counters are collected every frame, so each hitch sees only its own frame
+    CollectProfile(profile_);
+    uint64_t frame = histogram_.GetCount();
+    histogram_.Record((uint64_t) (std::max(seconds, 0.0) * 1e6 + 0.5));
+    if (seconds <= budget_) {
+        return;
+    }
+    num_hitches_++;
+
+    // Keep the worst; a new hitch replaces the mildest one once the list is full
+    std::vector<Hitch>::iterator mildest = hitches_.end();
+    if ((int) hitches_.size() == MAX_HITCHES) {
+        mildest = std::min_element(hitches_.begin(), hitches_.end(),
+            [](const Hitch &a, const Hitch &b) { return a.seconds < b.seconds; });
+        if (mildest->seconds >= seconds) {
+            return;
+        }
+    }
+    Hitch hitch;
+    hitch.frame = frame;
+    hitch.seconds = seconds;
+    hitch.scopes = profile_;
+    std::sort(hitch.scopes.begin(), hitch.scopes.end(),
+        [](const ProfileSample &a, const ProfileSample &b) { return a.seconds > b.seconds; });
+    if (mildest == hitches_.end()) {
+        hitches_.push_back(hitch);
+    }
+    else {
+        *mildest = hitch;
+    }
+}
+
+
+std::vector<Hitch> FrameStats::GetWorstHitches(void) const
+{
+    std::vector<Hitch> worst = hitches_;
+    std::sort(worst.begin(), worst.end(), SlowerHitch);
+    return worst;
+}
+
+
+void FrameStats::PrintSummary(void) const
+{
+    printf("%llu frames, ms: mean %.2f  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f; %llu over %.1f ms budget\n",
+           (unsigned long long) GetNumFrames(), histogram_.GetMean() * 1e-3,
+           GetPercentile(50.0) * 1e3, GetPercentile(95.0) * 1e3, GetPercentile(99.0) * 1e3,
+           histogram_.GetMax() * 1e-3, (unsigned long long) num_hitches_, budget_ * 1e3);
+}
+
+
+bool FrameStats::WriteSummary(const std::string &path) const
+{
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "{\n");
+    fprintf(file, "  \"frames\": %llu,\n", (unsigned long long) GetNumFrames());
+    fprintf(file, "  \"budget_ms\": %.3f,\n", budget_ * 1e3);
+    fprintf(file, "  \"mean_ms\": %.3f,\n", histogram_.GetMean() * 1e-3);
+    fprintf(file, "  \"p50_ms\": %.3f,\n", GetPercentile(50.0) * 1e3);
+    fprintf(file, "  \"p95_ms\": %.3f,\n", GetPercentile(95.0) * 1e3);
+    fprintf(file, "  \"p99_ms\": %.3f,\n", GetPercentile(99.0) * 1e3);
+    fprintf(file, "  \"max_ms\": %.3f,\n", histogram_.GetMax() * 1e-3);
+    fprintf(file, "  \"hitches\": %llu,\n", (unsigned long long) num_hitches_);
+    fprintf(file, "  \"worst_hitches\": [\n");
+
+    std::vector<Hitch> worst = GetWorstHitches();
+    for (int i = 0; i < (int) worst.size(); i++) {
+        fprintf(file, "    {\"frame\": %llu, \"ms\": %.3f, \"scopes\": [", (unsigned long long) worst[i].frame, worst[i].seconds * 1e3);
+        for (int j = 0; j < (int) worst[i].scopes.size(); j++) {
+            const ProfileSample &scope = worst[i].scopes[j];
+            fprintf(file, "%s{\"name\": \"%s\", \"ms\": %.3f, \"calls\": %d}", j ? ", " : "", scope.name, scope.seconds * 1e3, scope.calls);
+        }
+        fprintf(file, "]}%s\n", i + 1 < (int) worst.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return true;
+}
+
+} // namespace game
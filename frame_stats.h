@@ -0,0 +1,109 @@
+#ifndef FRAME_STATS_H_
+#define FRAME_STATS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "profiler.h"
+
+namespace game {
+
+    // Counts of values in buckets whose width grows with the value
+    // Values up to 127 get a bucket each; above that every power of two is
+    // split into 64 buckets, so a value is known to within about 1.6%
+    // whatever its size. Recording is a few shifts and an increment, and
+    // the memory used is fixed, so it can stay on for a whole session
+    class FrameHistogram {
+
+        public:
+            // Constructor
+            FrameHistogram(void);
+
+            // Count a value; values past the largest bucket are counted in it
+            void Record(uint64_t value);
+
+            // Forget everything recorded
+            void Reset(void);
+
+            // Smallest value that at least the given percent of values are at or under
+            // Given as the top of its bucket, so it never understates
+            uint64_t GetPercentile(double percent) const;
+
+            uint64_t GetCount(void) const { return count_; }
+            uint64_t GetMax(void) const { return max_; }
+            double GetMean(void) const { return count_ ? (double) total_ / count_ : 0.0; }
+
+            static const int SUB_BUCKETS = 128;
+            static const int NUM_BUCKETS = SUB_BUCKETS + 24 * (SUB_BUCKETS / 2);
+
+        private:
+            std::vector<uint64_t> buckets_;
+            uint64_t count_;
+            uint64_t total_;
+            uint64_t max_;
+
+            static int GetBucket(uint64_t value);
+            static uint64_t GetBucketTop(int bucket);
+
+    }; // class FrameHistogram
+
+    // A frame that went over budget and what ran during it
+    struct Hitch {
+        uint64_t frame;
+        double seconds;
+        std::vector<ProfileSample> scopes;
+    };
+
+    // Collects frame times for a whole session
+    // Frame times go into a histogram in microseconds, for percentiles
+    // without keeping every frame. Frames over the budget are hitches: the
+    // worst of them are kept along with the profile scopes that ran during
+    // them, on any thread. At the end the summary can be written to a
+    // file, to compare tail latency between builds
+    class FrameStats {
+
+        public:
+            // Constructor; budget in seconds
+            FrameStats(double budget = 1.0 / 60.0);
+
+            void SetBudget(double seconds) { budget_ = seconds; }
+
+            // Record a frame that took the given time
+            // Collects the profile counters, so only one FrameStats should be in use at a time
+            void AddFrame(double seconds);
+
+            // Frame time at a percentile, in seconds
+            double GetPercentile(double percent) const { return histogram_.GetPercentile(percent) * 1e-6; }
+
+            uint64_t GetNumFrames(void) const { return histogram_.GetCount(); }
+            uint64_t GetNumHitches(void) const { return num_hitches_; }
+
+            // Worst hitches, slowest first
+            std::vector<Hitch> GetWorstHitches(void) const;
+
+            // Print the percentiles and hitch count on one line
+            void PrintSummary(void) const;
+
+            // Write the percentiles and worst hitches as JSON; returns false if the file cannot be written
+            bool WriteSummary(const std::string &path) const;
+
+            // Hitches kept in detail
+            static const int MAX_HITCHES = 32;
+
+        private:
+            FrameHistogram histogram_;
+            double budget_;
+            uint64_t num_hitches_;
+
+            // Worst hitches so far, in no particular order
+            std::vector<Hitch> hitches_;
+
+            // Profile of the frame being recorded
+            std::vector<ProfileSample> profile_;
+
+    }; // class FrameStats
+
+} // namespace game
+
+#endif // FRAME_STATS_H_
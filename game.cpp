@@ -2,26 +2,18 @@
 #include <string>
 #define GLM_FORCE_RADIANS
 #include <glm/gtc/matrix_transform.hpp> 
-#include <SOIL/SOIL.h>
 #include <iostream>
-#include <cstdlib>
-#include <ctime>
+#include <algorithm>
+#include <chrono>
 
 #include <path_config.h>
 #include "game.h"
 #include "sprite.h"
 #include "particles.h"
 #include "sparkle_particles.h"
-#include "tile.h"
+#include "tile_map.h"
+#include "memory_stats.h"
 #include "shader.h"
-#include "player_game_object.h"
-#include "collectible_game_object.h"
-#include "potion_collectible_game_object.h"
-#include "disc_collectible_game_object.h"
-#include "enemy_game_object.h"
-#include "timer.h"
-#include "projectile_shooting_enemy.h"
-#include "orbit_enemy.h"
 
 namespace game {
 
@@ -34,8 +26,22 @@ const unsigned int window_width_g = 800;
 const unsigned int window_height_g = 600;
 const glm::vec3 viewport_background_color_g(0.0, 0.0, 0.0);
 
-//Other global
-float pi_over_two = glm::pi<float>() / 2.0f;
+// Size of the world in tiles, and of a tile in world units
+const int world_tiles_g = 10000;
+const float tile_size_g = 10.0f;
+
+// Seed of the ground tile layout
+const unsigned int world_seed_g = 2501;
+
+// Length of a simulation tick in seconds
+// Frames are drawn between the last two ticks, so motion stays smooth at
+// any frame rate
+const double simulation_tick_g = 1.0 / 30.0;
+
+// Frames longer than this count as hitches: a 60 Hz frame, with room for
+// the jitter of waiting on the display
+const double frame_budget_g = 0.020;
+
 // Directory with game resources such as textures
 const std::string resources_directory_g = RESOURCES_DIRECTORY;
 
@@ -78,13 +84,12 @@ void Game::Init(void)
     // Set event callbacks
     glfwSetFramebufferSizeCallback(window_, ResizeCallback);
 
+    // Geometry and shaders are charged to loading
+    ALLOCATION_TAG(TAG_LOADING);
+
     // Initialize sprite geometry
     sprite_ = new Sprite();
-    tile_ = new Tile();
     sprite_->CreateGeometry();
-    tile_->CreateGeometry();
-    score = 0;
-    lastShotTime_ = -shotCooldown_;
 
     // Initialize particle geometry
     particles_ = new Particles();
@@ -94,40 +99,55 @@ void Game::Init(void)
     sparkle_particles_ = new SparkleParticles();
     sparkle_particles_->CreateGeometry();
 
+    // Find the packed assets, if they were built, and the programs linked last time
+    assets_.Init(resources_directory_g, ASSET_ARCHIVE_PATH);
+    shader_cache_.Init(SHADER_CACHE_DIRECTORY);
+    double shader_start = glfwGetTime();
+
     // Initialize sprite shader
-    sprite_shader_.Init((resources_directory_g+std::string("/sprite_vertex_shader.glsl")).c_str(), (resources_directory_g+std::string("/sprite_fragment_shader.glsl")).c_str());
+    InitShader(sprite_shader_, "sprite_vertex_shader.glsl", "sprite_fragment_shader.glsl");
 
     // Initialize HUD shader
-    hud_shader_.Init((resources_directory_g + std::string("/hud_vertex_shader.glsl")).c_str(), (resources_directory_g + std::string("/hud_fragment_shader.glsl")).c_str());
+    InitShader(hud_shader_, "hud_vertex_shader.glsl", "hud_fragment_shader.glsl");
 
     // Initialize heart shader
-    heart_shader_.Init((resources_directory_g + std::string("/heart_vertex_shader.glsl")).c_str(), (resources_directory_g + std::string("/heart_fragment_shader.glsl")).c_str());
+    InitShader(heart_shader_, "heart_vertex_shader.glsl", "heart_fragment_shader.glsl");
 
     // Initialize particle shader
-    particle_shader_.Init((resources_directory_g + std::string("/particle_vertex_shader.glsl")).c_str(), (resources_directory_g + std::string("/particle_fragment_shader.glsl")).c_str());
+    InitShader(particle_shader_, "particle_vertex_shader.glsl", "particle_fragment_shader.glsl");
 
     // Initialize sparkle particle shader
-    sparkle_particle_shader_.Init((resources_directory_g + std::string("/sparkle_particle_vertex_shader.glsl")).c_str(), (resources_directory_g + std::string("/sparkle_particle_fragment_shader.glsl")).c_str());
+    InitShader(sparkle_particle_shader_, "sparkle_particle_vertex_shader.glsl", "sparkle_particle_fragment_shader.glsl");
+    if (shader_cache_.IsEnabled()) {
+        std::cout << "Shader cache: " << shader_cache_.GetNumHits() << " hits, " << shader_cache_.GetNumMisses() << " misses, shaders ready in "
+                  << (glfwGetTime() - shader_start) * 1000.0 << " ms" << std::endl;
+    }
 
     // Initialize time
-    current_time_ = 0.0;
+    hud_time_ = 0.0;
+    frame_stats_.SetBudget(frame_budget_g);
+    quit_simulation_ = false;
 }
 
 
 Game::~Game()
 {
+    // Make sure the simulation thread is not left running
+    if (simulation_thread_.joinable()) {
+        quit_simulation_ = true;
+        simulation_thread_.join();
+    }
+
     // Free memory for all objects
     // Only need to delete objects that are not automatically freed
     delete sprite_;
     delete particles_;
-    for (int i = 0; i < game_objects_.size(); i++){
-        delete game_objects_[i];
-    }
-    for (int i = 0; i < bullets_.size(); i++) {
-        delete bullets_[i];
-    }
 
     delete hud_;
+    delete perf_overlay_;
+    delete gpu_timer_;
+    delete tile_map_;
+    delete scenario_runner_;
 
     // Close window
     glfwDestroyWindow(window_);
@@ -142,95 +162,41 @@ void Game::Setup(void)
     glfwGetWindowSize(window_, &width, &height);
 
     // Setup the game world
+    ALLOCATION_TAG(TAG_LOADING);
 
     // Load textures
     SetAllTextures();
 
-    // Setup the player object (position, texture, vertex count)
-    // Note that, in this specific implementation, the player object should always be the first object in the game object vector 
-    player_ = new PlayerGameObject(glm::vec3(0.0f, 0.0f, -1.0f), sprite_, &sprite_shader_, tex_[0]);
-    game_objects_.push_back(player_);
-    game_objects_[0]->SetRotation(pi_over_two);
-
-
-    // Setup enemy objects
-
-    // Setup collectible objects
-    
-    // Bones
-    collectibles_.push_back(new CollectibleGameObject(glm::vec3(2.0f, 2.0f, 0.0f), sprite_, &sprite_shader_, tex_[7]));
-    collectibles_[0]->SetScale(glm::vec2(0.5f, 0.5f));
-    collectibles_.push_back(new CollectibleGameObject(glm::vec3(-2.0f, -2.0f, 0.0f), sprite_, &sprite_shader_, tex_[7]));
-    collectibles_[1]->SetScale(glm::vec2(0.5f, 0.5f));
-    collectibles_.push_back(new CollectibleGameObject(glm::vec3(-2.0f, 3.0f, 0.0f), sprite_, &sprite_shader_, tex_[7]));
-    collectibles_[2]->SetScale(glm::vec2(0.5f, 0.5f));
-    collectibles_.push_back(new CollectibleGameObject(glm::vec3(4.0f, 1.0f, 0.0f), sprite_, &sprite_shader_, tex_[7]));
-    collectibles_[3]->SetScale(glm::vec2(0.5f, 0.5f));
-    collectibles_.push_back(new CollectibleGameObject(glm::vec3(-1.0f, -3.0f, 0.0f), sprite_, &sprite_shader_, tex_[7]));
-    collectibles_[4]->SetScale(glm::vec2(0.5f, 0.5f));
-    collectibles_.push_back(new CollectibleGameObject(glm::vec3(3.0f, -2.0f, 0.0f), sprite_, &sprite_shader_, tex_[7]));
-    collectibles_[5]->SetScale(glm::vec2(0.5f, 0.5f));
-
-    // Potions
-    potions_.push_back(new PotionCollectibleGameObject(glm::vec3(5.0f, 4.0f, 0.0f), sprite_, &sprite_shader_, tex_[17]));
-    potions_[0]->SetScale(glm::vec2(0.6f, 0.6f));
-    potions_.push_back(new PotionCollectibleGameObject(glm::vec3(-3.0f, 1.0f, 0.0f), sprite_, &sprite_shader_, tex_[17]));
-    potions_[1]->SetScale(glm::vec2(0.6f, 0.6f));
-    potions_.push_back(new PotionCollectibleGameObject(glm::vec3(-4.0f, -3.0f, 0.0f), sprite_, &sprite_shader_, tex_[17]));
-    potions_[2]->SetScale(glm::vec2(0.6f, 0.6f));
-
-    // Randomize positions for discs
-    srand(time(NULL));
-
-    // Discs
-    for (int i = 0; i < 3; ++i) {
-        float x = (rand() % 41) - 30.0f; // Random x value between -30 and 30
-        float y = (rand() % 41) - 30.0f; // Random y value between -30 and 30
-        float z = -1.0f; // Fixed z value
-
-        SpawnOrbitEnemy(glm::vec3(x, y, z));
-        discs_.push_back(new DiscCollectibleGameObject(glm::vec3(x, y, z), sprite_, &sprite_shader_, tex_[13 + i]));
-        discs_[i]->SetScale(glm::vec2(0.7f, 0.7f));
-
-        std::cout << "Disc " << i << " at: " << x << " " << y << std::endl;
-    }
-
-    // Disc particle effects
-    GameObject* disc_particles = new SparkleParticleSystem(glm::vec3(0.0f, 0.0f, 0.0f), sparkle_particles_, &sparkle_particle_shader_, tex_[8], discs_[0]);
-    disc_particles->SetScale(glm::vec2(0.1f, 0.1f));
-    disc_particles->SetRotation(-pi_over_two);
-    disc_particles->SetCollidable(false);
-    discs_[0]->sparkles_ = disc_particles; // Add pointer to the particle system to the disc object
-
-    disc_particles = new SparkleParticleSystem(glm::vec3(0.0f, 0.0f, 0.0f), sparkle_particles_, &sparkle_particle_shader_, tex_[8], discs_[1]);
-    disc_particles->SetScale(glm::vec2(0.1f, 0.1f));
-    disc_particles->SetRotation(-pi_over_two);
-    disc_particles->SetCollidable(false);
-    discs_[1]->sparkles_ = disc_particles; // Add pointer to the particle system to the disc object
-
-    disc_particles = new SparkleParticleSystem(glm::vec3(0.0f, 0.0f, 0.0f), sparkle_particles_, &sparkle_particle_shader_, tex_[8], discs_[2]);
-    disc_particles->SetScale(glm::vec2(0.1f, 0.1f));
-    disc_particles->SetRotation(-pi_over_two);
-    disc_particles->SetCollidable(false);
-    discs_[2]->sparkles_ = disc_particles; // Add pointer to the particle system to the disc object
-
-    // Setup background
-    GameObject *background = new GameObject(glm::vec3(0.0f, 0.0f, 0.0f), tile_, &sprite_shader_, tex_[4]);
-    background->SetScale(glm::vec2(90.0f, 90.0f));
-    background_objects_.push_back(background);
+    // Hand the graphics resources over to the simulation and build the world
+    SimulationResources resources;
+    resources.sprite = sprite_;
+    resources.particles = particles_;
+    resources.sparkle_particles = sparkle_particles_;
+    resources.sprite_shader = &sprite_shader_;
+    resources.particle_shader = &particle_shader_;
+    resources.sparkle_particle_shader = &sparkle_particle_shader_;
+    resources.tex = tex_;
+    simulation_.Setup(resources);
+
+    // Build the ground tiles
+    tile_map_ = new TileMap(world_tiles_g, world_tiles_g, tile_size_g, world_seed_g);
+    tile_map_->Init(assets_, "textures/grass03.png", &sprite_shader_);
 
     // Initialize the HUD
-    hud_ = new HUD(resources_directory_g + "/textures/hud/", &hud_shader_, glm::ortho(0.0f, (float)width, (float)height, 0.0f), &heart_shader_);
-
-    // Setup particle system
-    GameObject* particles = new ParticleSystem(glm::vec3(0.0f, 0.0f, 0.0f), particles_, &particle_shader_, tex_[10], game_objects_[0]);
-    particles->SetScale(glm::vec2(0.4f, 0.4f));
-    particles->SetRotation(-pi_over_two);
-    particles->SetCollidable(false);
-    grass_particle_system_ = dynamic_cast<ParticleSystem*>(particles);
-
-    // Nullify explosion
-    explosion_ = NULL;
+    HudTextures hud_textures = LoadHudTextures(assets_, "textures/hud/");
+    hud_ = new HUD(hud_textures, sprite_, &hud_shader_, glm::ortho(0.0f, (float)width, (float)height, 0.0f), &heart_shader_);
+
+    // The performance overlay uses the HUD's digits, and a sprite for each list of objects
+    GLuint list_icons[NUM_OBJECT_LISTS] = { tex_[3], tex_[9], tex_[7], tex_[17], tex_[13], tex_[16], tex_[6] };
+    perf_overlay_ = new PerfOverlay(MakePerfOverlayTextures(hud_textures.numbers, list_icons), sprite_, &hud_shader_, frame_budget_g);
+    hud_->SetOverlay(perf_overlay_);
+    hud_->SetFrameArena(&frame_arena_);
+    gpu_timer_ = new GpuTimer();
+    std::cout << "Assets: " << assets_.GetNumArchiveLoads() << " loaded from the archive, " << assets_.GetNumFileLoads() << " from files, "
+              << assets_.GetTextureBytes() / 1024 << " KB of textures" << std::endl;
+
+    // No input until the window thread reads the controls
+    input_ = InputState();
 }
 
 
@@ -247,14 +213,11 @@ void Game::SetTexture(GLuint w, const char *fname)
     // Bind texture buffer
     glBindTexture(GL_TEXTURE_2D, w);
 
-    // Load texture from a file to the buffer
-    int width, height;
-    unsigned char* image = SOIL_load_image(fname, &width, &height, 0, SOIL_LOAD_RGBA);
-    if (!image){
+    // Load texture and its mipmaps from the archive or a file to the buffer
+    // This also sets the filtering
+    if (!assets_.UploadTexture(fname)){
         std::cout << "Cannot load texture " << fname << std::endl;
     }
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-    SOIL_free_image_data(image);
 
     // Texture Wrapping
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -262,10 +225,15 @@ void Game::SetTexture(GLuint w, const char *fname)
     
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    
-    // Texture Filtering
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+
+void Game::InitShader(Shader &shader, const char *vertex_name, const char *fragment_name)
+{
+    std::string vertex_storage, fragment_storage;
+    const char *vertex_source = assets_.LoadText(vertex_name, vertex_storage);
+    const char *fragment_source = assets_.LoadText(fragment_name, fragment_storage);
+    shader.InitFromSource(vertex_source, fragment_source, &shader_cache_, vertex_name);
 }
 
 
@@ -284,7 +252,7 @@ void Game::SetAllTextures(void)
     glGenTextures(num_textures, tex_);
     // Load each texture
     for (int i = 0; i < num_textures; i++){
-        SetTexture(tex_[i], (resources_directory_g+std::string(texture[i])).c_str());
+        SetTexture(tex_[i], texture[i]);
     }
     // Set first texture in the array as default
     glBindTexture(GL_TEXTURE_2D, tex_[0]);
@@ -293,524 +261,237 @@ void Game::SetAllTextures(void)
 
 void Game::MainLoop(void)
 {
+    // Publish the starting state so there is always a snapshot to draw
+    simulation_.BuildSnapshot(snapshots_.GetWriteBuffer());
+    snapshots_.GetWriteBuffer().publish_time = glfwGetTime();
+    snapshots_.Publish();
+    snapshots_.Acquire();
+    hud_time_ = snapshots_.GetReadBuffer().time;
+
+    // From here on the simulation thread owns the game world
+    quit_simulation_ = false;
+    simulation_thread_ = std::thread(&Game::SimulationLoop, this);
+
     // Loop while the user did not close the window
-    double last_time = glfwGetTime();
+    double last_frame = glfwGetTime();
+    uint64_t last_allocations = GetAllocationCount();
     while (!glfwWindowShouldClose(window_)){
 
-        // Calculate delta time
-        double current_time = glfwGetTime();
-        double delta_time = current_time - last_time;
-        last_time = current_time;
-
         // Update window events like input handling
         glfwPollEvents();
 
         // Handle user input
-        HandleControls(delta_time);
+        HandleControls();
 
-        // Update all the game objects
-        Update(delta_time);
+        // Pick up the newest snapshot; keep drawing the last one if the
+        // simulation has not finished a tick since
+        snapshots_.Acquire();
+        const RenderSnapshot &snapshot = snapshots_.GetReadBuffer();
 
         // Update the HUD with new information
-        hud_->Update(score, player_->hp_, player_->objectsCollected_, player_->isInvincible_, player_->invincibilityTimer_.TimeLeft(), glm::vec2(player_->GetPosition().x, player_->GetPosition().y), player_->goalObjectsCollected_, delta_time);
-
-
-        // Render all the game objects
-        Render();
-
-        // Push buffer drawn in the background onto the display
-        glfwSwapBuffers(window_);
-    }
-}
-
-
-void Game::HandleControls(double delta_time)
-{
-    // Get player game object
-    GameObject *player = game_objects_[0];
-    // Get current position and angle
-    glm::vec3 curpos = player->GetPosition();
-    float angle = player->GetRotation();
-    // Compute current bearing direction
-    glm::vec3 dir = player->GetBearing();
-    // Adjust motion increment and angle increment 
-    // if translation or rotation is too slow
-    float speed = delta_time*1500.0;
-    float motion_increment = 0.001*speed;
-    float angle_increment = (glm::pi<float>() / 1200.0f)*speed;
-    // Get window dimensions
-    int width, height;
-    glfwGetWindowSize(window_, &width, &height);
-
-    // Check for escape key press
-    if (glfwGetKey(window_, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-        glfwSetWindowShouldClose(window_, true);
-    }
-
-    //Reset Player velocity to 0 between keystrokes
-    dynamic_cast<PlayerGameObject*>(player)->SetVelocity(glm::vec3(0.0f, 0.0f, 0.0f));
-    //Reset Player speed to base speed
-    dynamic_cast<PlayerGameObject*>(player)->SetSpeed(1.0f);
-
-    // Check for player movement input and make changes accordingly
-    if (glfwGetKey(window_, GLFW_KEY_W) == GLFW_PRESS) {
-        dynamic_cast<PlayerGameObject*>(player)->Drive(1);
-    }
-    if (glfwGetKey(window_, GLFW_KEY_S) == GLFW_PRESS) {
-        dynamic_cast<PlayerGameObject*>(player)->Drive(-1);
-    }
-    if (glfwGetKey(window_, GLFW_KEY_D) == GLFW_PRESS) {
-        player->SetRotation(angle - angle_increment);
-    }
-    if (glfwGetKey(window_, GLFW_KEY_A) == GLFW_PRESS) {
-        player->SetRotation(angle + angle_increment);
-    }
-    if (glfwGetKey(window_, GLFW_KEY_Z) == GLFW_PRESS) {
-        dynamic_cast<PlayerGameObject*>(player)->Strafe(-1);
-    }
-    if (glfwGetKey(window_, GLFW_KEY_C) == GLFW_PRESS) {
-        dynamic_cast<PlayerGameObject*>(player)->Strafe(1);
-    }
-    if (glfwGetKey(window_, GLFW_KEY_SPACE) == GLFW_PRESS) {
-		// Speed boost the player
-        dynamic_cast<PlayerGameObject*>(player)->SetSpeed(2.0f);
-	}
-    if (glfwGetMouseButton(window_, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS) {
-        double xpos, ypos;
-        //getting cursor position
-        glfwGetCursorPos(window_, &xpos, &ypos);
-        glm::vec3 direction = glm::vec3(xpos - width/2, ypos - height/2, 0.0f);
-        float bulletAngle = atan2((-1)*direction.y, direction.x);
-        direction = CalculateDirectionVector(bulletAngle);
-        SpawnBullet(player->GetPosition(), direction, tex_[9], 7.0f, true);
-    }
-    if (glfwGetMouseButton(window_, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS) {
-
-        double currentTime = glfwGetTime();
-        //if can shoot
-        if (currentTime - lastBombTime_ >= bombCooldown_) {
-            DropBombAtLocation(player->GetPosition());
-            lastBombTime_ = currentTime;
+        {
+            PROFILE_SCOPE("hud update");
+            const HudState &hud = snapshot.hud;
+            hud_->Update(hud.score, hud.health, hud.collectibles, hud.invincible, hud.invincibility_time_left, hud.coordinates, hud.discs, snapshot.time - hud_time_);
+            hud_time_ = snapshot.time;
         }
 
-    }
-}
-
-
-void Game::Update(double delta_time)
-{
-    // Get player game object
-    PlayerGameObject* player = dynamic_cast<PlayerGameObject*>(game_objects_[0]);
-    //std::cout << "Player position: " << player->GetPosition().x << " " << player->GetPosition().y << std::endl;
-
-
-    // Animate player
-    if (player->animationTimer_.Finished()) {
-        player->animationTimer_.Start(player->animationSpeed_);
-
-        // Check if player is moving
-        if (player->animationSpeed_ != 0.0f) {
-            // Change player texture
-            if (player->currentFrame_ == 0) {
-                game_objects_[0]->SetTexture(tex_[1]);
-                player->currentFrame_ = 1;
-            }
-            else {
-                game_objects_[0]->SetTexture(tex_[0]);
-                player->currentFrame_ = 0;
-            }
+        // Render all the game objects; the GPU is only timed while the overlay shows it
+        bool time_gpu = perf_overlay_->IsVisible();
+        if (time_gpu) {
+            gpu_timer_->Begin();
         }
-        else {
-			// Set player texture to still
-			game_objects_[0]->SetTexture(tex_[2]);
+        Render(snapshot);
+        if (time_gpu) {
+            gpu_timer_->End();
         }
-	}
 
-    // Update time
-    current_time_ += delta_time;
-    if (!enemy_timer_.Running()) {
-        enemy_timer_.Start(2.0f);
-    }
-
-    if (enemy_timer_.Finished()) {
-        // Generate random coordinates to spawn a new enemy
-        int rand_x = rand() % 25 - 2;
-        int rand_y = rand() % 25 - 2;
+        // Push buffer drawn in the background onto the display
+        {
+            PROFILE_SCOPE("swap buffers");
+            glfwSwapBuffers(window_);
+        }
 
-        // Spawn new enemy
-        std::cout << "New enemy at: " << rand_x << " " << rand_y << std::endl;
-        if (alternateEnemy) {
-		    game_objects_.push_back(new EnemyGameObject(glm::vec3(rand_x, rand_y, 0.0f), sprite_, &sprite_shader_, tex_[3]));
-            game_objects_.back()->SetRotation(pi_over_two);
+        // Time from the end of one frame to the end of the next, waiting on the display included
+        double now = glfwGetTime();
+        frame_stats_.AddFrame(now - last_frame);
+
+        // Figures for the overlay, gathered whether or not it is showing
+        PerfFrame perf;
+        perf.seconds = now - last_frame;
+        perf.gpu_seconds = time_gpu ? gpu_timer_->GetSeconds() : 0.0;
+        perf.draws = snapshot.commands.GetNumDraws() + ground_commands_.GetNumDraws() + hud_->GetCommands().GetNumDraws();
+        perf.state_changes = 0;
+        const RenderCommandBuffer *buffers[] = { &snapshot.commands, &ground_commands_, &hud_->GetCommands() };
+        for (int i = 0; i < 3; i++) {
+            perf.state_changes += buffers[i]->GetNumPipelineChanges() + buffers[i]->GetNumTextureBinds();
         }
-        else {
-            game_objects_.push_back(new ProjectileShootingEnemy(this, glm::vec3(rand_x, rand_y, 0.0f), sprite_, &sprite_shader_, tex_[12]));
+        uint64_t allocations = GetAllocationCount();
+        perf.allocations = allocations - last_allocations;
+        for (int i = 0; i < NUM_OBJECT_LISTS; i++) {
+            perf.list_sizes[i] = snapshot.list_sizes[i];
         }
+        perf_overlay_->AddFrame(perf);
+        last_frame = now;
+        last_allocations = allocations;
 
-        //alternates between what type of enemy spawns
-        alternateEnemy = !alternateEnemy;
-	}
+        // Nothing from this frame's scratch memory is used past here
+        frame_arena_.Reset();
 
-    if (!collectible_timer_.Running()) {
-        collectible_timer_.Start(15.0f);
+        // Close the window when the game ends or the simulation stopped
+        if (simulation_.IsGameOver() || quit_simulation_) {
+            glfwSetWindowShouldClose(window_, true);
+        }
     }
 
-    if (collectible_timer_.Finished()) {
-        // Generate random coordinates to spawn a new bone collectible
-        int rand_x = rand() % 35 - 2;
-        int rand_y = rand() % 35 - 2;
-
-        // Spawn new collectible
-        //std::cout << "New bone at: " << rand_x << " " << rand_y << std::endl;
-        collectibles_.push_back(new CollectibleGameObject(glm::vec3(rand_x, rand_y, 0.0f), sprite_, &sprite_shader_, tex_[7]));
-        collectibles_.back()->SetScale(glm::vec2(0.5f, 0.5f));
+    // Stop the simulation thread before anything it uses goes away
+    quit_simulation_ = true;
+    simulation_thread_.join();
 
-        // Generate random coordinates to spawn a new potion collectible
-        rand_x = rand() % 35 - 2;
-        rand_y = rand() % 35 - 2;
-
-        // Spawn new collectible
-        //std::cout << "New potion at: " << rand_x << " " << rand_y << std::endl;
-        potions_.push_back(new PotionCollectibleGameObject(glm::vec3(rand_x, rand_y, 0.0f), sprite_, &sprite_shader_, tex_[17]));
-        potions_.back()->SetScale(glm::vec2(0.6f, 0.6f));
+    // Tail latency of the session, for comparing builds
+    frame_stats_.PrintSummary();
+    std::cout << "Scratch memory high water: frame " << frame_arena_.GetHighWater() << " bytes, tick "
+              << simulation_.GetFrameArenas().GetHighWater() << " bytes per thread" << std::endl;
+    if (!frame_stats_.WriteSummary("frame_stats.json")) {
+        std::cerr << "Could not write frame_stats.json" << std::endl;
     }
-
-    // Check for expired bullets
-    for (int i = 0; i < bullets_.size(); i++) {
-        BulletGameObject* current_game_object = bullets_[i];
-        // Update the current game object
-        current_game_object->Update(delta_time);
-
-        if (current_game_object->IsMarkedForDeletion()) {
-            // Find the object in the bullets vector
-            auto it = std::find(bullets_.begin(), bullets_.end(), current_game_object);
-
-            // If found, remove it
-            if (it != bullets_.end()) {
-                delete* it; // Free memory if objects are dynamically allocated
-                bullets_.erase(it);
-            }
-        }
+    if (simulation_error_) {
+        std::rethrow_exception(simulation_error_);
     }
+}
 
-    // Check for expired bone collectibles
-    for (int i = 0; i < collectibles_.size(); i++) {
-        CollectibleGameObject* current_game_object = collectibles_[i];
-        // Update the current game object
-        current_game_object->Update(delta_time);
-
-        if (current_game_object->IsMarkedForDeletion()) {
-            // Find the object in the bullets vector
-            auto it = std::find(collectibles_.begin(), collectibles_.end(), current_game_object);
 
-            // If found, remove it
-            if (it != collectibles_.end()) {
-                delete* it; // Free memory if objects are dynamically allocated
-                collectibles_.erase(it);
-            }
-        }
+void Game::LoadScenario(const std::string &path)
+{
+    Scenario scenario;
+    std::string error;
+    if (!game::LoadScenario(path, scenario, error)) {
+        throw(std::runtime_error(error));
     }
+    delete scenario_runner_;
+    scenario_runner_ = new ScenarioRunner(scenario);
+}
 
-    // Check for expired potion collectibles
-    for (int i = 0; i < potions_.size(); i++) {
-		PotionCollectibleGameObject* current_game_object = potions_[i];
-		// Update the current game object
-		current_game_object->Update(delta_time);
-
-		if (current_game_object->IsMarkedForDeletion()) {
-			// Find the object in the potions vector
-			auto it = std::find(potions_.begin(), potions_.end(), current_game_object);
-
-			// If found, remove it
-			if (it != potions_.end()) {
-				delete* it; // Free memory if objects are dynamically allocated
-				potions_.erase(it);
-			}
-		}
-	}
-
-    // Check for expired disc collectibles
-    for (int i = 0; i < discs_.size(); i++) {
-		DiscCollectibleGameObject* current_game_object = discs_[i];
-		// Update the current game object
-		current_game_object->Update(delta_time);
-
-		if (current_game_object->IsMarkedForDeletion()) {
-			// Find the object in the discs vector
-			auto it = std::find(discs_.begin(), discs_.end(), current_game_object);
-
-			// If found, remove it
-			if (it != discs_.end()) {
-                delete discs_[i]->sparkles_; // Delete the associated particle system
-				delete* it; // Free memory if objects are dynamically allocated
-				discs_.erase(it);
-			}
-		}
-	}
-
-    // Update all game objects
-
-    for (BombGameObject* bomb : bombs_) {
-        bomb->Update(delta_time);
-    }
-    HandleBombExplosions();
-
-    for (int i = 0; i < game_objects_.size(); i++) {
-        // Get the current game object
-        GameObject* current_game_object = game_objects_[i];
-
-        // Update the current game object
-        current_game_object->Update(delta_time);
-        
-        //Check for any finished explosions
-        if (explosions_.size() > 0) {
-            //std::cout << "Explosion status: "<< explosions_[0]->timer_.Finished() << std::endl;
-            if (explosions_[0]->explosion_timer_.Finished()) {
-				explosions_.erase(explosions_.begin());
-                std::cout << "Explosion finished!" << std::endl;
-				continue;
-			}
-		}
-
-        // Check for collision with other game objects
-        // Note the loop bounds: we avoid testing the last object since
-        // it's the background covering the whole game world
-
-
-
-        for (int j = i + 1; j < (game_objects_.size()); j++) {
-            GameObject* other_game_object = game_objects_[j];
-
-            // Compute distance between object i and object j
-            glm::vec3 curr_pos = current_game_object->GetPosition();
-            curr_pos.z = 0.0f;
-            glm::vec3 other_pos = other_game_object->GetPosition();
-            other_pos.z = 0.0f;
-            float distance = glm::length(curr_pos - other_pos);
-
-            PlayerGameObject* player = dynamic_cast<PlayerGameObject*>(current_game_object);
-            EnemyGameObject* enemy = dynamic_cast<EnemyGameObject*>(other_game_object);
-            OrbitEnemy* orbitEnemy = dynamic_cast<OrbitEnemy*>(other_game_object);
-
-
-            if (player && enemy) {
-                enemy->updatePlayerPos(player->GetPosition());
-                if (distance < 2.0f && !orbitEnemy) {
-                    enemy->state_ = INTERCEPTING_;
-                }
+
+void Game::SimulationLoop(void)
+{
+    try {
+        double next_tick = glfwGetTime();
+        while (!quit_simulation_) {
+
+            // Take the latest input from the window thread
+            InputState input;
+            {
+                std::lock_guard<std::mutex> lock(input_mutex_);
+                input = input_;
+                // Button presses are latched until a tick has seen them
+                input_.fire = false;
+                input_.drop_bomb = false;
+                input_.next_broadphase = false;
             }
 
-            // If distance is below a threshold, we have a collision
-            if (distance < 0.6f) {
-                // Check if collision is with a collidable object
-                if (!(current_game_object->IsCollidable() && other_game_object->IsCollidable())) {
+            // A load test places its objects between ticks and stops the game when done
+            if (scenario_runner_) {
+                scenario_runner_->Update(simulation_, simulation_tick_g);
+                if (scenario_runner_->IsFinished()) {
+                    scenario_runner_->PrintCurve();
+                    scenario_runner_->WriteCurve(scenario_runner_->GetName() + ".csv");
+                    quit_simulation_ = true;
                     break;
                 }
-
-                //Check for exceptions where collisions should be ignored
-                EnemyGameObject* curr_enemy = dynamic_cast<EnemyGameObject*>(current_game_object);
-                EnemyGameObject* other_enemy = dynamic_cast<EnemyGameObject*>(other_game_object);
-                if (curr_enemy && other_enemy) {
-                    //std::cout<< "Both Enemy Collision" << std::endl;
-                    continue;
-				}
-
-                CollectibleGameObject* curr_collectible = dynamic_cast<CollectibleGameObject*>(current_game_object);
-                if (curr_collectible && other_enemy) {
-					//std::cout<< "Collectible Collision" << std::endl;
-					continue;
-                }
-
-                // Make player take damage
-                if (player && !player->isInvincible_) {
-                    player->takeDamage();
-                    std::cout << "Player took damage! " << std::endl << "Current HP: " << player->hp_ << std::endl;
-
-                    player->isInvincible_ = true;
-                    player->invincibilityTimer_.Start(1.5f);
-
-                    if (player->hp_ <= 0) {
-                        //Add explosion
-                        explosions_.push_back(new ExplosionGameObject(player->GetPosition(), sprite_, &sprite_shader_, tex_[6]));
-                        std::cout << "Player has died!" << std::endl;
-                        glfwSetWindowShouldClose(window_, true);
-                        continue;
-                    }
-                }
-
-                // This is where you would perform collision response between objects
-                if (other_enemy) {
-                    score += 100;
-                    std::cout<< "Explosion Started" << std::endl;
-                    explosions_.push_back(new ExplosionGameObject(other_game_object->GetPosition(), sprite_, &sprite_shader_, tex_[6]));
-                    enemy->isOrbititnObject = false;
-                    game_objects_.erase(game_objects_.begin() + j);
-				}
-
-                if (player) {
-                    std::cout<< "Player current HP: " << player->hp_ << std::endl;
-                }
-
             }
-        }
-
-        bool breakloop = false;
-        // Check for collision with bullets
-        for (int j = 0; j < (bullets_.size()); j++) {
-            BulletGameObject* bullet = bullets_[j];
-            glm::vec3 curr_pos = current_game_object->GetPosition();
-            curr_pos.z = 0.0f;
-            glm::vec3 other_pos = bullet->GetPosition();
-            other_pos.z = 0.0f;
-
-            float distance = glm::length(curr_pos - other_pos);
-
-            EnemyGameObject* enemy = dynamic_cast<EnemyGameObject*>(current_game_object);
-            PlayerGameObject* player = dynamic_cast<PlayerGameObject*>(current_game_object);
-
-            //if its friendly bullet collididng with enemy
-            if (enemy && bullet->isFriendly) {
-                // If distance is below a threshold, we have a collision
-                if (distance < 0.6f) {
-                    // Check if collision is with a collidable object
-                    if (!(enemy->IsCollidable())) {
-                        break;
-                    }
-                    score += 100;
-                    std::cout << "Explosion Started" << std::endl;
-                    explosions_.push_back(new ExplosionGameObject(enemy->GetPosition(), sprite_, &sprite_shader_, tex_[6]));
-                    enemy->isOrbititnObject = false;
-                    game_objects_.erase(game_objects_.begin() + i);
+            double tick_start = glfwGetTime();
 
+            // Advance the game world by one fixed tick
+            simulation_.Step(simulation_tick_g, input);
 
-                }
-            //if its enemy bullet colliding with player
-            }else if (player && !bullet->isFriendly && !player->isInvincible_) {
-                // If distance is below a threshold, we have a collision
-                if (distance < 0.6f) {
-                    
-                    player->takeDamage();
-                    std::cout << "Player took damage! " << std::endl << "Current HP: " << player->hp_ << std::endl;
-
-                    player->isInvincible_ = true;
-                    player->invincibilityTimer_.Start(1.5f);
-
-
-                    if (player->hp_ <= 0) {
-                        //Add explosion
-                        explosions_.push_back(new ExplosionGameObject(player->GetPosition(), sprite_, &sprite_shader_, tex_[6]));
-                        std::cout << "Player has died!" << std::endl;
-                        glfwSetWindowShouldClose(window_, true);
-                        continue;
-                    }
-
-                }
+            // Hand the result over to the window thread
+            simulation_.BuildSnapshot(snapshots_.GetWriteBuffer());
+            snapshots_.GetWriteBuffer().publish_time = glfwGetTime();
+            snapshots_.Publish();
+            if (scenario_runner_) {
+                scenario_runner_->ReportTick(glfwGetTime() - tick_start);
             }
 
+            // Wait for the next tick. After a long stall, carry on from now
+            // instead of running a burst of ticks to catch up
+            next_tick += simulation_tick_g;
+            double now = glfwGetTime();
+            if (now > next_tick + 0.25) {
+                next_tick = now;
+            }
+            else if (next_tick > now) {
+                std::this_thread::sleep_for(std::chrono::duration<double>(next_tick - now));
+            }
         }
+    }
+    catch (...) {
+        // Pass the error on to the window thread, which closes the window
+        simulation_error_ = std::current_exception();
+        quit_simulation_ = true;
+    }
+}
 
 
-        // Check for collision with bone collectibles
-        for (int j = 0; j < collectibles_.size(); j++) {
-            CollectibleGameObject* collectible = collectibles_[j];
-            glm::vec3 curr_pos = current_game_object->GetPosition();
-            curr_pos.z = 0.0f;
-            glm::vec3 other_pos = collectible->GetPosition();
-            other_pos.z = 0.0f;
-            
-			float distance = glm::length(curr_pos - other_pos);
-
-			PlayerGameObject* player = dynamic_cast<PlayerGameObject*>(current_game_object);
-
-            if (player) {
-				// If distance is below a threshold, we have a collision
-                if (distance < 0.6f) {
-					// Check if collision is with a collidable object
-                    if (!(collectible->IsCollidable())) {
-						break;
-					}
-                    std::cout << "Collectible collected!" << std::endl;
-                    collectible->MarkForDeletion();
-                    collectible->SetCollidable(false);
-                    player->objectsCollected_++;
-				}
-			}   
-        }
+void Game::HandleControls(void)
+{
+    // Get window dimensions
+    int width, height;
+    glfwGetWindowSize(window_, &width, &height);
 
-        // Check for collision with potion collectibles
-        for (int j = 0; j < potions_.size(); j++) {
-			PotionCollectibleGameObject* potion = potions_[j];
-			glm::vec3 curr_pos = current_game_object->GetPosition();
-			curr_pos.z = 0.0f;
-			glm::vec3 other_pos = potion->GetPosition();
-			other_pos.z = 0.0f;
-
-			float distance = glm::length(curr_pos - other_pos);
-
-			PlayerGameObject* player = dynamic_cast<PlayerGameObject*>(current_game_object);
-
-			if (player) {
-				// If distance is below a threshold, we have a collision
-				if (distance < 0.6f) {
-					// Check if collision is with a collidable object
-					if (!(potion->IsCollidable())) {
-						break;
-					}
-					std::cout << "Potion collected!" << std::endl;
-					potion->MarkForDeletion();
-					potion->SetCollidable(false);
-
-                    // Check if player is at full health
-                    if (player->hp_ < 3) {
-                        player->hp_ ++;
-                    }
-				}
-			}
-		}
-
-        // Check for collision with disc collectibles
-        for (int j = 0; j < discs_.size(); j++) {
-            DiscCollectibleGameObject* disc = discs_[j];
-            glm::vec3 curr_pos = current_game_object->GetPosition();
-            curr_pos.z = 0.0f;
-            glm::vec3 other_pos = disc->GetPosition();
-            other_pos.z = 0.0f;
-
-            float distance = glm::length(curr_pos - other_pos);
-
-            PlayerGameObject* player = dynamic_cast<PlayerGameObject*>(current_game_object);
-
-            if (player) {
-				// If distance is below a threshold, we have a collision
-				if (distance < 0.6f) {
-					// Check if collision is with a collidable object
-					if (!(disc->IsCollidable())) {
-						break;
-					}
-					std::cout << "Disc collected!" << std::endl;
-					disc->MarkForDeletion();
-					disc->SetCollidable(false);
-					player->goalObjectsCollected_++;
-                    std::cout << "Goal objects collected: " << player->goalObjectsCollected_ << std::endl;
-                    if(player->goalObjectsCollected_ == 3){
-						std::cout << "Player has won!" << std::endl;
-						glfwSetWindowShouldClose(window_, true);
-					}
-				}
-			}
-        }
-       
+    // Check for escape key press
+    if (glfwGetKey(window_, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
+        glfwSetWindowShouldClose(window_, true);
     }
 
+    // Read the movement keys
+    InputState input;
+    input.forward = glfwGetKey(window_, GLFW_KEY_W) == GLFW_PRESS;
+    input.backward = glfwGetKey(window_, GLFW_KEY_S) == GLFW_PRESS;
+    input.turn_right = glfwGetKey(window_, GLFW_KEY_D) == GLFW_PRESS;
+    input.turn_left = glfwGetKey(window_, GLFW_KEY_A) == GLFW_PRESS;
+    input.strafe_left = glfwGetKey(window_, GLFW_KEY_Z) == GLFW_PRESS;
+    input.strafe_right = glfwGetKey(window_, GLFW_KEY_C) == GLFW_PRESS;
+    input.boost = glfwGetKey(window_, GLFW_KEY_SPACE) == GLFW_PRESS;
+    input.fire = glfwGetMouseButton(window_, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+    input.drop_bomb = glfwGetMouseButton(window_, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS;
+
+    // B switches the collision broadphase, once per press
+    bool broadphase_key = glfwGetKey(window_, GLFW_KEY_B) == GLFW_PRESS;
+    input.next_broadphase = broadphase_key && !broadphase_key_down_;
+    broadphase_key_down_ = broadphase_key;
+
+    // F3 shows and hides the performance overlay
+    bool overlay_key = glfwGetKey(window_, GLFW_KEY_F3) == GLFW_PRESS;
+    if (overlay_key && !overlay_key_down_) {
+        perf_overlay_->Toggle();
+    }
+    overlay_key_down_ = overlay_key;
+
+    //getting cursor position
+    double xpos, ypos;
+    glfwGetCursorPos(window_, &xpos, &ypos);
+    input.aim = glm::vec2(xpos - width/2, ypos - height/2);
+
+    std::lock_guard<std::mutex> lock(input_mutex_);
+    input.fire = input.fire || input_.fire;
+    input.drop_bomb = input.drop_bomb || input_.drop_bomb;
+    input.next_broadphase = input.next_broadphase || input_.next_broadphase;
+    input_ = input;
 }
 
 
-void Game::Render(void){
+void Game::Render(const RenderSnapshot &snapshot){
+
+    PROFILE_SCOPE("render");
+    ALLOCATION_TAG(TAG_RENDER);
 
     // Clear background
     glClearColor(viewport_background_color_g.r,
                  viewport_background_color_g.g,
                  viewport_background_color_g.b, 0.0);
+    // The particle pass leaves depth writes off, which would stop the clear
+    glDepthMask(GL_TRUE);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // Use aspect ratio to properly scale the window
@@ -830,161 +511,31 @@ void Game::Render(void){
     float camera_zoom = 0.35f;
     glm::mat4 camera_zoom_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(camera_zoom, camera_zoom, camera_zoom));
     glm::mat4 view_matrix = window_scale_matrix * camera_zoom_matrix;
-    glm::mat4 hudProjection = glm::ortho(0.0f, (float)width, (float)height, 0.0f);
-
-    view_matrix = glm::translate(view_matrix, glm::vec3(-1 * player_->GetPosition().x, -1 * player_->GetPosition().y, 0.0f));
 
-    // Render the HUD
-    hud_->Render(window_scale_matrix * camera_zoom_matrix, current_time_);
-
-    // Render explosions objects
-    for (int i = 0; i < explosions_.size(); i++) {
-		explosions_[i]->Render(view_matrix, current_time_);
-	}
-    // Render bullet objects
-    for (int i = 0; i < bullets_.size(); i++) {
-        bullets_[i]->Render(view_matrix, current_time_);
-    }
-    // Render all game objects
-    for (int i = 1; i < game_objects_.size(); i++) {
-        game_objects_[i]->Render(view_matrix, current_time_);
-    }
-    // Render bone collectible objects
-    for (int i = 0; i < collectibles_.size(); i++) {
-		collectibles_[i]->Render(view_matrix, current_time_);
-	}
-    // Render potion collectible objects
-    for (int i = 0; i < potions_.size(); i++) {
-        potions_[i]->Render(view_matrix, current_time_);
-    }
-    // Render background objects
-    for (int i = 0; i < background_objects_.size(); i++) {
-		background_objects_[i]->Render(view_matrix, current_time_);
-	}
-    // Render grass particle system
-	grass_particle_system_->Render(view_matrix, current_time_);
-
-    // Render sparkle particle systems
-    for (int i = 0; i < discs_.size(); i++) {
-		discs_[i]->sparkles_->Render(view_matrix, current_time_);
-	}
-    // Render disc collectible objects
-    for (int i = 0; i < discs_.size(); i++) {
-        discs_[i]->Render(view_matrix, current_time_);
-    }
-    //render bomb objects
-    for (BombGameObject* bomb : bombs_) {
-        bomb->Render(view_matrix, current_time_);
-    }
-
-    // Render player object
-    game_objects_[0]->Render(view_matrix, current_time_);
-
-
-}
-//spawns bullet
-void Game::SpawnBullet(glm::vec3 position, glm::vec3 direction, GLuint texture, float speed, bool isFriendlyProjectile) {
-
-    double currentTime = glfwGetTime();
-    position.z = 0.0f;
-
-    //if can shoot
-    if (currentTime - lastShotTime_ >= shotCooldown_) {
-        GLuint bulletTexture = texture; 
-        float bulletSpeed = speed;
-        BulletGameObject * bullet = new BulletGameObject(position, sprite_, &sprite_shader_, bulletTexture, direction, bulletSpeed, isFriendlyProjectile);
-        bullets_.push_back(bullet);
-        if (isFriendlyProjectile) { lastShotTime_ = currentTime; }
-        //make enemy bullets smaller
-        if (!isFriendlyProjectile) { bullets_.back()->SetScale(glm::vec2(0.4f, 0.4f)); }
-        
-    }
-
-}
-
-void Game::SpawnOrbitEnemy(const glm::vec3& location) {
-    // Create a standard EnemyGameObject that will orbit around the OrbitEnemy
-    EnemyGameObject* orbitingObject = new EnemyGameObject(location, sprite_, &sprite_shader_, tex_[18]);
-    orbitingObject->SetDisabled(true); // Disable its independent behavior
-    orbitingObject->isOrbititnObject = true;
-    orbitingObject->SetRotation(pi_over_two);
-
-    // Add the orbiting object to the game's collection of game objects
-    game_objects_.push_back(orbitingObject);
-    game_objects_.back()->SetScale(glm::vec2(0.7f, 0.7f));
-
-    // Create the OrbitEnemy that will handle the orbiting
-    OrbitEnemy* orbitEnemy = new OrbitEnemy(this, location, sprite_, &sprite_shader_, tex_[11], orbitingObject);
-
-    // Add the OrbitEnemy to the game's collection of game objects
-    game_objects_.push_back(orbitEnemy);
-}
-
-void Game::DropBombAtLocation(const glm::vec3& location) {
-    float blastRadius = 2.0f; // Example blast radius
-    float timeToExplode = 3.0f; // Bomb will explode after 3 seconds
-    GLuint texture = tex_[16];
-
-    BombGameObject* bomb = new BombGameObject(location, sprite_, &sprite_shader_, texture, blastRadius, timeToExplode);
-    bombs_.push_back(bomb);
-}
-
-void Game::HandleBombExplosions() {
-    for (int i = 0; i < bombs_.size(); ++i) {
-        BombGameObject* bomb = bombs_[i];
-        if (bomb && bomb->HasExploded()) {
-            // Check for enemies within the blast radius and destroy them
-            glm::vec3 bombPosition = bomb->GetPosition();
-            float blastRadius = bomb->GetBlastRadius();
-
-            for (int j = 0; j < game_objects_.size();) {
-                EnemyGameObject* curr_enemy = dynamic_cast<EnemyGameObject*>(game_objects_[j]);
-
-                // Make sure curr_enemy is not nullptr before using it
-                if (curr_enemy && glm::distance(bombPosition, curr_enemy->GetPosition()) <= blastRadius) {
-                    // Enemy is within blast radius, destroy it
-                    explosions_.push_back(new ExplosionGameObject(curr_enemy->GetPosition(), sprite_, &sprite_shader_, tex_[6]));
-                    score += 100;
-                    curr_enemy->isOrbititnObject = false;
-                    game_objects_.erase(game_objects_.begin() + j);
-                }
-                else {
-                    ++j; // Only increment if we didn't erase
-                }
-            }
-
-            explosions_.push_back(new ExplosionGameObject(bomb->GetPosition(), sprite_, &sprite_shader_, tex_[6]));
-            explosions_.back()->SetScale(glm::vec2(3.0f, 3.0f));
-            // Remove the bomb from the game
-            delete bomb;
-            bombs_[i] = nullptr;  // Avoid dangling pointer
-            bombs_.erase(bombs_.begin() + i);
-            --i; // Decrement index to account for the removed element
-        }
-    }
-    // Remove all nullptr entries after handling explosions
-    bombs_.erase(std::remove(bombs_.begin(), bombs_.end(), nullptr), bombs_.end());
+    // Draw the world part of the way from the previous tick to the latest,
+    // by how much of a tick has passed since it arrived. This keeps the
+    // picture a tick behind, but moving smoothly between ticks
+    float blend = (float) ((glfwGetTime() - snapshot.publish_time) / simulation_tick_g);
+    blend = std::min(1.0f, std::max(0.0f, blend));
+    glm::vec3 camera_position = snapshot.camera_position - snapshot.camera_motion * (1.0f - blend);
+
+    view_matrix = glm::translate(view_matrix, glm::vec3(-1 * camera_position.x, -1 * camera_position.y, 0.0f));
+
+    // Render the HUD first; it is nearest, so the depth test rejects the
+    // world behind it
+    hud_->Render(window_scale_matrix * camera_zoom_matrix, snapshot.time);
+
+    // Stream the ground around the camera and record its chunks
+    tile_map_->Update(glm::vec2(camera_position.x, camera_position.y));
+    ground_commands_.Reset(1);
+    tile_map_->Render(ground_commands_.GetDrawList(0));
+    ground_commands_.Compile();
+
+    // Submit the commands recorded by the simulation, with the ground
+    // drawn between the opaque sprites and the blended effects
+    snapshot.commands.Submit(view_matrix, LAYER_HUD, LAYER_WORLD, blend);
+    ground_commands_.Submit(view_matrix, LAYER_GROUND, LAYER_GROUND);
+    snapshot.commands.Submit(view_matrix, LAYER_EFFECTS, LAYER_EFFECTS, blend);
 }
 
-
-
-
-void Game::AddBullet(BulletGameObject* bullet) {
-    bullets_.push_back(bullet);
-}
-
-glm::vec3 Game::CalculateDirectionVector(float angleRadians) {
-    return glm::vec3(cos(angleRadians), sin(angleRadians), 0.0f);
-}
-
-float Game::GetRotationAngleFromDirection(glm::vec3 direction) {
-    // Normalize the direction vector
-    glm::vec3 normalizedDirection = glm::normalize(direction);
-
-    // Calculate the angle in radians from the normalized direction vector
-    float angleRadians = atan2(normalizedDirection.y, normalizedDirection.x);
-
-    return angleRadians;
-}
-      
 } // namespace game
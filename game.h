@@ -4,27 +4,33 @@
 #define GLEW_STATIC
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 #include <vector>
 
+#include "asset_loader.h"
 #include "shader.h"
 #include "game_object.h"
-#include "explosion_game_object.h"
-#include "timer.h"
 #include "geometry.h"
-#include "tile.h"
+#include "tile_map.h"
+#include "frame_stats.h"
+#include "gpu_timer.h"
 #include "hud.h"
-#include "player_game_object.h"
-#include "bullet_game_object.h"
-#include "collectible_game_object.h"
-#include "disc_collectible_game_object.h"
-#include "potion_collectible_game_object.h"
-#include "particle_system.h"
-#include "sparkle_particle_system.h"
-#include "bomb_game_object.h"
+#include "perf_overlay.h"
+#include "scenario_runner.h"
+#include "simulation.h"
+#include "render_snapshot.h"
+#include "triple_buffer.h"
 
 namespace game {
 
     // A class for holding the main game objects
+    // Owns the window and everything OpenGL. The game world itself lives in
+    // a Simulation that runs on its own thread and publishes render
+    // snapshots, so the window thread only polls input and draws the latest
+    // snapshot
     class Game {
 
         //Test
@@ -44,20 +50,9 @@ namespace game {
             // Run the game (keep the game active)
             void MainLoop(void); 
 
-            //math function
-            glm::vec3 CalculateDirectionVector(float angleRadians);
-
-            //math function
-            float GetRotationAngleFromDirection(glm::vec3 direction);
-
-            //spawn bullet with given inputs
-            void SpawnBullet(glm::vec3 position, glm::vec3 direction, GLuint texture, float speed, bool isFriendlyProjectile);
-
-            //add bullet to vector
-            void AddBullet(BulletGameObject* bullet);
-
-            //spawn orbit enemy at given location
-            void SpawnOrbitEnemy(const glm::vec3& location);
+            // Play a load test scenario instead of the normal game; call before MainLoop()
+            // The window closes once the ramp is done, leaving the curve in <name>.csv
+            void LoadScenario(const std::string &path);
 
         private:
             // Main window: pointer to the GLFW window structure
@@ -66,11 +61,14 @@ namespace game {
             //hud
             HUD* hud_;
 
+            // Commands for drawing the ground, recorded on the window thread
+            RenderCommandBuffer ground_commands_;
+
             // Sprite geometry
             Geometry *sprite_;
 
-            // Tile sprite geometry
-            Geometry *tile_;
+            // Ground tiles, streamed around the camera
+            TileMap *tile_map_;
 
             // Particle geometry
             Geometry *particles_;
@@ -78,6 +76,12 @@ namespace game {
             // Sparkle particle geometry
             Geometry *sparkle_particles_;
 
+            // Textures and shader sources, from the asset archive when it was packed
+            AssetLoader assets_;
+
+            // Shader programs linked in earlier runs
+            ShaderCache shader_cache_;
+
             // Shader for rendering sprites in the scene
             Shader sprite_shader_;
 
@@ -97,63 +101,42 @@ namespace game {
             // This needs to be a pointer
             GLuint *tex_;
 
-            // Player object
-            PlayerGameObject *player_;
-
-            // List of game objects
-            std::vector<GameObject*> game_objects_;
-
-            // List of background objects
-            std::vector<GameObject*> background_objects_;
-
-            //List of explosion objects
-            std::vector<ExplosionGameObject*> explosions_;
+            // The game world, only touched by the simulation thread once it runs
+            Simulation simulation_;
 
-            // list for bullets
-            std::vector<BulletGameObject*> bullets_;
+            // Snapshots passed from the simulation thread to the window thread
+            TripleBuffer<RenderSnapshot> snapshots_;
 
-            // List of bone collectible objects
-            std::vector<CollectibleGameObject*> collectibles_;
+            // Latest input, written by the window thread and read by the simulation thread
+            std::mutex input_mutex_;
+            InputState input_;
 
-            // List of disc collectible objects
-            std::vector<DiscCollectibleGameObject*> discs_;
+            // Whether the broadphase key was down last frame, so holding it switches once
+            bool broadphase_key_down_ = false;
 
-            // list of potions
-            std::vector<PotionCollectibleGameObject*> potions_;
+            // Performance overlay, drawn with the HUD and toggled with F3
+            PerfOverlay *perf_overlay_ = nullptr;
+            GpuTimer *gpu_timer_ = nullptr;
+            bool overlay_key_down_ = false;
 
-            //list of bombs
-            std::vector<BombGameObject*> bombs_;
+            // Simulation thread and the flag that stops it
+            std::thread simulation_thread_;
+            std::atomic<bool> quit_simulation_;
 
-            // Explosion object
-            GameObject* explosion_;
+            // Load test being played, if any; driven from the simulation thread
+            ScenarioRunner *scenario_runner_ = nullptr;
 
-            // Grass Particle System
-            ParticleSystem* grass_particle_system_;
+            // Error thrown on the simulation thread, rethrown on the window thread
+            std::exception_ptr simulation_error_;
 
-            // Keep track of time
-            double current_time_;
+            // Frame times of the window thread, summarized when the game closes
+            FrameStats frame_stats_;
 
-            // Timer for spawning enemies
-            Timer enemy_timer_;
-            bool alternateEnemy = false;
+            // Scratch memory of the window thread's current frame
+            Arena frame_arena_;
 
-            // Timer for spawning collectibles
-            Timer collectible_timer_;
-
-            // Current collided object (int index in vector)
-            int curr_collided_object_;
-
-            //total score
-            int score;
-
-            float lastShotTime_; // Time since the last shot was fired
-            const float shotCooldown_ = 1.0f; // Cooldown period in seconds
-
-            float lastBombTime_;
-            const float bombCooldown_ = 3.5f; // Cooldown period in seconds
-
-            // Current amount of collected objects
-            int collected_objects_;
+            // Simulation time of the last snapshot the HUD was updated with
+            double hud_time_;
 
             // Callback for when the window is resized
             static void ResizeCallback(GLFWwindow* window, int width, int height);
@@ -161,25 +144,20 @@ namespace game {
             // Set a specific texture
             void SetTexture(GLuint w, const char *fname);
 
+            // Compile a shader from the named vertex and fragment programs
+            void InitShader(Shader &shader, const char *vertex_name, const char *fragment_name);
+
             // Load all textures
             void SetAllTextures();
 
-            // Handle user input
-            void HandleControls(double delta_time);
-
-            // Update all the game objects
-            void Update(double delta_time);
- 
-            // Render the game world
-            void Render(void);
-
-            //drops bomb at location
-            void DropBombAtLocation(const glm::vec3& location);
-
-            //handles updates for the bombs
-            void HandleBombExplosions();
+            // Read the state of the controls into input_
+            void HandleControls(void);
 
+            // Advance the simulation at a fixed rate until told to stop
+            void SimulationLoop(void);
 
+            // Render a snapshot of the game world
+            void Render(const RenderSnapshot &snapshot);
 
     }; // class Game
 
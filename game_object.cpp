@@ -1,21 +1,44 @@
 #define GLM_FORCE_RADIANS
 #include <glm/gtc/matrix_transform.hpp>
+#include <atomic>
 #include <iostream>
 
 #include "game_object.h"
 
 namespace game {
 
+// Objects constructed and not yet destroyed
+static std::atomic<int> live_objects_g(0);
+
+
 GameObject::GameObject(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture)
 {
+    live_objects_g++;
+
     // Initialize all attributes
     position_ = position;
+    prev_position_ = position;
     scale_ = glm::vec2(1.0f, 1.0f);
     angle_ = 0.0;
     geometry_ = geom;
     shader_ = shader;
     texture_ = texture; 
     render_gold_ = false;
+
+    // Two objects of scale 1 touch when their centres are 0.6 apart
+    collision_shape_ = CollisionShape::Circle(0.3f);
+}
+
+
+GameObject::~GameObject()
+{
+    live_objects_g--;
+}
+
+
+int GameObject::GetNumLive(void)
+{
+    return live_objects_g;
 }
 
 
@@ -66,13 +89,12 @@ void GameObject::Update(double delta_time) {
     t += delta_time;
 }
 
-void GameObject::Render(glm::mat4 view_matrix, double current_time){
+void GameObject::Render(DrawList &draw_list, int layer, double current_time){
 
-    // Set up the shader
-    shader_->Enable();
+    draw_list.Add(layer, position_.z, geometry_, shader_, texture_, GetUniforms(current_time));
+}
 
-    // Set up the view matrix
-    shader_->SetUniformMat4("view_matrix", view_matrix);
+glm::mat4 GameObject::GetTransformation(double current_time){
 
     // Setup the scaling matrix for the shader
     glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale_[0], scale_[1], 1.0));
@@ -89,28 +111,20 @@ void GameObject::Render(glm::mat4 view_matrix, double current_time){
     // Set up the translation matrix for the shader
     glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), position_);
 
-    // Use the player's homogenous coordinate to adjust the translation
-
     // Setup the transformation matrix for the shader
-    glm::mat4 transformation_matrix = translation_matrix * rotation_matrix * scaling_matrix;
-
-    // Set the transformation matrix in the shader
-    shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
-
-    // Set the "ghost" uniform in the shader
-    shader_->SetUniform1i("ghost", render_ghost_ ? 1 : 0);
-
-    // Set the "ghost" uniform in the shader
-    shader_->SetUniform1i("gold", render_gold_ ? 1 : 0);
-
-    // Set up the geometry
-    geometry_->SetGeometry(shader_->GetShaderProgram());
+    return translation_matrix * rotation_matrix * scaling_matrix;
+}
 
-    // Bind the entity's texture
-    glBindTexture(GL_TEXTURE_2D, texture_);
+UniformBlock GameObject::GetUniforms(double current_time){
 
-    // Draw the entity
-    glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+    UniformBlock uniforms;
+    uniforms.transformation = GetTransformation(current_time);
+    uniforms.motion = GetMotion();
+    uniforms.time = (float) current_time;
+    uniforms.ghost = render_ghost_;
+    uniforms.gold = render_gold_;
+    uniforms.animated = false;
+    return uniforms;
 }
 
 } // namespace game
@@ -7,8 +7,9 @@
 
 #include "shader.h"
 #include "geometry.h"
-#include "tile.h"
 #include "sprite.h"
+#include "render_command_buffer.h"
+#include "collision_shape.h"
 
 namespace game {
 
@@ -22,20 +23,47 @@ namespace game {
             // Constructor
             GameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture);
 
+            // Destructor; virtual, since objects are deleted through GameObject pointers
+            virtual ~GameObject();
+
+            // GameObjects in existence, on every thread
+            static int GetNumLive(void);
+
             // Update the GameObject's state. Can be overriden in children
             virtual void Update(double delta_time);
 
-            // Renders the GameObject 
-            virtual void Render(glm::mat4 view_matrix, double current_time);
+            // Records the commands that render the GameObject in the given layer
+            // Does not touch OpenGL, so it can run on any thread
+            virtual void Render(DrawList &draw_list, int layer, double current_time);
+
+            // Transformation matrix used to draw the GameObject
+            virtual glm::mat4 GetTransformation(double current_time);
+
+            // Shader uniforms used to draw the GameObject
+            virtual UniformBlock GetUniforms(double current_time);
+
+            // Distance moved during the current tick, for drawing between ticks
+            virtual glm::vec3 GetMotion(void) const { return position_ - prev_position_; }
 
             // Getters
             inline glm::vec3 GetPosition(void) const { return position_; }
+            inline glm::vec3 GetPreviousPosition(void) const { return prev_position_; }
             inline glm::vec2 GetScale(void) const { return scale_; }
             inline float GetRotation(void) const { return angle_; }
             bool IsCollidable(void) const { return isCollidable_; }
             bool IsOrbiting(void) const { return isOrbiting_; }
             bool IsGhost(void) const { return render_ghost_; }
             bool IsDisabled(void) const { return disabled_; }
+            bool IsSleeping(void) const { return sleeping_; }
+
+            // Whether the update scheduler picked the object for this tick,
+            // and the time its update will be handed
+            bool IsUpdateDue(void) const { return lod_due_; }
+            double GetPendingTime(void) const { return lod_pending_time_; }
+
+            // Collision shape for scale 1, and as placed in the world
+            const CollisionShape &GetCollisionShape(void) const { return collision_shape_; }
+            CollisionShape GetWorldCollisionShape(void) const { return collision_shape_.Transformed(scale_, angle_); }
 
             // Get bearing direction (direction in which the game object
             // is facing)
@@ -45,10 +73,12 @@ namespace game {
             glm::vec3 GetRight(void) const;
 
             // Calculate the orbit matrix
-            glm::mat4 GameObject::CalculateOrbitMatrix(double currentTime);
+            glm::mat4 CalculateOrbitMatrix(double currentTime);
 
             // Setters
             inline void SetPosition(const glm::vec3& position) { position_ = position; }
+            // Remember the position at the start of a tick
+            inline void SavePosition(void) { prev_position_ = position_; }
             inline void SetScale(glm::vec2 s) { scale_ = s; }
             void SetRotation(float angle);
             void SetOrbit(float radius, float speed, glm::vec2 centre);
@@ -57,6 +87,11 @@ namespace game {
             void SetGold(bool isGold) { render_gold_ = isGold; }
             void SetTexture(GLuint texture) { texture_ = texture; }
             void SetDisabled(bool disabled) { disabled_ = disabled; }
+            void SetCollisionShape(const CollisionShape &shape) { collision_shape_ = shape; }
+
+            // Sleeping objects are not updated until they are woken, e.g. by a collision
+            void Sleep(void) { sleeping_ = true; }
+            void Wake(void) { sleeping_ = false; }
 
             // Method to mark the object for deletion
             void MarkForDeletion() { marked_for_deletion_ = true; }
@@ -68,6 +103,7 @@ namespace game {
         protected:
             // Object's Transform Variables
             glm::vec3 position_;
+            glm::vec3 prev_position_;
             glm::vec2 scale_;
             float angle_;
 
@@ -80,8 +116,9 @@ namespace game {
             // Object's texture reference
             GLuint texture_;
 
-            // Object's collision sphere
+            // Object's collision shape
             bool isCollidable_ = true;
+            CollisionShape collision_shape_;
 
             // Object's orbiting variables
             bool isOrbiting_ = false;
@@ -100,6 +137,20 @@ namespace game {
 
             bool marked_for_deletion_ = false;
 
+            bool sleeping_ = false;
+
+        private:
+            // Copying would throw off the count of live objects
+            GameObject(const GameObject&) = delete;
+            GameObject &operator=(const GameObject&) = delete;
+
+            // Level of detail bookkeeping: simulation time not yet handed to
+            // Update, ticks since the last update, and whether one is due
+            friend class UpdateScheduler;
+            double lod_pending_time_ = 0.0;
+            int lod_ticks_ = 0;
+            bool lod_due_ = false;
+
     }; // class GameObject
 
 } // namespace game
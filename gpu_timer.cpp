@@ -0,0 +1,72 @@
+#include "gpu_timer.h"
+
+namespace game {
+
+const int GpuTimer::NUM_QUERIES;
+
+
+GpuTimer::GpuTimer(void)
+{
+    supported_ = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    next_ = 0;
+    seconds_ = 0.0;
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        queries_[i] = 0;
+        pending_[i] = false;
+    }
+    if (supported_) {
+        glGenQueries(NUM_QUERIES, queries_);
+    }
+}
+
+
+GpuTimer::~GpuTimer()
+{
+    if (supported_) {
+        glDeleteQueries(NUM_QUERIES, queries_);
+    }
+}
+
+
+void GpuTimer::Begin(void)
+{
+    if (!supported_) {
+        return;
+    }
+
+    // Pick up every result that has arrived, oldest first
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        int query = (next_ + i) % NUM_QUERIES;
+        if (!pending_[query]) {
+            continue;
+        }
+        GLint available = 0;
+        glGetQueryObjectiv(queries_[query], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(queries_[query], GL_QUERY_RESULT, &nanoseconds);
+        seconds_ = nanoseconds * 1e-9;
+        pending_[query] = false;
+    }
+
+    // With every query still in flight, skip timing this frame rather than wait
+    if (pending_[next_]) {
+        return;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, queries_[next_]);
+}
+
+
+void GpuTimer::End(void)
+{
+    if (!supported_ || pending_[next_]) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    pending_[next_] = true;
+    next_ = (next_ + 1) % NUM_QUERIES;
+}
+
+} // namespace game
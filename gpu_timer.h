@@ -0,0 +1,43 @@
+#ifndef GPU_TIMER_H_
+#define GPU_TIMER_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+namespace game {
+
+    // Measures how long the GPU spends on a frame with timer queries
+    // Results arrive a few frames late; they are read only once available,
+    // so timing never waits on the GPU. Does nothing where timer queries
+    // are not supported
+    class GpuTimer {
+
+        public:
+            // Constructor and destructor; need a GL context
+            GpuTimer(void);
+            ~GpuTimer();
+
+            // Bracket the GL commands of a frame
+            void Begin(void);
+            void End(void);
+
+            // GPU time of the latest frame whose result has arrived, in seconds
+            double GetSeconds(void) const { return seconds_; }
+
+            bool IsSupported(void) const { return supported_; }
+
+        private:
+            // Queries in flight, used in turn
+            static const int NUM_QUERIES = 4;
+            GLuint queries_[NUM_QUERIES];
+            bool pending_[NUM_QUERIES];
+            int next_;
+
+            bool supported_;
+            double seconds_;
+
+    }; // class GpuTimer
+
+} // namespace game
+
+#endif // GPU_TIMER_H_
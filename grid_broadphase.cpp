@@ -0,0 +1,118 @@
+#include <algorithm>
+
+#include "collision_system.h"
+#include "grid_broadphase.h"
+
+namespace game {
+
+// Neighbouring cells searched from each cell. Only half of the 3x3
+// neighbourhood is needed, since the other half is covered when the
+// neighbour itself is processed, so each pair is found exactly once
+static const int neighbour_offsets_g[4][2] = { {1, 0}, {1, 1}, {0, 1}, {-1, 1} };
+
+// Record a pair in index order, so it reads the same whichever cell found it
+static void AddPair(int i, int j, std::vector<ProxyPair> &pairs)
+{
+    ProxyPair pair;
+    pair.a = std::min(i, j);
+    pair.b = std::max(i, j);
+    pairs.push_back(pair);
+}
+
+
+int GridBroadphase::Build(const std::vector<CollisionProxy> &proxies)
+{
+    int num_proxies = (int) proxies.size();
+    radii_.resize(num_proxies);
+    for (int i = 0; i < num_proxies; i++) {
+        radii_[i] = proxies[i].shape.bounding_radius;
+    }
+    float limit = 0.0f;
+    if (num_proxies > 0) {
+        std::nth_element(radii_.begin(), radii_.begin() + num_proxies / 2, radii_.end());
+        limit = 2.0f * radii_[num_proxies / 2];
+    }
+
+    // Split off the large shapes, and size the cells for the rest
+    float largest = 0.0f;
+    large_.clear();
+    large_rank_.resize(num_proxies);
+    for (int i = 0; i < num_proxies; i++) {
+        float radius = proxies[i].shape.bounding_radius;
+        if (radius > limit) {
+            large_rank_[i] = (int) large_.size();
+            large_.push_back(i);
+        }
+        else {
+            large_rank_[i] = -1;
+            largest = std::max(largest, radius);
+        }
+    }
+    if (largest > 0.0f) {
+        grid_.SetCellLength(2.0f * largest);
+    }
+
+    grid_.Clear();
+    for (int i = 0; i < num_proxies; i++) {
+        if (large_rank_[i] < 0) {
+            grid_.Insert(i, proxies[i].position);
+        }
+    }
+    grid_.Build();
+    return grid_.GetNumCells() + (int) large_.size();
+}
+
+
+void GridBroadphase::FindPairs(const std::vector<CollisionProxy> &proxies, int begin, int end, std::vector<ProxyPair> &pairs) const
+{
+    // Units past the cells are the large shapes
+    int num_cells = grid_.GetNumCells();
+    for (int unit = std::max(begin, num_cells); unit < end; unit++) {
+        int rank = unit - num_cells;
+        int i = large_[rank];
+        const CollisionProxy &large = proxies[i];
+
+        // Every proxy in the grid, and the large ones after this one, whose bounding circles meet
+        for (int j = 0; j < (int) proxies.size(); j++) {
+            if (large_rank_[j] >= 0 && large_rank_[j] <= rank) {
+                continue;
+            }
+            float reach = large.shape.bounding_radius + proxies[j].shape.bounding_radius;
+            glm::vec2 offset = proxies[j].position - large.position;
+            if (glm::dot(offset, offset) <= reach * reach) {
+                AddPair(i, j, pairs);
+            }
+        }
+    }
+
+    end = std::min(end, num_cells);
+    for (int cell = begin; cell < end; cell++) {
+        const int *items = grid_.GetCellItems(cell);
+        int count = grid_.GetCellSize(cell);
+
+        // Pairs inside this cell
+        for (int i = 0; i < count; i++) {
+            for (int j = i + 1; j < count; j++) {
+                AddPair(items[i], items[j], pairs);
+            }
+        }
+
+        // Pairs with the neighbouring cells
+        glm::ivec2 coords = grid_.GetCellCoords(cell);
+        for (int n = 0; n < 4; n++) {
+            int other = grid_.FindCell(coords.x + neighbour_offsets_g[n][0], coords.y + neighbour_offsets_g[n][1]);
+            if (other < 0) {
+                continue;
+            }
+            const int *other_items = grid_.GetCellItems(other);
+            int other_count = grid_.GetCellSize(other);
+            for (int i = 0; i < count; i++) {
+                for (int j = 0; j < other_count; j++) {
+                    AddPair(items[i], other_items[j], pairs);
+                }
+            }
+        }
+    }
+}
+
+} // namespace game
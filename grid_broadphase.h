@@ -0,0 +1,37 @@
+#ifndef GRID_BROADPHASE_H_
+#define GRID_BROADPHASE_H_
+
+#include "broadphase.h"
+#include "spatial_grid.h"
+
+namespace game {
+
+    // Broadphase that buckets proxies in a uniform grid
+    // The cells are as wide as the two largest gridded shapes put together,
+    // so every pair that may touch lies in the same or adjacent cells.
+    // Shapes more than twice the median size are kept out of the grid, so a
+    // few large ones cannot coarsen it, and are tested against every proxy
+    // instead. Each occupied cell is a unit of work, as is each large shape
+    class GridBroadphase : public Broadphase {
+
+        public:
+            int Build(const std::vector<CollisionProxy> &proxies) override;
+            void FindPairs(const std::vector<CollisionProxy> &proxies, int begin, int end, std::vector<ProxyPair> &pairs) const override;
+
+        private:
+            SpatialGrid grid_;
+
+            // Proxies kept out of the grid
+            std::vector<int> large_;
+
+            // For each proxy, its place in large_, or -1 if it is in the grid
+            std::vector<int> large_rank_;
+
+            // Scratch for finding the median size
+            std::vector<float> radii_;
+
+    }; // class GridBroadphase
+
+} // namespace game
+
+#endif // GRID_BROADPHASE_H_
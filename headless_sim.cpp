@@ -0,0 +1,260 @@
+// Runs the game simulation without a window or OpenGL
+// The player drives in wide circles, firing and dropping bombs on a fixed
+// schedule, and ticks run back to back as fast as they can. Tick times are
+// reported at the end, so runs on machines without a GPU can be compared.
+// Given a scenario file, the run follows its population ramp instead and
+// reports frame times for each step
+// With an allocation budget, every tick's heap allocations are tracked by
+// part of the simulation, and the run aborts on the first tick over budget,
+// listing the places that allocated most when --alloc-sites is also given
+// A soak test runs for hours of game time with the player invulnerable,
+// sampling memory and object counts every minute, and fails when any of
+// them keeps growing; --curve then writes the samples. It exits with 1 when
+// something grew and 2 when the run was too short to tell
+//
+// Usage: headless_sim [seconds of game time] [broadphase] [--scenario file] [--curve file.csv]
+//                     [--alloc-budget count[:bytes]] [--alloc-sites] [--soak hours]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "memory_stats.h"
+#include "scenario_runner.h"
+#include "simulation.h"
+#include "soak_monitor.h"
+
+using namespace game;
+
+// Fixed tick of the simulation, as in the game
+static const double tick_g = 1.0 / 30.0;
+
+// Game time between soak samples, and the most warmup a soak gets
+static const double soak_interval_g = 60.0;
+static const double soak_warmup_g = 600.0;
+
+// Texture ids handed to the simulation; they are only recorded, never bound
+static const int num_textures_g = 19;
+
+
+int main(int argc, char **argv)
+{
+    // Up to two positional arguments, with options anywhere
+    std::vector<const char*> positional;
+    const char *scenario_path = nullptr;
+    const char *curve_path = nullptr;
+    const char *budget = nullptr;
+    bool call_sites = false;
+    double soak_hours = 0.0;
+    bool usage = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--scenario") && i + 1 < argc) {
+            scenario_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--curve") && i + 1 < argc) {
+            curve_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--alloc-budget") && i + 1 < argc) {
+            budget = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--alloc-sites")) {
+            call_sites = true;
+        }
+        else if (!strcmp(argv[i], "--soak") && i + 1 < argc) {
+            soak_hours = atof(argv[++i]);
+            usage |= soak_hours <= 0.0;
+        }
+        else if (argv[i][0] == '-' || positional.size() == 2) {
+            usage = true;
+        }
+        else {
+            positional.push_back(argv[i]);
+        }
+    }
+    double seconds = positional.size() > 0 ? atof(positional[0]) : 60.0;
+    int broadphase = positional.size() > 1 ? atoi(positional[1]) : BROADPHASE_GRID;
+    if (usage || seconds <= 0.0 || broadphase < 0 || broadphase >= NUM_BROADPHASES || (soak_hours > 0.0 && scenario_path)) {
+        fprintf(stderr, "usage: headless_sim [seconds] [broadphase 0-%d] [--scenario file] [--curve file.csv]"
+                " [--alloc-budget count[:bytes]] [--alloc-sites] [--soak hours]\n", NUM_BROADPHASES - 1);
+        return 1;
+    }
+
+    // Track allocations from the start, so the call sites cover setup too
+    bool tracking = budget || call_sites;
+    if (tracking) {
+        const char *bytes = budget ? strchr(budget, ':') : nullptr;
+        SetAllocationBudget(budget ? strtoull(budget, nullptr, 10) : 0, bytes ? strtoull(bytes + 1, nullptr, 10) : 0, true);
+        EnableAllocationTracking(call_sites);
+    }
+
+    Scenario scenario;
+    if (scenario_path) {
+        std::string error;
+        if (!LoadScenario(scenario_path, scenario, error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        // The ramp decides how long the run is
+        seconds = scenario.steps * scenario.seconds_per_step + tick_g;
+    }
+    bool soak = soak_hours > 0.0;
+    if (soak) {
+        seconds = soak_hours * 3600.0;
+    }
+
+    GLuint textures[num_textures_g];
+    for (int i = 0; i < num_textures_g; i++) {
+        textures[i] = i + 1;
+    }
+    SimulationResources resources;
+    resources.sprite = nullptr;
+    resources.particles = nullptr;
+    resources.sparkle_particles = nullptr;
+    resources.sprite_shader = nullptr;
+    resources.particle_shader = nullptr;
+    resources.sparkle_particle_shader = nullptr;
+    resources.tex = textures;
+
+    Simulation simulation;
+    // Soaks and scenarios run long enough that the game's log of every
+    // spawn and explosion would bury their report
+    simulation.SetLogging(!soak && !scenario_path);
+    simulation.Setup(resources);
+    simulation.SetBroadphase(broadphase);
+    RenderSnapshot snapshot;
+    ScenarioRunner runner(scenario);
+
+    // A soak must not end early because the player died
+    if (soak) {
+        simulation.SetInvulnerable(true);
+    }
+    SoakMonitor soak_monitor(std::min(soak_warmup_g, seconds / 4.0));
+    int soak_ticks = (int) (soak_interval_g / tick_g + 0.5);
+
+    int num_ticks = (int) (seconds / tick_g);
+    std::vector<double> tick_times;
+    tick_times.reserve(num_ticks);
+    AllocationFrame allocations;
+    AllocationFrame total_allocations = AllocationFrame();
+
+    for (int tick = 0; tick < num_ticks && !simulation.IsGameOver(); tick++) {
+        // Objects are placed outside the timed part of the tick
+        if (scenario_path) {
+            runner.Update(simulation, tick_g);
+            if (runner.IsFinished()) {
+                break;
+            }
+        }
+
+        InputState input = InputState();
+        input.forward = true;
+        input.turn_left = (tick / 90) % 4 == 0;
+        input.fire = tick % 10 == 0;
+        // Bombs go down two seconds before each soak sample, inside their three second fuse
+        input.drop_bomb = tick % 300 == 240;
+        input.aim = glm::vec2(100.0f, 0.0f);
+
+        // Only the tick itself counts against the budget, not placing scenario objects
+        if (tracking) {
+            CollectAllocations(allocations);
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        simulation.Step(tick_g, input);
+        simulation.BuildSnapshot(snapshot);
+        tick_times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        runner.ReportTick(tick_times.back());
+
+        if (tracking) {
+            CollectAllocations(allocations);
+            CheckAllocationBudget(allocations, tick);
+            total_allocations.count += allocations.count;
+            total_allocations.bytes += allocations.bytes;
+            for (int tag = 0; tag < NUM_ALLOCATION_TAGS; tag++) {
+                total_allocations.tag_count[tag] += allocations.tag_count[tag];
+                total_allocations.tag_bytes[tag] += allocations.tag_bytes[tag];
+            }
+        }
+
+        if (soak && (tick + 1) % soak_ticks == 0) {
+            double values[NUM_SOAK_SERIES];
+            values[SOAK_RESIDENT_BYTES] = (double) GetResidentBytes();
+            values[SOAK_LIVE_ALLOCATIONS] = (double) GetLiveAllocationCount();
+            values[SOAK_UNOWNED_OBJECTS] = (double) (GameObject::GetNumLive() - simulation.GetNumObjects());
+            for (int i = 0; i < NUM_OBJECT_LISTS; i++) {
+                values[SOAK_FIRST_LIST + i] = snapshot.list_sizes[i];
+            }
+            soak_monitor.AddSample((tick + 1) * tick_g, values);
+        }
+    }
+
+    if (tick_times.empty()) {
+        fprintf(stderr, "no ticks were run\n");
+        return 1;
+    }
+    double total = 0.0;
+    for (int i = 0; i < (int) tick_times.size(); i++) {
+        total += tick_times[i];
+    }
+    std::vector<double> sorted = tick_times;
+    std::sort(sorted.begin(), sorted.end());
+
+    printf("broadphase %s, %d ticks%s\n", GetBroadphaseName(broadphase), (int) tick_times.size(), simulation.IsGameOver() ? " (game over)" : "");
+    printf("tick ms: mean %.3f  median %.3f  p99 %.3f  max %.3f\n",
+           total * 1000.0 / tick_times.size(),
+           sorted[sorted.size() / 2] * 1000.0,
+           sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)] * 1000.0,
+           sorted.back() * 1000.0);
+    printf("draws in last snapshot: %d\n", snapshot.commands.GetNumDraws());
+    const FrameArenas &arenas = simulation.GetFrameArenas();
+    printf("tick scratch: high water %llu bytes per thread, %llu bytes held by %d arenas\n",
+           (unsigned long long) arenas.GetHighWater(), (unsigned long long) arenas.GetCapacity(), arenas.GetNumArenas());
+
+    static const char *spawn_names[NUM_SPAWN_TYPES] = { "enemy", "shooter", "bone", "potion" };
+    const SpawnCounters &counters = simulation.GetSpawnDirector().GetCounters();
+    for (int type = 0; type < NUM_SPAWN_TYPES; type++) {
+        printf("%-8s %5d spawned %5d despawned\n", spawn_names[type], counters.spawned[type], counters.despawned[type]);
+    }
+
+    if (tracking) {
+        printf("\nallocations per tick: %.1f (%.0f bytes)\n",
+               (double) total_allocations.count / tick_times.size(), (double) total_allocations.bytes / tick_times.size());
+        for (int tag = 0; tag < NUM_ALLOCATION_TAGS; tag++) {
+            if (total_allocations.tag_count[tag]) {
+                printf("  %-12s %10.1f allocations %12.0f bytes\n", GetAllocationTagName(tag),
+                       (double) total_allocations.tag_count[tag] / tick_times.size(), (double) total_allocations.tag_bytes[tag] / tick_times.size());
+            }
+        }
+        if (call_sites) {
+            PrintAllocationCallSites(10);
+        }
+    }
+
+    if (soak) {
+        printf("\n");
+        bool passed = soak_monitor.PrintReport();
+        if (curve_path && !soak_monitor.WriteSamples(curve_path)) {
+            fprintf(stderr, "could not write %s\n", curve_path);
+            return 1;
+        }
+        // A run too short to judge is neither a pass nor a leak
+        if (!soak_monitor.IsConclusive()) {
+            return 2;
+        }
+        return passed ? 0 : 1;
+    }
+
+    if (scenario_path) {
+        printf("\n");
+        runner.PrintCurve();
+        if (curve_path && !runner.WriteCurve(curve_path)) {
+            fprintf(stderr, "could not write %s\n", curve_path);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -13,8 +13,12 @@ uniform bool gold;
 
 void main()
 {
-    // Sample texture
+    // Sample texture; its colour is premultiplied by alpha, so undo that
     vec4 color = texture2D(onetex, uv_interp);
+    if (color.a > 0.0)
+    {
+        color.rgb /= color.a;
+    }
 
     // Check if the object is in "ghost" mode
     if (gold)
@@ -36,8 +40,9 @@ void main()
 		gl_FragColor = vec4(color.r, color.g, color.b, color.a);
 	}
 
-    // Check for transparency
-    if(color.a < 1.0)
+    // Check for transparency; at half coverage, so sprites keep their
+    // shape in the smaller mipmaps
+    if(color.a < 0.5)
     {
          discard;
     }
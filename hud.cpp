@@ -1,36 +1,28 @@
 #include "hud.h"
-#include <SOIL/SOIL.h>
+#include "memory_stats.h"
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 
 
 namespace game {
 
-    HUD::HUD(const std::string& hudTexturePath, Shader* shader, const glm::mat4& projectionMatrix, Shader* heart_shader)
-        : shader_(shader), projectionMatrix_(projectionMatrix), score_(0), health_(0), collectibles_(0) {
+    HUD::HUD(const HudTextures& textures, Geometry* sprite, Shader* shader, const glm::mat4& projectionMatrix, Shader* heart_shader)
+        : shader_(shader), projectionMatrix_(projectionMatrix), score_(0), health_(0), collectibles_(0), sprite_(sprite) {
 
-        sprite_ = new Sprite();
-        sprite_->CreateGeometry(); 
-
-        // Load number textures
+        // Take the textures loaded by the game
         for (int i = 0; i < 10; ++i) {
-            GLuint textureID;
-            std::string filename = hudTexturePath + std::to_string(i) + ".png";
-            LoadTexture(textureID, filename.c_str());
-            numberTextures[i] = textureID; // Save the texture ID
+            numberTextures[i] = textures.numbers[i];
         }
-        // Load symbol textures
-        LoadTexture(symbolTextures[0], (hudTexturePath + "x.png").c_str());
-        LoadTexture(symbolTextures[1], (hudTexturePath + "y.png").c_str());
-        LoadTexture(symbolTextures[2], (hudTexturePath + "-.png").c_str());
-
-        // Load the score label texture
-        LoadTexture(scoreLabelTexture, (hudTexturePath + "score.png").c_str());
-        LoadTexture(heartTexture, (hudTexturePath + "heart.png").c_str());
-        LoadTexture(emptyHeartTexture, (hudTexturePath + "emptyHeart.png").c_str());
-        LoadTexture(boneTexture, (hudTexturePath + "bone.png").c_str());
-        LoadTexture(emptyBoneTexture, (hudTexturePath + "bone_empty.png").c_str());
-        LoadTexture(discTexture, (hudTexturePath + "disc.png").c_str());
-
+        for (int i = 0; i < 3; ++i) {
+            symbolTextures[i] = textures.symbols[i];
+        }
+        scoreLabelTexture = textures.scoreLabel;
+        heartTexture = textures.heart;
+        emptyHeartTexture = textures.emptyHeart;
+        boneTexture = textures.bone;
+        emptyBoneTexture = textures.emptyBone;
+        discTexture = textures.disc;
 
         // Position HUD elements at the top-left corner of the screen
         glm::vec3 scorePosition(-2.7f, 2.4f, 0.0f);
@@ -166,103 +158,98 @@ namespace game {
         for (auto& digit : gameTimeDigits_) {
             delete digit;
         }
-        delete sprite_;
-        
     }
 
-    void HUD::LoadTexture(GLuint& texture, const char* filepath) {
+    void HUD::Record(double currentTime) {
+        // Record the elements into a command buffer, to be drawn in one pass
+        commands_.Reset(1);
+        DrawList& drawList = commands_.GetDrawList(0);
 
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-
-        int width, height;
-        unsigned char* image = SOIL_load_image(filepath, &width, &height, 0, SOIL_LOAD_RGBA);
-        if (image) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            SOIL_free_image_data(image);
-        }
-        else {
-            std::cerr << "HUD texture failed to load at path: " << filepath << std::endl;
-            texture = 0;
-        }
-
-        glBindTexture(GL_TEXTURE_2D, 0);
-    }
-
-    void HUD::Render(glm::mat4 viewMatrix, double currentTime) {
-        shader_->Enable();
-
-        // Since we're now rendering in screen space, the view matrix is typically an identity matrix
-        glm::mat4 identityMatrix = glm::mat4(1.0f);
-
-        // Go through each element and render it with the viewMatrix and currentTime
+        // Go through each element and record it with currentTime
         for (auto element : hudElements) {
-            element->Render(viewMatrix, currentTime);
+            element->Render(drawList, LAYER_HUD, currentTime);
         }
         for (auto element : scoreDigits_) {
-            element->Render(viewMatrix, currentTime);
+            element->Render(drawList, LAYER_HUD, currentTime);
         }
         for (auto element : hearts) {
-            element->Render(viewMatrix, currentTime);
+            element->Render(drawList, LAYER_HUD, currentTime);
         }
         for (auto element : bones) {
-            element->Render(viewMatrix, currentTime);
+            element->Render(drawList, LAYER_HUD, currentTime);
         }
         for (auto element : coordinateDigits_) {
-			element->Render(viewMatrix, currentTime);
+			element->Render(drawList, LAYER_HUD, currentTime);
 		}
         for (auto element : gameTimeDigits_) {
-            element->Render(viewMatrix, currentTime);
+            element->Render(drawList, LAYER_HUD, currentTime);
         }
 
-        xSymbol_->Render(viewMatrix, currentTime);
-        ySymbol_->Render(viewMatrix, currentTime);
+        xSymbol_->Render(drawList, LAYER_HUD, currentTime);
+        ySymbol_->Render(drawList, LAYER_HUD, currentTime);
 
         // Render the disc symbol and score
-        disc_->Render(viewMatrix, currentTime);
-        discScore_->Render(viewMatrix, currentTime);
+        disc_->Render(drawList, LAYER_HUD, currentTime);
+        discScore_->Render(drawList, LAYER_HUD, currentTime);
 
         // Render the negative symbols iff the player is in the negative coordinates
         if (coordinates_.x < 0) {
-			xMinusSymbol_->Render(viewMatrix, currentTime);
+			xMinusSymbol_->Render(drawList, LAYER_HUD, currentTime);
 		}
         if (coordinates_.y < 0) {
-            yMinusSymbol_->Render(viewMatrix, currentTime);
+            yMinusSymbol_->Render(drawList, LAYER_HUD, currentTime);
         }
 
         // Render the invincibility timer digits if the timer is running
         if (invincibilityTimer_.Running() && invincibilityTimer_.TimeLeft() > 0.0f) {
             for (auto digit : invincibilityTimerDigits_) {
-                digit->Render(viewMatrix, currentTime);
+                digit->Render(drawList, LAYER_HUD, currentTime);
             }
         }
+
+        // The overlay goes in the same buffer, so its quads are batched with the HUD's
+        if (overlay_ && overlay_->IsVisible()) {
+            overlay_->Record(drawList);
+        }
+
+        commands_.Compile();
     }
 
+    // Write the decimal digits of a non-negative value, padded with zeros to at least width characters
+    static void FormatPadded(ArenaString& text, int value, int width) {
+        char digits[16];
+        int length = snprintf(digits, sizeof(digits), "%d", value);
+        text.assign(std::max(0, width - length), '0');
+        text.append(digits, length);
+    }
+
+
     void HUD::Update(int score, int health, int collectibles, bool isInvincible, float invincibilityTimeLeft, glm::vec2 coordinates, int numDiscs, double deltaTime) {
+        ALLOCATION_TAG(TAG_HUD);
+
         score_ = score;
         health_ = health;
         collectibles_ = collectibles;
         coordinates_ = coordinates;
         gameTime_ += deltaTime;
 
-        std::string scoreStr = std::to_string(score);
-        // Ensure the score string has exactly 4 characters, padding with zeros if necessary
-        scoreStr = std::string(4 - scoreStr.length(), '0') + scoreStr;
+        // The digit strings only last the frame, so they go in the frame's arena
+        ArenaAllocator<char> scratch(frameArena_);
+
+        // The score string has at least 4 characters, padded with zeros if necessary
+        ArenaString scoreStr(scratch);
+        FormatPadded(scoreStr, score, 4);
 
         // Convert the coordinates to positive integer strings
         // The coordinates are stored as floats, so we need to convert them to integers first
         int xCoord = static_cast<int>(coordinates.x);
         int yCoord = static_cast<int>(coordinates.y);
-        std::string xCoordStr = std::to_string(abs(xCoord));
-        std::string yCoordStr = std::to_string(abs(yCoord));
 
-        // Ensure the coordinate strings have exactly 2 characters, padding with zeros if necessary
-        xCoordStr = std::string(2 - xCoordStr.length(), '0') + xCoordStr;
-        yCoordStr = std::string(2 - yCoordStr.length(), '0') + yCoordStr;
+        // The coordinate strings have at least 2 characters, padded with zeros if necessary
+        ArenaString xCoordStr(scratch);
+        ArenaString yCoordStr(scratch);
+        FormatPadded(xCoordStr, abs(xCoord), 2);
+        FormatPadded(yCoordStr, abs(yCoord), 2);
         
         for (int i = 0; i < 3; ++i) {
             if (i < health) {
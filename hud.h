@@ -1,24 +1,59 @@
 #ifndef HUD_H
 #define HUD_H
 
+#include "arena.h"
 #include "game_object.h"
+#include "geometry.h"
+#include "perf_overlay.h"
+#include "render_command_buffer.h"
 #include "shader.h"
 #include <vector>
 #include <glm/glm.hpp>
-#include "sprite.h"
 #include <string>
 #include "timer.h"
 
 namespace game {
 
+    class AssetLoader;
+
+    // Textures the HUD is drawn with
+    struct HudTextures {
+        GLuint numbers[10]; // digits 0-9
+        GLuint symbols[3];  // "x", "y" and "-"
+        GLuint scoreLabel;
+        GLuint heart;
+        GLuint emptyHeart;
+        GLuint bone;
+        GLuint emptyBone;
+        GLuint disc;
+    };
+
+    // Load the HUD textures from the given folder of the assets; needs a GL context
+    HudTextures LoadHudTextures(AssetLoader& assets, const std::string& hudTexturePath);
+
     class HUD {
     public:
-        HUD(const std::string& hudTexturePath, Shader* shader, const glm::mat4& projectionMatrix, Shader* heart_shader);
+        // The sprite geometry is shared with the game and not owned by the HUD
+        HUD(const HudTextures& textures, Geometry* sprite, Shader* shader, const glm::mat4& projectionMatrix, Shader* heart_shader);
         ~HUD();
 
         void Update(int score, int health, int collectibles, bool isInvincible, float invincibilityTimeLeft, glm::vec2 coordinates, int numDiscs, double deltaTime);
+
+        // Record the HUD elements into its command buffer, ready to submit
+        void Record(double currentTime);
+
+        // Record and draw the HUD; needs a GL context
         void Render(glm::mat4 hudProjection, double currentTime);
 
+        // Draw the performance overlay as part of the HUD while it is visible; not owned
+        void SetOverlay(PerfOverlay* overlay) { overlay_ = overlay; }
+
+        // Scratch memory for strings built during Update(), reset by the owner every frame; not owned
+        void SetFrameArena(Arena* arena) { frameArena_ = arena; }
+
+        // Draws recorded by the last Record()
+        const RenderCommandBuffer& GetCommands(void) const { return commands_; }
+
     private:
         Shader* shader_;
         glm::mat4 projectionMatrix_;
@@ -36,6 +71,10 @@ namespace game {
         GameObject* discScore_; // HUD element for the num of discs collected
         GameObject* disc_; // HUD element for the disc symbol
 
+        RenderCommandBuffer commands_; // Commands for drawing the HUD elements
+        PerfOverlay* overlay_ = nullptr; // Performance figures drawn with the HUD
+        Arena* frameArena_ = nullptr; // Scratch memory of the current frame
+
         Timer invincibilityTimer_; // Timer for invincibility duration
         std::vector<GameObject*> invincibilityTimerDigits_; // HUD elements for the timer digits
 
@@ -58,9 +97,6 @@ namespace game {
         GLuint emptyBoneTexture;
         GLuint discTexture;
 
-        //loads textures
-        void LoadTexture(GLuint& texture, const char* filepath);
-
     };
 
 } // namespace game
@@ -0,0 +1,56 @@
+#include "hud.h"
+#include "asset_loader.h"
+#include <iostream>
+
+
+namespace game {
+
+    // Load a single texture, or set it to 0 if the image cannot be read
+    static void LoadTexture(AssetLoader& assets, GLuint& texture, const std::string& name) {
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+
+        if (assets.UploadTexture(name)) {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+        else {
+            std::cerr << "HUD texture failed to load at path: " << name << std::endl;
+            texture = 0;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    HudTextures LoadHudTextures(AssetLoader& assets, const std::string& hudTexturePath) {
+        HudTextures textures;
+
+        // Load number textures
+        for (int i = 0; i < 10; ++i) {
+            std::string filename = hudTexturePath + std::to_string(i) + ".png";
+            LoadTexture(assets, textures.numbers[i], filename);
+        }
+        // Load symbol textures
+        LoadTexture(assets, textures.symbols[0], hudTexturePath + "x.png");
+        LoadTexture(assets, textures.symbols[1], hudTexturePath + "y.png");
+        LoadTexture(assets, textures.symbols[2], hudTexturePath + "-.png");
+
+        // Load the score label texture
+        LoadTexture(assets, textures.scoreLabel, hudTexturePath + "score.png");
+        LoadTexture(assets, textures.heart, hudTexturePath + "heart.png");
+        LoadTexture(assets, textures.emptyHeart, hudTexturePath + "emptyHeart.png");
+        LoadTexture(assets, textures.bone, hudTexturePath + "bone.png");
+        LoadTexture(assets, textures.emptyBone, hudTexturePath + "bone_empty.png");
+        LoadTexture(assets, textures.disc, hudTexturePath + "disc.png");
+
+        return textures;
+    }
+
+    void HUD::Render(glm::mat4 viewMatrix, double currentTime) {
+        // Record the elements into a command buffer, then draw them in one pass
+        Record(currentTime);
+        commands_.Submit(viewMatrix);
+    }
+
+} // namespace game
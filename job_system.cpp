@@ -0,0 +1,123 @@
+#include <algorithm>
+
+#include "job_system.h"
+#include "memory_stats.h"
+
+namespace game {
+
+JobSystem::JobSystem(void)
+{
+    func_ = nullptr;
+    count_ = 0;
+    chunk_ = 1;
+    next_ = 0;
+    busy_workers_ = 0;
+    tag_ = TAG_UNTAGGED;
+    generation_ = 0;
+    quit_ = false;
+}
+
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread &worker : workers_) {
+        worker.join();
+    }
+}
+
+
+void JobSystem::Init(int num_threads)
+{
+    if (num_threads <= 0) {
+        num_threads = std::max(1, (int) std::thread::hardware_concurrency());
+    }
+
+    // The caller counts as one of the threads
+    for (int i = 1; i < num_threads; i++) {
+        workers_.push_back(std::thread(&JobSystem::WorkerLoop, this, i));
+    }
+}
+
+
+void JobSystem::ParallelFor(int count, int min_chunk, const std::function<void(int, int, int)> &func)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    // Not worth waking anyone up for a single chunk
+    int num_threads = GetNumThreads();
+    if (num_threads == 1 || count <= min_chunk) {
+        func(0, count, 0);
+        return;
+    }
+
+    // Aim for a few chunks per thread so uneven chunks balance out
+    int chunk = std::max(min_chunk, count / (num_threads * 4));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        func_ = &func;
+        count_ = count;
+        chunk_ = chunk;
+        next_ = 0;
+        busy_workers_ = (int) workers_.size();
+        tag_ = GetAllocationTag();
+        generation_++;
+    }
+    wake_.notify_all();
+
+    RunChunks(0);
+
+    // Wait for the workers to finish their last chunks
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return busy_workers_ == 0; });
+    func_ = nullptr;
+}
+
+
+void JobSystem::WorkerLoop(int thread_index)
+{
+    unsigned int seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return quit_ || generation_ != seen_generation; });
+            if (quit_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+
+        {
+            AllocationTagScope tag(tag_);
+            RunChunks(thread_index);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_workers_--;
+        }
+        done_.notify_one();
+    }
+}
+
+
+void JobSystem::RunChunks(int thread_index)
+{
+    while (true) {
+        int begin = next_.fetch_add(chunk_);
+        if (begin >= count_) {
+            return;
+        }
+        int end = std::min(begin + chunk_, count_);
+        (*func_)(begin, end, thread_index);
+    }
+}
+
+} // namespace game
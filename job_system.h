@@ -0,0 +1,65 @@
+#ifndef JOB_SYSTEM_H_
+#define JOB_SYSTEM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace game {
+
+    // A small pool of worker threads for splitting per-frame work across cores
+    // The calling thread always takes part in the work as thread index 0
+    class JobSystem {
+
+        public:
+            // Constructor and destructor
+            JobSystem(void);
+            ~JobSystem();
+
+            // Start the worker threads
+            // A count of 0 uses one thread per hardware core
+            void Init(int num_threads = 0);
+
+            // Total number of threads that run jobs, including the caller
+            int GetNumThreads(void) const { return (int) workers_.size() + 1; }
+
+            // Run func(begin, end, thread_index) over the range [0, count)
+            // The range is handed out in chunks of at least min_chunk items
+            // Blocks until every chunk has been processed
+            void ParallelFor(int count, int min_chunk, const std::function<void(int, int, int)> &func);
+
+        private:
+            // Loop run by each worker thread
+            void WorkerLoop(int thread_index);
+
+            // Grab chunks of the current job until none are left
+            void RunChunks(int thread_index);
+
+            std::vector<std::thread> workers_;
+
+            std::mutex mutex_;
+            std::condition_variable wake_;
+            std::condition_variable done_;
+
+            // Current job
+            const std::function<void(int, int, int)> *func_;
+            int count_;
+            int chunk_;
+            std::atomic<int> next_;
+            int busy_workers_;
+
+            // Allocation tag of the caller, so the workers charge their allocations to it
+            int tag_;
+
+            // Incremented for every new job so sleeping workers know to wake up
+            unsigned int generation_;
+            bool quit_;
+
+    }; // class JobSystem
+
+} // namespace game
+
+#endif // JOB_SYSTEM_H_
@@ -0,0 +1,162 @@
+// Microbenchmark of the bullet and steering batch kernels
+// Times the per-object virtual updates the kernels replace against the
+// kernels alone on each instruction set, and against the gather, kernel
+// and scatter round trip the simulation does every tick
+//
+// Usage: kernel_benchmark [objects] [ticks]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "batch_kernels.h"
+#include "bullet_game_object.h"
+#include "enemy_game_object.h"
+
+using namespace game;
+
+// Fixed tick of the simulation
+static const double tick_g = 1.0 / 60.0;
+
+// Seconds elapsed since a starting point
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static float Random(float low, float high)
+{
+    return low + (high - low) * (float) rand() / (float) RAND_MAX;
+}
+
+// Time per object per tick, in nanoseconds
+static void Report(const char *name, double seconds, int objects, int ticks)
+{
+    printf("  %-32s %9.3f ms  %7.2f ns/object\n", name, seconds * 1000.0, seconds * 1e9 / ((double) objects * ticks));
+}
+
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : 10000;
+    int ticks = argc > 2 ? atoi(argv[2]) : 200;
+    if (count <= 0 || ticks <= 0) {
+        fprintf(stderr, "usage: kernel_benchmark [objects] [ticks]\n");
+        return 1;
+    }
+
+    // The same random world for every run
+    srand(2501);
+    std::vector<BulletGameObject*> bullets;
+    std::vector<EnemyGameObject*> enemies;
+    for (int i = 0; i < count; i++) {
+        float angle = Random(0.0f, 6.2831853f);
+        glm::vec3 position(Random(-50.0f, 50.0f), Random(-50.0f, 50.0f), 0.0f);
+        bullets.push_back(new BulletGameObject(position, nullptr, nullptr, 0, glm::vec3(cos(angle), sin(angle), 0.0f), 10.0f, true));
+
+        EnemyGameObject *enemy = new EnemyGameObject(glm::vec3(Random(-50.0f, 50.0f), Random(-50.0f, 50.0f), 0.0f), nullptr, nullptr, 0);
+        enemy->state_ = INTERCEPTING_;
+        enemy->updatePlayerPos(glm::vec3(Random(-5.0f, 5.0f), Random(-5.0f, 5.0f), -1.0f));
+        enemies.push_back(enemy);
+    }
+
+    // Arrays for the kernels, taken before anything moves
+    BulletBatch bullet_batch;
+    ChaseBatch chase_batch;
+    bullet_batch.Resize(count);
+    chase_batch.Resize(count);
+    for (int i = 0; i < count; i++) {
+        glm::vec3 p = bullets[i]->GetPosition();
+        glm::vec3 v = bullets[i]->GetVelocity();
+        bullet_batch.Set(i, p.x, p.y, p.z, v.x, v.y, v.z);
+
+        EnemyGameObject *e = enemies[i];
+        p = e->GetPosition();
+        chase_batch.Set(i, p.x, p.y, p.z, e->velocity.x, e->velocity.y, e->velocity.z,
+                        e->chase_target_.x, e->chase_target_.y, e->chase_target_.z,
+                        e->steering_force_.x, e->steering_force_.y, e->steering_force_.z, e->speed, (float) tick_g);
+    }
+
+    printf("%d bullets and %d chasing enemies, %d ticks, best path %s\n\n", count, count, ticks, GetKernelPathName(GetBestKernelPath()));
+
+    // Per-object virtual updates, as before the kernels
+    std::vector<GameObject*> objects;
+    objects.insert(objects.end(), bullets.begin(), bullets.end());
+    objects.insert(objects.end(), enemies.begin(), enemies.end());
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; t++) {
+        for (int i = 0; i < (int) objects.size(); i++) {
+            objects[i]->Update(tick_g);
+        }
+    }
+    Report("virtual Update", Seconds(start), 2 * count, ticks);
+
+    // Kernels alone, on arrays that stay in place
+    int best = GetBestKernelPath();
+    std::vector<BulletBatch> bullet_results;
+    std::vector<ChaseBatch> chase_results;
+    for (int path = 0; path <= best; path++) {
+        BulletBatch b = bullet_batch;
+        ChaseBatch c = chase_batch;
+        start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; t++) {
+            IntegrateBullets(b, (float) tick_g, path);
+            SteerChasers(c, path);
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "kernels, %s", GetKernelPathName(path));
+        Report(name, Seconds(start), 2 * count, ticks);
+        bullet_results.push_back(b);
+        chase_results.push_back(c);
+    }
+
+    // Gather, kernels and scatter, as the simulation runs them
+    start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; t++) {
+        bullet_batch.Resize(count);
+        chase_batch.Resize(count);
+        for (int i = 0; i < count; i++) {
+            glm::vec3 p = bullets[i]->GetPosition();
+            glm::vec3 v = bullets[i]->GetVelocity();
+            bullet_batch.Set(i, p.x, p.y, p.z, v.x, v.y, v.z);
+
+            EnemyGameObject *e = enemies[i];
+            p = e->GetPosition();
+            chase_batch.Set(i, p.x, p.y, p.z, e->velocity.x, e->velocity.y, e->velocity.z,
+                            e->chase_target_.x, e->chase_target_.y, e->chase_target_.z,
+                            e->steering_force_.x, e->steering_force_.y, e->steering_force_.z, e->speed, (float) tick_g);
+        }
+        IntegrateBullets(bullet_batch, (float) tick_g, best);
+        SteerChasers(chase_batch, best);
+        for (int i = 0; i < count; i++) {
+            bullets[i]->SetPosition(glm::vec3(bullet_batch.x[i], bullet_batch.y[i], bullet_batch.z[i]));
+            enemies[i]->ApplySteering(glm::vec3(chase_batch.x[i], chase_batch.y[i], chase_batch.z[i]),
+                                      glm::vec3(chase_batch.vx[i], chase_batch.vy[i], chase_batch.vz[i]),
+                                      chase_batch.angle[i]);
+        }
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "gather + kernels + scatter, %s", GetKernelPathName(best));
+    Report(name, Seconds(start), 2 * count, ticks);
+
+    // The paths should agree with each other exactly
+    int mismatches = 0;
+    for (int path = 1; path <= best; path++) {
+        for (int i = 0; i < count; i++) {
+            if (bullet_results[path].x[i] != bullet_results[0].x[i] || bullet_results[path].y[i] != bullet_results[0].y[i] ||
+                chase_results[path].x[i] != chase_results[0].x[i] || chase_results[path].y[i] != chase_results[0].y[i] ||
+                chase_results[path].angle[i] != chase_results[0].angle[i]) {
+                mismatches++;
+            }
+        }
+    }
+    printf("\n%d mismatches between paths\n", mismatches);
+
+    for (int i = 0; i < count; i++) {
+        delete bullets[i];
+        delete enemies[i];
+    }
+    return mismatches == 0 ? 0 : 1;
+}
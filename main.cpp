@@ -15,6 +15,7 @@
 
 #include <iostream>
 #include <exception>
+#include <string>
 #include "game.h"
 
 // Macro for printing exceptions
@@ -22,7 +23,8 @@
     std::cerr << exception_object.what() << std::endl
 
 // Main function that builds and runs the game
-int main(void){
+// Usage: 2501-Final [--scenario file], the scenario running a load test
+int main(int argc, char **argv){
     game::Game the_game;
 
     try {
@@ -30,6 +32,9 @@ int main(void){
         the_game.Init();
         // Setup the game (game world, game objects, etc.)
         the_game.Setup();
+        if (argc > 2 && std::string(argv[1]) == "--scenario") {
+            the_game.LoadScenario(argv[2]);
+        }
         // Run the game
         the_game.MainLoop();
     }
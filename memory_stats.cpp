@@ -0,0 +1,344 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <execinfo.h>
+#define ALLOCATION_CALL_SITES 1
+#define TRACKER_NOINLINE __attribute__((noinline))
+#else
+#define TRACKER_NOINLINE
+#endif
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include "memory_stats.h"
+
+namespace game {
+
+static std::atomic<uint64_t> allocations_g(0);
+static std::atomic<uint64_t> frees_g(0);
+
+// Tracking switches
+static std::atomic<bool> tracking_g(false);
+static std::atomic<bool> track_call_sites_g(false);
+
+// Tag of each thread, and whether the thread is inside the tracker, so
+// allocations the tracker itself causes are not tracked
+static thread_local int tag_g = TAG_UNTAGGED;
+static thread_local bool in_tracker_g = false;
+
+// Allocations by tag since they were last collected
+static std::atomic<uint64_t> tag_count_g[NUM_ALLOCATION_TAGS];
+static std::atomic<uint64_t> tag_bytes_g[NUM_ALLOCATION_TAGS];
+
+// Stacks of allocations, in a fixed table since operator new cannot allocate
+// The first frames are the tracker and operator new, and are dropped; the
+// tracker is kept out of line so there are always the same number of them
+static const int CALL_SITE_SKIP = 3;
+static const int CALL_SITE_DEPTH = 6;
+static const int MAX_CALL_SITES = 4096;
+
+struct CallSite {
+    void *frames[CALL_SITE_DEPTH];
+    int depth;
+    uint64_t count;
+    uint64_t bytes;
+};
+
+static CallSite call_sites_g[MAX_CALL_SITES];
+static int num_call_sites_g = 0;
+static uint64_t lost_call_sites_g = 0;
+static std::mutex call_site_mutex_g;
+
+// Budget of a frame
+static uint64_t budget_count_g = 0;
+static uint64_t budget_bytes_g = 0;
+static bool abort_over_budget_g = false;
+
+static const char *tag_names_g[NUM_ALLOCATION_TAGS] = {
+    "untagged", "simulation", "spawning", "collision", "snapshot", "render", "hud", "loading"
+};
+
+
+uint64_t GetAllocationCount(void)
+{
+    return allocations_g.load(std::memory_order_relaxed);
+}
+
+
+int64_t GetLiveAllocationCount(void)
+{
+    return (int64_t) (allocations_g.load(std::memory_order_relaxed) - frees_g.load(std::memory_order_relaxed));
+}
+
+
+uint64_t GetResidentBytes(void)
+{
+#if defined(__linux__)
+    // The second figure of statm is the resident size in pages
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (!file) {
+        return 0;
+    }
+    unsigned long long size = 0, resident = 0;
+    int read = fscanf(file, "%llu %llu", &size, &resident);
+    fclose(file);
+    return read == 2 ? resident * (uint64_t) sysconf(_SC_PAGESIZE) : 0;
+#else
+    return 0;
+#endif
+}
+
+
+const char *GetAllocationTagName(int tag)
+{
+    return tag >= 0 && tag < NUM_ALLOCATION_TAGS ? tag_names_g[tag] : "unknown";
+}
+
+
+int GetAllocationTag(void)
+{
+    return tag_g;
+}
+
+
+AllocationTagScope::AllocationTagScope(int tag)
+{
+    previous_ = tag_g;
+    tag_g = tag;
+}
+
+
+AllocationTagScope::~AllocationTagScope()
+{
+    tag_g = previous_;
+}
+
+
+void EnableAllocationTracking(bool call_sites)
+{
+#ifdef ALLOCATION_CALL_SITES
+    if (call_sites) {
+        // The first stack walk loads the unwinder, which allocates; get it done now
+        void *frames[1];
+        backtrace(frames, 1);
+    }
+    track_call_sites_g = call_sites;
+#endif
+    tracking_g = true;
+}
+
+
+bool IsAllocationTracking(void)
+{
+    return tracking_g;
+}
+
+
+// Count an allocation against the stack that made it
+TRACKER_NOINLINE static void AddCallSite(std::size_t size)
+{
+#ifdef ALLOCATION_CALL_SITES
+    void *stack[CALL_SITE_SKIP + CALL_SITE_DEPTH];
+    int depth = backtrace(stack, CALL_SITE_SKIP + CALL_SITE_DEPTH) - CALL_SITE_SKIP;
+    if (depth <= 0) {
+        return;
+    }
+    void **frames = stack + CALL_SITE_SKIP;
+
+    uintptr_t hash = 0;
+    for (int i = 0; i < depth; i++) {
+        hash = hash * 31 + (uintptr_t) frames[i];
+    }
+
+    std::lock_guard<std::mutex> lock(call_site_mutex_g);
+    for (int probe = 0; probe < MAX_CALL_SITES; probe++) {
+        CallSite &site = call_sites_g[(hash + probe) % MAX_CALL_SITES];
+        if (site.depth == 0) {
+            std::copy(frames, frames + depth, site.frames);
+            site.depth = depth;
+            num_call_sites_g++;
+        }
+        else if (site.depth != depth || !std::equal(frames, frames + depth, site.frames)) {
+            continue;
+        }
+        site.count++;
+        site.bytes += size;
+        return;
+    }
+    lost_call_sites_g++;
+#else
+    (void) size;
+#endif
+}
+
+
+// Record an allocation made while tracking
+TRACKER_NOINLINE static void TrackAllocation(std::size_t size)
+{
+    if (in_tracker_g) {
+        return;
+    }
+    in_tracker_g = true;
+    tag_count_g[tag_g].fetch_add(1, std::memory_order_relaxed);
+    tag_bytes_g[tag_g].fetch_add(size, std::memory_order_relaxed);
+    if (track_call_sites_g.load(std::memory_order_relaxed)) {
+        AddCallSite(size);
+    }
+    in_tracker_g = false;
+}
+
+
+void CollectAllocations(AllocationFrame &frame)
+{
+    frame.count = 0;
+    frame.bytes = 0;
+    for (int tag = 0; tag < NUM_ALLOCATION_TAGS; tag++) {
+        frame.tag_count[tag] = tag_count_g[tag].exchange(0, std::memory_order_relaxed);
+        frame.tag_bytes[tag] = tag_bytes_g[tag].exchange(0, std::memory_order_relaxed);
+        frame.count += frame.tag_count[tag];
+        frame.bytes += frame.tag_bytes[tag];
+    }
+}
+
+
+static bool MoreBytes(const CallSite *a, const CallSite *b)
+{
+    return a->bytes > b->bytes;
+}
+
+
+void PrintAllocationCallSites(int count)
+{
+#ifdef ALLOCATION_CALL_SITES
+    // Copy out under the lock, then name the frames without it
+    std::vector<CallSite> sites;
+    {
+        in_tracker_g = true;
+        std::lock_guard<std::mutex> lock(call_site_mutex_g);
+        std::vector<const CallSite*> used;
+        for (int i = 0; i < MAX_CALL_SITES; i++) {
+            if (call_sites_g[i].depth > 0) {
+                used.push_back(&call_sites_g[i]);
+            }
+        }
+        std::sort(used.begin(), used.end(), MoreBytes);
+        for (int i = 0; i < (int) used.size() && i < count; i++) {
+            sites.push_back(*used[i]);
+        }
+        in_tracker_g = false;
+    }
+
+    // Frames in files built without -rdynamic show only addresses, for addr2line
+    printf("top %d of %d allocation call sites by bytes%s\n", (int) sites.size(), num_call_sites_g,
+           lost_call_sites_g ? " (table full, some not counted)" : "");
+    for (int i = 0; i < (int) sites.size(); i++) {
+        printf("%2d. %llu allocations, %llu bytes\n", i + 1, (unsigned long long) sites[i].count, (unsigned long long) sites[i].bytes);
+        char **names = backtrace_symbols(sites[i].frames, sites[i].depth);
+        for (int j = 0; j < sites[i].depth; j++) {
+            printf("      %s\n", names ? names[j] : "?");
+        }
+        free(names);
+    }
+#else
+    (void) count;
+    printf("allocation call sites are not available on this platform\n");
+#endif
+}
+
+
+void SetAllocationBudget(uint64_t count, uint64_t bytes, bool abort_over_budget)
+{
+    budget_count_g = count;
+    budget_bytes_g = bytes;
+    abort_over_budget_g = abort_over_budget;
+}
+
+
+bool CheckAllocationBudget(const AllocationFrame &frame, uint64_t frame_number)
+{
+    bool over = (budget_count_g && frame.count > budget_count_g) || (budget_bytes_g && frame.bytes > budget_bytes_g);
+    if (!over) {
+        return true;
+    }
+
+    printf("frame %llu over allocation budget: %llu allocations (budget %llu), %llu bytes (budget %llu)\n",
+           (unsigned long long) frame_number, (unsigned long long) frame.count, (unsigned long long) budget_count_g,
+           (unsigned long long) frame.bytes, (unsigned long long) budget_bytes_g);
+    for (int tag = 0; tag < NUM_ALLOCATION_TAGS; tag++) {
+        if (frame.tag_count[tag]) {
+            printf("  %-12s %8llu allocations %10llu bytes\n", tag_names_g[tag],
+                   (unsigned long long) frame.tag_count[tag], (unsigned long long) frame.tag_bytes[tag]);
+        }
+    }
+    if (abort_over_budget_g) {
+        if (track_call_sites_g) {
+            PrintAllocationCallSites(10);
+        }
+        fflush(stdout);
+        std::abort();
+    }
+    return false;
+}
+
+} // namespace game
+
+
+// Replacements of the global allocation functions
+// The array forms of the standard library forward to these; the nothrow
+// and sized forms are replaced too, so no library's defaults are relied on
+void *operator new(std::size_t size)
+{
+    game::allocations_g.fetch_add(1, std::memory_order_relaxed);
+    if (game::tracking_g.load(std::memory_order_relaxed)) {
+        game::TrackAllocation(size);
+    }
+    void *pointer = std::malloc(size ? size : 1);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+
+void operator delete(void *pointer) noexcept
+{
+    if (pointer) {
+        game::frees_g.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::free(pointer);
+}
+
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    game::allocations_g.fetch_add(1, std::memory_order_relaxed);
+    if (game::tracking_g.load(std::memory_order_relaxed)) {
+        game::TrackAllocation(size);
+    }
+    void *pointer = std::malloc(size ? size : 1);
+    if (!pointer) {
+        // Counted above, but never deleted
+        game::frees_g.fetch_add(1, std::memory_order_relaxed);
+    }
+    return pointer;
+}
+
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept
+{
+    operator delete(pointer);
+}
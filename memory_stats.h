@@ -0,0 +1,89 @@
+#ifndef MEMORY_STATS_H_
+#define MEMORY_STATS_H_
+
+#include <cstdint>
+
+namespace game {
+
+    // Heap allocations made through operator new since the program started, on every thread
+    // Counted by the global operator new in memory_stats.cpp with a single
+    // relaxed atomic add, so it is cheap enough to leave on
+    // The plain, array and nothrow forms are counted. The aligned forms of
+    // C++17 (std::align_val_t, used for types aligned beyond the default)
+    // are not replaced and go uncounted, as does anything allocated with
+    // malloc directly
+    uint64_t GetAllocationCount(void);
+
+    // Blocks allocated through operator new and not yet deleted
+    int64_t GetLiveAllocationCount(void);
+
+    // Memory of the process resident in RAM, in bytes; 0 where the platform does not say
+    uint64_t GetResidentBytes(void);
+
+    // Parts of the game allocations are charged to
+    enum AllocationTag {
+        TAG_UNTAGGED,
+        TAG_SIMULATION,
+        TAG_SPAWNING,
+        TAG_COLLISION,
+        TAG_SNAPSHOT,
+        TAG_RENDER,
+        TAG_HUD,
+        TAG_LOADING,
+        NUM_ALLOCATION_TAGS
+    };
+
+    const char *GetAllocationTagName(int tag);
+
+    // Tag that allocations on this thread are charged to
+    int GetAllocationTag(void);
+
+    // Charges allocations on this thread to a tag until the end of the enclosing block
+    class AllocationTagScope {
+
+        public:
+            AllocationTagScope(int tag);
+            ~AllocationTagScope();
+
+        private:
+            int previous_;
+
+    }; // class AllocationTagScope
+
+    // Allocations and bytes since the last CollectAllocations(), in total and by tag
+    struct AllocationFrame {
+        uint64_t count;
+        uint64_t bytes;
+        uint64_t tag_count[NUM_ALLOCATION_TAGS];
+        uint64_t tag_bytes[NUM_ALLOCATION_TAGS];
+    };
+
+    // Start tracking allocations by tag; off until called
+    // With call_sites set, the stack of every allocation is also taken so
+    // the places allocating most can be listed. That is slow, and only
+    // available where the platform can walk the stack
+    void EnableAllocationTracking(bool call_sites);
+    bool IsAllocationTracking(void);
+
+    // Take the allocations tracked since the last call and start over
+    void CollectAllocations(AllocationFrame &frame);
+
+    // Print the call sites that allocated the most bytes since tracking began
+    void PrintAllocationCallSites(int count);
+
+    // Limit on the allocations of a frame; zero leaves that figure unlimited
+    // Checked by CheckAllocationBudget(), which aborts over budget when
+    // abort_over_budget is set, so test runs fail on it
+    void SetAllocationBudget(uint64_t count, uint64_t bytes, bool abort_over_budget);
+
+    // Compare a frame against the budget; prints what went over and returns false if it did
+    bool CheckAllocationBudget(const AllocationFrame &frame, uint64_t frame_number);
+
+} // namespace game
+
+// Charge allocations to a tag until the end of the enclosing block
+#define ALLOCATION_TAG_JOIN2(a, b) a##b
+#define ALLOCATION_TAG_JOIN(a, b) ALLOCATION_TAG_JOIN2(a, b)
+#define ALLOCATION_TAG(tag) game::AllocationTagScope ALLOCATION_TAG_JOIN(allocation_tag_, __LINE__)(tag)
+
+#endif // MEMORY_STATS_H_
@@ -7,7 +7,7 @@
 namespace game {
 
     OrbitEnemy::OrbitEnemy(
-        Game* game, glm::vec3 position, Geometry* geom, Shader* shader, GLuint texture, EnemyGameObject* orbitObject)
+        Simulation* simulation, glm::vec3 position, Geometry* geom, Shader* shader, GLuint texture, EnemyGameObject* orbitObject)
         : EnemyGameObject(position, geom, shader, texture),
         orbitObject_(orbitObject),
         orbitRadius_(1.5f), // Set the initial orbit radius
@@ -15,7 +15,7 @@ namespace game {
         orbitAngle_(0.0f) // Start with an initial angle of 0
         
     {
-        game_ = game;
+        simulation_ = simulation;
         orbitObjectRotationSpeed_ = 3.0f * glm::pi<float>();
         speed = 2.5f;
     }
@@ -29,8 +29,16 @@ namespace game {
 
     }
 
+    void OrbitEnemy::ReleaseOrbitObject() {
+        orbitObject_ = nullptr;
+        state_ = INTERCEPTING_;
+    }
+
     void OrbitEnemy::UpdateOrbit(float delta_time) {
 
+        if (!orbitObject_) {
+            return;
+        }
         if (!orbitObject_->isOrbititnObject) {
             state_ = INTERCEPTING_;
         }
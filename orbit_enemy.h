@@ -2,17 +2,23 @@
 #define ORBIT_ENEMY_H
 
 #include "enemy_game_object.h"
-#include "game.h"
+#include "simulation.h"
 
 namespace game {
 
     class OrbitEnemy : public EnemyGameObject {
     public:
         OrbitEnemy(
-            Game* game, glm::vec3 position, Geometry* geom, Shader* shader, GLuint texture, EnemyGameObject* orbitObject);
+            Simulation* simulation, glm::vec3 position, Geometry* geom, Shader* shader, GLuint texture, EnemyGameObject* orbitObject);
 
         void Update(double delta_time) override;
 
+        // The blade circling this enemy, or nullptr once it is gone
+        EnemyGameObject* GetOrbitObject() const { return orbitObject_; }
+
+        // Let go of the blade before it is deleted; the enemy then chases the player
+        void ReleaseOrbitObject();
+
     private:
         EnemyGameObject* orbitObject_; // The object that will orbit the enemy
         float orbitRadius_; // The radius of the orbit
@@ -20,7 +26,7 @@ namespace game {
         float orbitAngle_; // Current angle of the orbiting object
         float orbitObjectRotationSpeed_;
 
-        Game* game_; // reference to game
+        Simulation* simulation_; // reference to simulation
 
         void UpdateOrbit(float delta_time);
     };
@@ -0,0 +1,74 @@
+#include <cmath>
+#include <cstdlib>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "particle_geometry.h"
+
+namespace game {
+
+void BuildParticleVertices(int num_particles, double spread, double speed, std::vector<GLfloat> &vertices, std::vector<GLuint> &faces)
+{
+    // Each particle is a square with four vertices and two triangles
+    const int vertex_attr = PARTICLE_VERTEX_ATTRIBUTES;
+
+    // Vertices
+    const GLfloat vertex[]  = {
+        // Four vertices of a square
+        // Position      Color                Texture coordinates
+        -0.5f,  0.5f,    1.0f, 0.0f, 0.0f,    0.0f, 0.0f, // Top-left
+         0.5f,  0.5f,    0.0f, 1.0f, 0.0f,    1.0f, 0.0f, // Top-right
+         0.5f, -0.5f,    0.0f, 0.0f, 1.0f,    1.0f, 1.0f, // Bottom-right
+        -0.5f, -0.5f,    1.0f, 1.0f, 1.0f,    0.0f, 1.0f  // Bottom-left
+    };
+
+    // Two triangles referencing the vertices
+    const GLuint face[] = {
+        0, 1, 2, // t1
+        2, 3, 0  // t2
+    };
+
+    // Initialize all the particle vertices
+    vertices.resize(num_particles * vertex_attr);
+    float theta, r, tmod;
+    float pi = glm::pi<float>();
+    float two_pi = 2.0f*pi;
+    float angle;
+
+    for (int i = 0; i < num_particles; i++){
+        // A particle has four vertices, so every four vertices we need
+        // to initialize new random values
+        if (i % 4 == 0){
+            theta = (spread*(rand() % 10000) / 10000.0f -1.0f)*0.33f + pi;
+            r = 0.0f + speed*(rand() % 10000) / 10000.0f;
+            tmod = (rand() % 10000) / 10000.0f;
+            angle = static_cast<float>(rand()) / RAND_MAX * two_pi; // Generate random angle
+        }
+
+        // Copy position from standard sprite, turned by the particle's angle
+        glm::vec2 rand_rotation = glm::vec2(vertex[(i % 4) * 7 + 0], vertex[(i % 4) * 7 + 1]);
+        vertices[i*vertex_attr + 0] = rand_rotation.x * cos(angle) - rand_rotation.y * sin(angle);
+        vertices[i*vertex_attr + 1] = rand_rotation.x * sin(angle) + rand_rotation.y * cos(angle);
+
+        // Set direction based on random values
+        vertices[i*vertex_attr + 2] = sin(theta)*r;
+        vertices[i*vertex_attr + 3] = cos(theta)*r;
+
+        // Set phase based on random values
+        vertices[i*vertex_attr + 4] = tmod;
+
+        // Copy texture coordinates from standard sprite
+        vertices[i*vertex_attr + 5] = vertex[(i % 4) * 7 + 5];
+        vertices[i*vertex_attr + 6] = vertex[(i % 4) * 7 + 6];
+    }
+
+    // Initialize all the particle faces
+    faces.resize(num_particles * 6);
+    for (int i = 0; i < num_particles; i++) {
+        for (int j = 0; j < 6; j++){
+            faces[i * 6 + j] = face[j] + i * 4;
+        }
+    }
+}
+
+} // namespace game
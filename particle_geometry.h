@@ -0,0 +1,22 @@
+#ifndef PARTICLE_GEOMETRY_H_
+#define PARTICLE_GEOMETRY_H_
+
+#include <vector>
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+namespace game {
+
+    // Attributes per particle vertex: position (2), direction (2), phase (1), texture coordinates (2)
+    const int PARTICLE_VERTEX_ATTRIBUTES = 7;
+
+    // Fill the vertex and index arrays of a particle effect
+    // Each particle is a randomly turned square flying off in a random
+    // direction: spread widens the cone of directions and speed scales how
+    // far they go. Runs on the CPU only, so the arrays can be built away
+    // from the GL thread and uploaded afterwards
+    void BuildParticleVertices(int num_particles, double spread, double speed, std::vector<GLfloat> &vertices, std::vector<GLuint> &faces);
+
+} // namespace game
+
+#endif // PARTICLE_GEOMETRY_H_
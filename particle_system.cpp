@@ -21,21 +21,7 @@ void ParticleSystem::Update(double delta_time) {
 }
 
 
-void ParticleSystem::Render(glm::mat4 view_matrix, double current_time){
-
-    // Enable depth testing
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-
-    // Enable blending for transparency
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    // Set up the shader
-    shader_->Enable();
-
-    // Set up the view matrix
-    shader_->SetUniformMat4("view_matrix", view_matrix);
+glm::mat4 ParticleSystem::GetTransformation(double current_time){
 
     // Setup the scaling matrix for the shader
     glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale_.x, scale_.y, 1.0));
@@ -61,27 +47,19 @@ void ParticleSystem::Render(glm::mat4 view_matrix, double current_time){
         transformation_matrix = parent_transformation_matrix * translation_matrix * rotation_matrix * scaling_matrix;
     }
     catch (int i) {
-        std::cout << "Error: ParticleSystem::Render: Could not get parent transformation matrix" << std::endl;
+        std::cout << "Error: ParticleSystem::GetTransformation: Could not get parent transformation matrix" << std::endl;
     }
 
-    // Set the transformation matrix in the shader
-    shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
-
-    // Set the time in the shader
-    shader_->SetUniform1f("time", current_time);
-
-    // Set up the geometry
-    geometry_->SetGeometry(shader_->GetShaderProgram());
+    return transformation_matrix;
+}
 
-    // Bind the particle texture
-    glBindTexture(GL_TEXTURE_2D, texture_);
 
-    // Draw the entity
-    glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+UniformBlock ParticleSystem::GetUniforms(double current_time){
 
-    // Disable blending and depth testing after rendering particles
-    glDisable(GL_BLEND);
-    glDisable(GL_DEPTH_TEST);
+    // The particle shader animates the particles over time
+    UniformBlock uniforms = GameObject::GetUniforms(current_time);
+    uniforms.animated = true;
+    return uniforms;
 }
 
 } // namespace game
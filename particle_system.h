@@ -13,7 +13,13 @@ namespace game {
 
             void Update(double delta_time) override;
 
-            void Render(glm::mat4 view_matrix, double current_time);
+            // Particles are placed relative to their parent
+            glm::mat4 GetTransformation(double current_time) override;
+
+            UniformBlock GetUniforms(double current_time) override;
+
+            // Particles move with their parent
+            glm::vec3 GetMotion(void) const override { return parent_ ? parent_->GetMotion() : glm::vec3(0.0f); }
 
         private:
             GameObject *parent_;
@@ -1,7 +1,9 @@
 #include <iostream>
 #include <string>
+#include <vector>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "particle_geometry.h"
 #include "particles.h"
 
 namespace game {
@@ -17,97 +19,33 @@ Particles::Particles(void) : Geometry()
 
 void Particles::CreateGeometry(void)
 {
-
-    // Each particle is a square with four vertices and two triangles
-
-    // Number of attributes for vertices and faces
-    const int vertex_attr = 7;  // 7 attributes per vertex: 2D (or 3D) position (2), direction (2), 2D texture coordinates (2), time (1)
-                                //    const int face_att = 3; // Vertex indices (3)
-
-    // Vertices
-    GLfloat vertex[]  = {
-        // Four vertices of a square
-        // Position      Color                Texture coordinates
-        -0.5f,  0.5f,    1.0f, 0.0f, 0.0f,    0.0f, 0.0f, // Top-left
-         0.5f,  0.5f,    0.0f, 1.0f, 0.0f,    1.0f, 0.0f, // Top-right
-         0.5f, -0.5f,    0.0f, 0.0f, 1.0f,    1.0f, 1.0f, // Bottom-right
-        -0.5f, -0.5f,    1.0f, 1.0f, 1.0f,    0.0f, 1.0f  // Bottom-left
-    };
-
-    // Two triangles referencing the vertices
-    GLuint face[] = {
-        0, 1, 2, // t1
-        2, 3, 0  // t2
-    };
-
-    // Initialize all the particle vertices
-    GLfloat particles[NUM_PARTICLES * vertex_attr];
-    float theta, r, tmod;
-    float pi = glm::pi<float>();
-    float two_pi = 2.0f*pi;
-    float angle;
-
-    for (int i = 0; i < NUM_PARTICLES; i++){
-        // Check if we are initializing a new particle
-        //
-        // A particle has four vertices, so every four vertices we need
-        // to initialize new random values
-        if (i % 4 == 0){
-            // Get three random values
-            //theta = (two_pi*(rand() % 1000) / 1000.0f);
-            theta = (200.0*(rand() % 10000) / 10000.0f -1.0f)*0.33f + pi;
-            r = 0.0f + 0.6*(rand() % 10000) / 10000.0f;
-            tmod = (rand() % 10000) / 10000.0f;
-            angle = static_cast<float>(rand()) / RAND_MAX * two_pi; // Generate random angle
-        }
-
-        // Copy position from standard sprite
-        glm::vec2 rand_rotation = glm::vec2(vertex[(i % 4) * 7 + 0], vertex[(i % 4) * 7 + 1]);
-        particles[i*vertex_attr + 0] = rand_rotation.x * cos(angle) - rand_rotation.y * sin(angle);
-        particles[i*vertex_attr + 1] = rand_rotation.x * sin(angle) + rand_rotation.y * cos(angle);
-
-
-        // Set direction based on random values
-        particles[i*vertex_attr + 2] = sin(theta)*r;
-        particles[i*vertex_attr + 3] = cos(theta)*r;
-
-        // Set phase based on random values
-        particles[i*vertex_attr + 4] = tmod;
-
-        // Copy texture coordinates from standard sprite
-        particles[i*vertex_attr + 5] = vertex[(i % 4) * 7 + 5];
-        particles[i*vertex_attr + 6] = vertex[(i % 4) * 7 + 6];
-
-    }
-
-    // Initialize all the particle faces
-    GLuint manyfaces[NUM_PARTICLES * 6];
-
-    for (int i = 0; i < NUM_PARTICLES; i++) {
-        for (int j = 0; j < 6; j++){
-            manyfaces[i * 6 + j] = face[j] + i * 4;
-        }
-    }
+    // Build the particles on the CPU, then upload them
+    std::vector<GLfloat> particles;
+    std::vector<GLuint> manyfaces;
+    BuildParticleVertices(NUM_PARTICLES, 200.0, 0.6, particles, manyfaces);
 
     // Create buffer for vertices
     glGenBuffers(1, &vbo_);
     glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(particles), particles, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, particles.size() * sizeof(GLfloat), particles.data(), GL_STATIC_DRAW);
 
     // Create buffer for faces (index buffer)
     glGenBuffers(1, &ebo_);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(manyfaces), manyfaces, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, manyfaces.size() * sizeof(GLuint), manyfaces.data(), GL_STATIC_DRAW);
 
     // Set number of elements in array buffer
-    size_ = sizeof(manyfaces) / sizeof(GLuint);
+    size_ = (int) manyfaces.size();
 }
 
 
 void Particles::SetGeometry(GLuint shader_program){
 
     // Set blending
-    glDisable(GL_DEPTH_TEST);
+    // Particles are hidden by nearer sprites but do not hide anything themselves
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_FALSE);
     glEnable(GL_BLEND);
     glBlendFunc(GL_ONE, GL_ONE);
 
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cstring>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "perf_overlay.h"
+
+namespace game {
+
+const int PerfOverlay::GRAPH_FRAMES;
+const int PerfOverlay::AVERAGE_FRAMES;
+
+// Layout, in HUD units
+// Figures on the left under the disc count, object lists on the right
+// under the coordinates, and the graph between them at the top
+static const glm::vec2 figures_position_g(-2.7f, 1.2f);
+static const glm::vec2 lists_position_g(1.3f, 1.2f);
+static const float row_height_g = 0.25f;
+static const float label_height_g = 0.14f;
+static const float number_offset_g = 0.75f;
+static const float icon_size_g = 0.2f;
+static const float digit_size_g = 0.16f;
+static const float digit_step_g = 0.12f;
+static const float graph_left_g = -1.0f;
+static const float graph_width_g = 2.0f;
+static const float graph_bottom_g = 1.3f;
+static const float graph_height_g = 0.8f;  // twice the budget
+
+
+PerfOverlay::PerfOverlay(const PerfOverlayTextures &textures, Geometry *sprite, Shader *shader, double budget)
+    : textures_(textures), sprite_(sprite), shader_(shader), budget_(budget)
+{
+    visible_ = false;
+    std::fill(graph_, graph_ + GRAPH_FRAMES, 0.0);
+    graph_next_ = 0;
+    memset(&sum_, 0, sizeof(sum_));
+    summed_ = 0;
+    std::fill(rows_, rows_ + NUM_OVERLAY_ROWS, 0);
+    std::fill(list_sizes_, list_sizes_ + NUM_OBJECT_LISTS, 0);
+}
+
+
+void PerfOverlay::AddFrame(const PerfFrame &frame)
+{
+    graph_[graph_next_] = frame.seconds;
+    graph_next_ = (graph_next_ + 1) % GRAPH_FRAMES;
+
+    sum_.seconds += frame.seconds;
+    sum_.gpu_seconds += frame.gpu_seconds;
+    sum_.draws += frame.draws;
+    sum_.state_changes += frame.state_changes;
+    sum_.allocations += frame.allocations;
+    summed_++;
+    if (summed_ < AVERAGE_FRAMES) {
+        return;
+    }
+
+    // Show the averages and start over
+    rows_[OVERLAY_FPS] = sum_.seconds > 0.0 ? (int) (summed_ / sum_.seconds + 0.5) : 0;
+    rows_[OVERLAY_FRAME_US] = (int) (sum_.seconds * 1e6 / summed_ + 0.5);
+    rows_[OVERLAY_GPU_US] = (int) (sum_.gpu_seconds * 1e6 / summed_ + 0.5);
+    rows_[OVERLAY_DRAWS] = (sum_.draws + summed_ / 2) / summed_;
+    rows_[OVERLAY_STATES] = (sum_.state_changes + summed_ / 2) / summed_;
+    rows_[OVERLAY_ALLOCATIONS] = (int) ((sum_.allocations + summed_ / 2) / summed_);
+    std::copy(frame.list_sizes, frame.list_sizes + NUM_OBJECT_LISTS, list_sizes_);
+    memset(&sum_, 0, sizeof(sum_));
+    summed_ = 0;
+}
+
+
+void PerfOverlay::AddQuad(DrawList &draw_list, GLuint texture, const glm::vec2 &position, const glm::vec2 &size) const
+{
+    UniformBlock uniforms;
+    uniforms.transformation = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(position, 0.0f)), glm::vec3(size, 1.0f));
+    uniforms.motion = glm::vec3(0.0f);
+    uniforms.time = 0.0f;
+    uniforms.ghost = false;
+    uniforms.gold = false;
+    uniforms.animated = false;
+    draw_list.Add(LAYER_HUD, 0.0f, sprite_, shader_, texture, uniforms);
+}
+
+
+void PerfOverlay::AddNumber(DrawList &draw_list, int value, glm::vec2 position) const
+{
+    char digits[16];
+    int length = 0;
+    unsigned int magnitude = value < 0 ? 0u : (unsigned int) value;
+    do {
+        digits[length++] = (char) (magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0 && length < 16);
+
+    for (int i = length - 1; i >= 0; i--) {
+        AddQuad(draw_list, textures_.digits[(int) digits[i]], position, glm::vec2(digit_size_g));
+        position.x += digit_step_g;
+    }
+}
+
+
+void PerfOverlay::Record(DrawList &draw_list) const
+{
+    // Figures with their labels
+    for (int row = 0; row < NUM_OVERLAY_ROWS; row++) {
+        glm::vec2 position = figures_position_g - glm::vec2(0.0f, row * row_height_g);
+        float label_width = label_height_g * textures_.label_aspect[row];
+        AddQuad(draw_list, textures_.labels[row], position + glm::vec2(0.5f * label_width, 0.0f), glm::vec2(label_width, label_height_g));
+        AddNumber(draw_list, rows_[row], position + glm::vec2(number_offset_g, 0.0f));
+    }
+
+    // Object lists with their icons
+    for (int list = 0; list < NUM_OBJECT_LISTS; list++) {
+        glm::vec2 position = lists_position_g - glm::vec2(0.0f, list * row_height_g);
+        AddQuad(draw_list, textures_.icons[list], position, glm::vec2(icon_size_g));
+        AddNumber(draw_list, list_sizes_[list], position + glm::vec2(0.25f, 0.0f));
+    }
+
+    // Frame time graph, oldest frame on the left; full height is twice the budget
+    float bar_width = graph_width_g / GRAPH_FRAMES;
+    for (int i = 0; i < GRAPH_FRAMES; i++) {
+        double seconds = graph_[(graph_next_ + i) % GRAPH_FRAMES];
+        if (seconds <= 0.0) {
+            continue;
+        }
+        float height = (float) std::min(1.0, seconds / (2.0 * budget_)) * graph_height_g;
+        glm::vec2 centre(graph_left_g + (i + 0.5f) * bar_width, graph_bottom_g + 0.5f * height);
+        AddQuad(draw_list, seconds > budget_ ? textures_.bar_over : textures_.bar, centre, glm::vec2(bar_width, height));
+    }
+    AddQuad(draw_list, textures_.budget_line, glm::vec2(graph_left_g + 0.5f * graph_width_g, graph_bottom_g + 0.5f * graph_height_g),
+            glm::vec2(graph_width_g, 0.01f));
+}
+
+} // namespace game
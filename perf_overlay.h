@@ -0,0 +1,104 @@
+#ifndef PERF_OVERLAY_H_
+#define PERF_OVERLAY_H_
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "geometry.h"
+#include "render_command_buffer.h"
+#include "render_snapshot.h"
+#include "shader.h"
+
+namespace game {
+
+    // Rows of figures the overlay shows, top to bottom
+    enum PerfOverlayRow {
+        OVERLAY_FPS,
+        OVERLAY_FRAME_US,    // frame time in microseconds
+        OVERLAY_GPU_US,      // GPU time of the frame in microseconds
+        OVERLAY_DRAWS,
+        OVERLAY_STATES,      // shader and texture changes
+        OVERLAY_ALLOCATIONS, // heap allocations per frame
+        NUM_OVERLAY_ROWS
+    };
+
+    // Textures the overlay is drawn with
+    struct PerfOverlayTextures {
+        GLuint digits[10];
+        GLuint labels[NUM_OVERLAY_ROWS];  // a word naming each row
+        float label_aspect[NUM_OVERLAY_ROWS]; // width over height of each label
+        GLuint icons[NUM_OBJECT_LISTS];   // a sprite standing for each object list
+        GLuint bar;                       // frame within budget
+        GLuint bar_over;                  // frame over budget
+        GLuint budget_line;
+    };
+
+    // Make the overlay's textures: labels and graph colours are generated,
+    // digits and icons are taken from the textures given; needs a GL context
+    PerfOverlayTextures MakePerfOverlayTextures(const GLuint digits[10], const GLuint icons[NUM_OBJECT_LISTS]);
+
+    // What was measured in one frame
+    struct PerfFrame {
+        double seconds;
+        double gpu_seconds;
+        int draws;
+        int state_changes;
+        uint64_t allocations;
+        int list_sizes[NUM_OBJECT_LISTS];
+    };
+
+    // Performance figures drawn over the game as part of the HUD
+    // Shows frame rate and times, draw calls, state changes and
+    // allocations, the size of each of the simulation's object lists, and
+    // a graph of recent frame times against the budget. Figures are
+    // averaged over a few frames so they can be read. The overlay records
+    // plain quads into the HUD's command buffer, where they are sorted and
+    // batched with the rest of the HUD; while hidden it only stores the
+    // frames it is given
+    class PerfOverlay {
+
+        public:
+            // Constructor; the geometry and shader are the HUD's
+            PerfOverlay(const PerfOverlayTextures &textures, Geometry *sprite, Shader *shader, double budget);
+
+            void Toggle(void) { visible_ = !visible_; }
+            bool IsVisible(void) const { return visible_; }
+
+            // Add the figures of a frame
+            void AddFrame(const PerfFrame &frame);
+
+            // Record the overlay into a HUD draw list
+            void Record(DrawList &draw_list) const;
+
+            // Frames in the graph, and frames each shown figure is averaged over
+            static const int GRAPH_FRAMES = 90;
+            static const int AVERAGE_FRAMES = 15;
+
+        private:
+            PerfOverlayTextures textures_;
+            Geometry *sprite_;
+            Shader *shader_;
+            double budget_;
+            bool visible_;
+
+            // Recent frame times for the graph, oldest first from graph_next_
+            double graph_[GRAPH_FRAMES];
+            int graph_next_;
+
+            // Sums over the frames averaged so far, and the figures shown
+            PerfFrame sum_;
+            int summed_;
+            int rows_[NUM_OVERLAY_ROWS];
+            int list_sizes_[NUM_OBJECT_LISTS];
+
+            // Record a quad centred at position with the given size
+            void AddQuad(DrawList &draw_list, GLuint texture, const glm::vec2 &position, const glm::vec2 &size) const;
+
+            // Record a number right after position, one digit quad per digit
+            void AddNumber(DrawList &draw_list, int value, glm::vec2 position) const;
+
+    }; // class PerfOverlay
+
+} // namespace game
+
+#endif // PERF_OVERLAY_H_
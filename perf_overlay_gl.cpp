@@ -0,0 +1,113 @@
+#include <cstring>
+#include <vector>
+
+#include "perf_overlay.h"
+
+namespace game {
+
+// Glyphs of a 3x5 pixel font, for the letters the labels use
+// Each row is three bits, the leftmost pixel in the highest bit
+struct Glyph {
+    char letter;
+    unsigned char rows[5];
+};
+
+static const Glyph glyphs_g[] = {
+    { 'A', { 2, 5, 7, 5, 5 } },
+    { 'C', { 3, 4, 4, 4, 3 } },
+    { 'D', { 6, 5, 5, 5, 6 } },
+    { 'E', { 7, 4, 6, 4, 7 } },
+    { 'F', { 7, 4, 6, 4, 4 } },
+    { 'G', { 3, 4, 5, 5, 3 } },
+    { 'L', { 4, 4, 4, 4, 7 } },
+    { 'M', { 5, 7, 7, 5, 5 } },
+    { 'O', { 2, 5, 5, 5, 2 } },
+    { 'P', { 6, 5, 6, 4, 4 } },
+    { 'R', { 6, 5, 6, 5, 5 } },
+    { 'S', { 3, 4, 2, 1, 6 } },
+    { 'T', { 7, 2, 2, 2, 2 } },
+    { 'U', { 5, 5, 5, 5, 7 } },
+    { 'W', { 5, 5, 7, 7, 5 } },
+};
+
+static const char *labels_g[NUM_OVERLAY_ROWS] = { "FPS", "FRAME US", "GPU US", "DRAWS", "STATES", "ALLOCS" };
+
+
+// Upload RGBA pixels as a texture with sharp pixels
+static GLuint MakeTexture(int width, int height, const std::vector<unsigned char> &pixels)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+
+// A single pixel of one colour
+static GLuint MakeColourTexture(unsigned char r, unsigned char g, unsigned char b)
+{
+    std::vector<unsigned char> pixel = { r, g, b, 255 };
+    return MakeTexture(1, 1, pixel);
+}
+
+
+// A word in the pixel font, white on transparent; aspect gets its width over height
+static GLuint MakeLabelTexture(const char *text, float &aspect)
+{
+    int length = (int) strlen(text);
+    int width = 4 * length - 1;
+    int height = 5;
+    std::vector<unsigned char> pixels(width * height * 4, 0);
+
+    for (int c = 0; c < length; c++) {
+        const Glyph *glyph = nullptr;
+        for (int g = 0; g < (int) (sizeof(glyphs_g) / sizeof(glyphs_g[0])); g++) {
+            if (glyphs_g[g].letter == text[c]) {
+                glyph = &glyphs_g[g];
+            }
+        }
+        if (!glyph) {
+            continue;
+        }
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < 3; x++) {
+                if (!(glyph->rows[y] & (4 >> x))) {
+                    continue;
+                }
+                // Texture rows go from the bottom up
+                unsigned char *pixel = &pixels[((height - 1 - y) * width + 4 * c + x) * 4];
+                pixel[0] = pixel[1] = pixel[2] = pixel[3] = 255;
+            }
+        }
+    }
+
+    aspect = (float) width / (float) height;
+    return MakeTexture(width, height, pixels);
+}
+
+
+PerfOverlayTextures MakePerfOverlayTextures(const GLuint digits[10], const GLuint icons[NUM_OBJECT_LISTS])
+{
+    PerfOverlayTextures textures;
+    for (int i = 0; i < 10; i++) {
+        textures.digits[i] = digits[i];
+    }
+    for (int i = 0; i < NUM_OBJECT_LISTS; i++) {
+        textures.icons[i] = icons[i];
+    }
+    for (int i = 0; i < NUM_OVERLAY_ROWS; i++) {
+        textures.labels[i] = MakeLabelTexture(labels_g[i], textures.label_aspect[i]);
+    }
+    textures.bar = MakeColourTexture(60, 200, 60);
+    textures.bar_over = MakeColourTexture(220, 40, 40);
+    textures.budget_line = MakeColourTexture(255, 255, 255);
+    return textures;
+}
+
+} // namespace game
@@ -0,0 +1,52 @@
+#include <cstring>
+#include <mutex>
+
+#include "profiler.h"
+
+namespace game {
+
+// Registered counters; entries are never removed, so pointers to them stay valid
+static ProfileCounter counters_g[MAX_PROFILE_COUNTERS];
+static std::atomic<int> num_counters_g(0);
+static std::mutex register_mutex_g;
+
+
+ProfileCounter *GetProfileCounter(const char *name)
+{
+    std::lock_guard<std::mutex> lock(register_mutex_g);
+    int count = num_counters_g.load();
+    for (int i = 0; i < count; i++) {
+        if (!strcmp(counters_g[i].name, name)) {
+            return &counters_g[i];
+        }
+    }
+    if (count == MAX_PROFILE_COUNTERS) {
+        return &counters_g[MAX_PROFILE_COUNTERS - 1];
+    }
+    counters_g[count].name = name;
+    counters_g[count].nanoseconds = 0;
+    counters_g[count].calls = 0;
+    num_counters_g.store(count + 1);
+    return &counters_g[count];
+}
+
+
+void CollectProfile(std::vector<ProfileSample> &samples)
+{
+    samples.clear();
+    int count = num_counters_g.load();
+    for (int i = 0; i < count; i++) {
+        int calls = counters_g[i].calls.exchange(0, std::memory_order_relaxed);
+        long long nanoseconds = counters_g[i].nanoseconds.exchange(0, std::memory_order_relaxed);
+        if (calls == 0 && nanoseconds == 0) {
+            continue;
+        }
+        ProfileSample sample;
+        sample.name = counters_g[i].name;
+        sample.seconds = nanoseconds * 1e-9;
+        sample.calls = calls;
+        samples.push_back(sample);
+    }
+}
+
+} // namespace game
@@ -3,14 +3,14 @@
 
 #include "enemy_game_object.h"
 #include "bullet_game_object.h"
-#include "game.h"
+#include "simulation.h"
 
 namespace game {
 
     class ProjectileShootingEnemy : public EnemyGameObject {
     public:
         ProjectileShootingEnemy(
-            Game* game, glm::vec3 position, Geometry* geom, Shader* shader, GLuint texture);
+            Simulation* simulation, glm::vec3 position, Geometry* geom, Shader* shader, GLuint texture, GLuint bullet_texture);
 
         void Update(double delta_time) override;
         void ShootProjectile(); // shots projectile 
@@ -18,11 +18,8 @@ namespace game {
     private:
         float shootCooldownTime_; // cooldown time
         float timeSinceLastShot_;
-        Game* game_; // game reference
+        Simulation* simulation_; // simulation reference
         GLuint bulletTex; // bullet texture
-
-        //load teture
-        void LoadTexture(GLuint& texture, const char* filepath);
     };
 
 } // namespace game
@@ -0,0 +1,121 @@
+// Benchmark of the spatial index against population
+// For each population the objects are spread at a fixed density, the
+// index is built, and random queries of each kind are timed. A linear scan
+// over every object, as the bomb blasts used to do, is timed alongside
+//
+// Usage: query_benchmark [queries]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "spatial_index.h"
+
+using namespace game;
+
+// Objects per square unit
+static const float density_g = 0.25f;
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static float Random(float low, float high)
+{
+    return low + (high - low) * (float) rand() / (float) RAND_MAX;
+}
+
+
+int main(int argc, char **argv)
+{
+    int num_queries = argc > 1 ? atoi(argv[1]) : 2000;
+    if (num_queries <= 0) {
+        fprintf(stderr, "usage: query_benchmark [queries]\n");
+        return 1;
+    }
+
+    static const int populations[] = { 100, 1000, 10000, 100000 };
+    static const int kinds[] = { COLLIDER_ENEMY, COLLIDER_ORBIT_ENEMY, COLLIDER_FRIENDLY_BULLET, COLLIDER_BONE };
+
+    printf("%d queries per test, times in microseconds per call\n\n", num_queries);
+    printf("%10s %10s %12s %12s %12s %12s %12s\n", "objects", "build", "radius 2", "radius 5", "box 10x10", "nearest", "scan r 5");
+
+    srand(2501);
+    SpatialIndex index;
+    std::vector<QueryHit> hits;
+    for (int p = 0; p < (int) (sizeof(populations) / sizeof(populations[0])); p++) {
+        int count = populations[p];
+        float half = 0.5f * std::sqrt(count / density_g);
+
+        std::vector<CollisionProxy> proxies(count);
+        for (int i = 0; i < count; i++) {
+            proxies[i].object = nullptr;
+            proxies[i].position = glm::vec2(Random(-half, half), Random(-half, half));
+            proxies[i].kind = kinds[i % 4];
+            proxies[i].collidable = true;
+        }
+        std::vector<glm::vec2> points(num_queries);
+        for (int i = 0; i < num_queries; i++) {
+            points[i] = glm::vec2(Random(-half, half), Random(-half, half));
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        index.Build(proxies);
+        double build = Seconds(start);
+
+        // Total hits are printed so the work cannot be optimized away
+        long long found = 0;
+        double times[5];
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_queries; i++) {
+            index.QueryRadius(points[i], 2.0f, QUERY_ENEMIES, hits);
+            found += hits.size();
+        }
+        times[0] = Seconds(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_queries; i++) {
+            index.QueryRadius(points[i], 5.0f, QUERY_ENEMIES, hits);
+            found += hits.size();
+        }
+        times[1] = Seconds(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_queries; i++) {
+            index.QueryAABB(points[i] - glm::vec2(5.0f), points[i] + glm::vec2(5.0f), QUERY_ALL, hits);
+            found += hits.size();
+        }
+        times[2] = Seconds(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_queries; i++) {
+            QueryHit hit;
+            found += index.QueryNearest(points[i], 20.0f, QueryMask(COLLIDER_BONE), hit) ? 1 : 0;
+        }
+        times[3] = Seconds(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_queries; i++) {
+            for (int j = 0; j < count; j++) {
+                if (!(QUERY_ENEMIES & QueryMask(proxies[j].kind))) {
+                    continue;
+                }
+                glm::vec2 offset = proxies[j].position - points[i];
+                found += glm::dot(offset, offset) <= 25.0f ? 1 : 0;
+            }
+        }
+        times[4] = Seconds(start);
+
+        printf("%10d %10.1f", count, build * 1e6);
+        for (int i = 0; i < 5; i++) {
+            printf(" %12.3f", times[i] * 1e6 / num_queries);
+        }
+        printf("   (%lld hits)\n", found);
+    }
+
+    return 0;
+}
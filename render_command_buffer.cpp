@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cstring>
+
+#include "render_command_buffer.h"
+
+namespace game {
+
+void DrawList::Add(int layer, float depth, Geometry *geometry, Shader *shader, GLuint texture, const UniformBlock &uniforms)
+{
+    DrawRequest request;
+    request.key = RenderCommandBuffer::MakeKey(layer, shader, texture, depth);
+    request.order = order_;
+    request.geometry = geometry;
+    request.shader = shader;
+    request.texture = texture;
+    request.uniforms = uniforms;
+    requests_.push_back(request);
+}
+
+
+void RenderCommandBuffer::Reset(int num_threads)
+{
+    if ((int) draw_lists_.size() < num_threads) {
+        draw_lists_.resize(num_threads);
+    }
+    for (int i = 0; i < (int) draw_lists_.size(); i++) {
+        draw_lists_[i].Clear();
+    }
+    requests_.clear();
+    commands_.clear();
+    uniforms_.clear();
+    for (int i = 0; i <= NUM_RENDER_LAYERS; i++) {
+        layer_begin_[i] = 0;
+    }
+    num_draws_ = 0;
+    num_pipeline_changes_ = 0;
+    num_texture_binds_ = 0;
+}
+
+
+uint64_t RenderCommandBuffer::MakeKey(int layer, const Shader *shader, GLuint texture, float depth)
+{
+    // Map the depth to an unsigned integer that sorts the same way as the float
+    uint32_t depth_bits;
+    std::memcpy(&depth_bits, &depth, sizeof(depth_bits));
+    depth_bits = (depth_bits & 0x80000000u) ? ~depth_bits : (depth_bits | 0x80000000u);
+
+    // Smaller depths are nearer: opaque draws go nearest first, blended
+    // draws farthest first
+    if (IsBlendedLayer(layer)) {
+        depth_bits = ~depth_bits;
+    }
+
+    // | layer: 8 | shader: 8 | texture: 16 | depth: 32 |
+    // OpenGL names are small integers, so the low bits are enough to group
+    // draws by shader and texture
+    // Headless runs have no shaders and record draws without one
+    GLuint program = shader ? shader->GetShaderProgram() : 0;
+    uint64_t key = 0;
+    key |= (uint64_t) (layer & 0xFF) << 56;
+    key |= (uint64_t) (program & 0xFF) << 48;
+    key |= (uint64_t) (texture & 0xFFFF) << 32;
+    key |= (uint64_t) depth_bits;
+    return key;
+}
+
+
+void RenderCommandBuffer::Compile(void)
+{
+    // Merge the per-thread lists
+    for (int i = 0; i < (int) draw_lists_.size(); i++) {
+        const std::vector<DrawRequest> &requests = draw_lists_[i].GetRequests();
+        requests_.insert(requests_.end(), requests.begin(), requests.end());
+    }
+
+    std::sort(requests_.begin(), requests_.end(), [](const DrawRequest &x, const DrawRequest &y) {
+        if (x.key != y.key) return x.key < y.key;
+        return x.order < y.order;
+    });
+
+    // Turn the draws into commands, only changing state when it differs
+    // State is set again at the start of each layer, so any range of layers
+    // can be submitted on its own
+    const Shader *shader = nullptr;
+    GLuint texture = 0;
+    bool texture_bound = false;
+    int layer = -1;
+    for (int i = 0; i < (int) requests_.size(); i++) {
+        const DrawRequest &request = requests_[i];
+        RenderCommand command;
+
+        int request_layer = (int) (request.key >> 56);
+        while (layer < request_layer) {
+            layer++;
+            layer_begin_[layer] = (int) commands_.size();
+            shader = nullptr;
+            texture_bound = false;
+        }
+
+        if (request.shader != shader) {
+            command.type = COMMAND_SET_PIPELINE;
+            command.index = 0;
+            command.pointer = request.shader;
+            commands_.push_back(command);
+            shader = request.shader;
+            num_pipeline_changes_++;
+        }
+
+        if (!texture_bound || request.texture != texture) {
+            command.type = COMMAND_BIND_TEXTURE;
+            command.index = request.texture;
+            command.pointer = nullptr;
+            commands_.push_back(command);
+            texture = request.texture;
+            texture_bound = true;
+            num_texture_binds_++;
+        }
+
+        command.type = COMMAND_SET_UNIFORMS;
+        command.index = (unsigned int) uniforms_.size();
+        command.pointer = nullptr;
+        commands_.push_back(command);
+        uniforms_.push_back(request.uniforms);
+
+        command.type = COMMAND_DRAW;
+        command.index = 0;
+        command.pointer = request.geometry;
+        commands_.push_back(command);
+        num_draws_++;
+    }
+    while (layer < NUM_RENDER_LAYERS) {
+        layer++;
+        layer_begin_[layer] = (int) commands_.size();
+    }
+}
+
+} // namespace game
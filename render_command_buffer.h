@@ -0,0 +1,151 @@
+#ifndef RENDER_COMMAND_BUFFER_H_
+#define RENDER_COMMAND_BUFFER_H_
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#include "geometry.h"
+#include "shader.h"
+
+namespace game {
+
+    // Layers are drawn in the order they are listed here
+    // Opaque layers come first, nearest to farthest, so the depth test can
+    // reject hidden fragments before they are shaded; blended layers come
+    // last so they are composited over everything opaque
+    enum RenderLayer {
+        LAYER_HUD,        // screen space elements, drawn from their own buffer
+        LAYER_FOREGROUND, // opaque sprites above the ground objects: player, discs, bombs
+        LAYER_WORLD,      // opaque sprites on the ground: enemies, bullets, pickups, explosions
+        LAYER_GROUND,     // the ground tiles
+        LAYER_EFFECTS,    // blended particle effects
+        NUM_RENDER_LAYERS
+    };
+
+    // Depth of the ground, behind every sprite
+    const float GROUND_DEPTH = 0.5f;
+
+    // Depth of particle effects, between the ground objects (0) and the foreground (-1)
+    const float EFFECTS_DEPTH = -0.5f;
+
+    // True for layers that are alpha blended and drawn back-to-front
+    inline bool IsBlendedLayer(int layer) { return layer == LAYER_EFFECTS; }
+
+    // Kinds of commands in a compiled command buffer
+    enum RenderCommandType {
+        COMMAND_SET_PIPELINE, // enable a shader program and set its view matrix
+        COMMAND_BIND_TEXTURE, // bind a texture
+        COMMAND_SET_UNIFORMS, // set the per-draw uniforms from a uniform block
+        COMMAND_DRAW          // set up the geometry if needed and draw it
+    };
+
+    // Per-draw shader uniforms
+    struct UniformBlock {
+        glm::mat4 transformation;
+        glm::vec3 motion; // distance moved during the last tick, for interpolation
+        float time;
+        bool ghost;
+        bool gold;
+        bool animated; // shader needs the "time" uniform
+    };
+
+    // A draw recorded by a game object, before sorting
+    struct DrawRequest {
+        uint64_t key;
+        unsigned int order;
+        Geometry *geometry;
+        Shader *shader;
+        GLuint texture;
+        UniformBlock uniforms;
+    };
+
+    // A single compiled command
+    // pointer holds the Shader or Geometry, index the texture or uniform block
+    struct RenderCommand {
+        int type;
+        unsigned int index;
+        const void *pointer;
+    };
+
+    // Collects the draws of one thread
+    // Game objects record into a DrawList instead of calling OpenGL, so
+    // recording can run on any thread
+    class DrawList {
+
+        public:
+            // Order of the draws that follow among draws with equal keys
+            // Keeps the result independent of which thread recorded what
+            void SetOrder(unsigned int order) { order_ = order; }
+
+            // Record a draw in the given layer at the given depth
+            void Add(int layer, float depth, Geometry *geometry, Shader *shader, GLuint texture, const UniformBlock &uniforms);
+
+            void Clear(void) { requests_.clear(); }
+            const std::vector<DrawRequest> &GetRequests(void) const { return requests_; }
+
+        private:
+            unsigned int order_ = 0;
+            std::vector<DrawRequest> requests_;
+
+    }; // class DrawList
+
+    // A list of render commands built off the GL thread and submitted on it
+    // Draws are recorded into per-thread draw lists, then Compile() sorts
+    // them by a 64-bit key made of layer, shader, texture and depth and
+    // turns them into commands, leaving out state that is already set.
+    // Submit() then runs the commands on the GL thread in a single pass.
+    // Within a layer, shader and texture, opaque draws go front-to-back and
+    // blended draws back-to-front
+    class RenderCommandBuffer {
+
+        public:
+            // Throw away the previous frame and prepare one draw list per thread
+            void Reset(int num_threads);
+
+            // Draw list for the given thread
+            DrawList &GetDrawList(int thread_index) { return draw_lists_[thread_index]; }
+
+            // Sort the recorded draws and build the commands
+            void Compile(void);
+
+            // Run the commands of the given range of layers
+            // Draws are placed blend of the way through their last tick's
+            // motion, so 1 draws them where the tick left them
+            // Must be called on the thread that owns the GL context. Lives in
+            // render_command_submit.cpp, apart from the recording, so code
+            // that only records does not need OpenGL
+            void Submit(const glm::mat4 &view_matrix, int first_layer = 0, int last_layer = NUM_RENDER_LAYERS - 1, float blend = 1.0f) const;
+
+            // Build the sort key of a draw
+            static uint64_t MakeKey(int layer, const Shader *shader, GLuint texture, float depth);
+
+            // Statistics of the compiled commands
+            int GetNumDraws(void) const { return num_draws_; }
+            int GetNumPipelineChanges(void) const { return num_pipeline_changes_; }
+            int GetNumTextureBinds(void) const { return num_texture_binds_; }
+
+        private:
+            std::vector<DrawList> draw_lists_;
+
+            // All requests of the frame, merged and sorted
+            std::vector<DrawRequest> requests_;
+
+            // Compiled commands and the uniform blocks they refer to
+            std::vector<RenderCommand> commands_;
+            std::vector<UniformBlock> uniforms_;
+
+            // Index of the first command of each layer, plus the end
+            int layer_begin_[NUM_RENDER_LAYERS + 1] = {};
+
+            int num_draws_ = 0;
+            int num_pipeline_changes_ = 0;
+            int num_texture_binds_ = 0;
+
+    }; // class RenderCommandBuffer
+
+} // namespace game
+
+#endif // RENDER_COMMAND_BUFFER_H_
@@ -0,0 +1,50 @@
+#include "render_command_buffer.h"
+
+namespace game {
+
+void RenderCommandBuffer::Submit(const glm::mat4 &view_matrix, int first_layer, int last_layer, float blend) const
+{
+    Shader *shader = nullptr;
+    Geometry *geometry = nullptr;
+
+    for (int i = layer_begin_[first_layer]; i < layer_begin_[last_layer + 1]; i++) {
+        const RenderCommand &command = commands_[i];
+
+        switch (command.type) {
+            case COMMAND_SET_PIPELINE:
+                shader = (Shader *) command.pointer;
+                shader->Enable();
+                shader->SetUniformMat4("view_matrix", view_matrix);
+                // Vertex attributes are looked up per program
+                geometry = nullptr;
+                break;
+
+            case COMMAND_BIND_TEXTURE:
+                glBindTexture(GL_TEXTURE_2D, command.index);
+                break;
+
+            case COMMAND_SET_UNIFORMS: {
+                const UniformBlock &uniforms = uniforms_[command.index];
+                glm::mat4 transformation = uniforms.transformation;
+                transformation[3] = transformation[3] - glm::vec4(uniforms.motion * (1.0f - blend), 0.0f);
+                shader->SetUniformMat4("transformation_matrix", transformation);
+                shader->SetUniform1i("ghost", uniforms.ghost ? 1 : 0);
+                shader->SetUniform1i("gold", uniforms.gold ? 1 : 0);
+                if (uniforms.animated) {
+                    shader->SetUniform1f("time", uniforms.time);
+                }
+                break;
+            }
+
+            case COMMAND_DRAW:
+                if (command.pointer != geometry) {
+                    geometry = (Geometry *) command.pointer;
+                    geometry->SetGeometry(shader->GetShaderProgram());
+                }
+                glDrawElements(GL_TRIANGLES, geometry->GetSize(), GL_UNSIGNED_INT, 0);
+                break;
+        }
+    }
+}
+
+} // namespace game
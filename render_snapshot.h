@@ -0,0 +1,57 @@
+#ifndef RENDER_SNAPSHOT_H_
+#define RENDER_SNAPSHOT_H_
+
+#include <glm/glm.hpp>
+
+#include "render_command_buffer.h"
+
+namespace game {
+
+    // Values shown on the HUD
+    struct HudState {
+        int score;
+        int health;
+        int collectibles;
+        bool invincible;
+        float invincibility_time_left;
+        glm::vec2 coordinates;
+        int discs;
+    };
+
+    // The simulation's lists of objects, for counting what is alive
+    enum ObjectList {
+        LIST_GAME_OBJECTS,
+        LIST_BULLETS,
+        LIST_COLLECTIBLES,
+        LIST_POTIONS,
+        LIST_DISCS,
+        LIST_BOMBS,
+        LIST_EXPLOSIONS,
+        NUM_OBJECT_LISTS
+    };
+
+    // An immutable copy of the game world at the end of a simulation tick
+    // Built by the simulation thread and drawn by the render thread
+    struct RenderSnapshot {
+        // Simulation time the snapshot was taken at
+        double time;
+
+        // Wall clock time the snapshot was handed to the render thread
+        double publish_time;
+
+        // Point the camera follows, and how far it moved during the tick
+        glm::vec3 camera_position;
+        glm::vec3 camera_motion;
+
+        // Commands that draw the game world, sorted and ready to submit
+        RenderCommandBuffer commands;
+
+        HudState hud;
+
+        // Number of objects in each ObjectList
+        int list_sizes[NUM_OBJECT_LISTS];
+    };
+
+} // namespace game
+
+#endif // RENDER_SNAPSHOT_H_
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "scenario.h"
+
+namespace game {
+
+static const char *object_names_g[NUM_SCENARIO_OBJECTS] = {
+    "enemy", "shooter", "orbit_pair", "bullet", "enemy_bullet", "bomb", "bone", "potion"
+};
+
+
+const char *GetScenarioObjectName(int object)
+{
+    return object >= 0 && object < NUM_SCENARIO_OBJECTS ? object_names_g[object] : "unknown";
+}
+
+
+// Read "on" or "off"
+static bool ReadSwitch(std::istringstream &line, bool &value)
+{
+    std::string word;
+    line >> word;
+    if (word == "on" || word == "off") {
+        value = word == "on";
+        return true;
+    }
+    return false;
+}
+
+
+bool LoadScenario(const std::string &path, Scenario &scenario, std::string &error)
+{
+    std::ifstream file(path);
+    if (!file) {
+        error = "could not open " + path;
+        return false;
+    }
+
+    scenario = Scenario();
+    scenario.name = "scenario";
+    scenario.seed = 2501;
+    scenario.start_population = 100;
+    scenario.end_population = 100000;
+    scenario.steps = 7;
+    scenario.seconds_per_step = 5.0;
+    scenario.spawning = false;
+    scenario.invulnerable = true;
+
+    std::string text;
+    for (int line_number = 1; std::getline(file, text); line_number++) {
+        text = text.substr(0, text.find('#'));
+        std::istringstream line(text);
+        std::string key;
+        if (!(line >> key)) {
+            continue;
+        }
+
+        bool ok = true;
+        if (key == "name") {
+            ok = (bool) (line >> scenario.name);
+        }
+        else if (key == "seed") {
+            ok = (bool) (line >> scenario.seed);
+        }
+        else if (key == "ramp") {
+            ok = line >> scenario.start_population >> scenario.end_population >> scenario.steps >> scenario.seconds_per_step &&
+                 scenario.start_population > 0 && scenario.end_population > 0 &&
+                 scenario.steps > 0 && scenario.seconds_per_step > 0.0;
+        }
+        else if (key == "spawning") {
+            ok = ReadSwitch(line, scenario.spawning);
+        }
+        else if (key == "invulnerable") {
+            ok = ReadSwitch(line, scenario.invulnerable);
+        }
+        else if (key == "obstacle") {
+            ScenarioObstacle obstacle;
+            ok = line >> obstacle.centre.x >> obstacle.centre.y >> obstacle.half_size.x >> obstacle.half_size.y &&
+                 obstacle.half_size.x > 0.0f && obstacle.half_size.y > 0.0f;
+            scenario.obstacles.push_back(obstacle);
+        }
+        else {
+            ScenarioGroup group = ScenarioGroup();
+            group.object = (int) (std::find(object_names_g, object_names_g + NUM_SCENARIO_OBJECTS, key) - object_names_g);
+            if (group.object == NUM_SCENARIO_OBJECTS) {
+                error = path + ":" + std::to_string(line_number) + ": unknown setting '" + key + "'";
+                return false;
+            }
+
+            std::string distribution;
+            ok = line >> group.share >> distribution && group.share >= 0.0f;
+            if (ok && distribution == "uniform") {
+                group.distribution = DISTRIBUTION_UNIFORM;
+                ok = line >> group.outer && group.outer > 0.0f;
+            }
+            else if (ok && distribution == "disc") {
+                group.distribution = DISTRIBUTION_DISC;
+                ok = line >> group.outer && group.outer > 0.0f;
+            }
+            else if (ok && distribution == "ring") {
+                group.distribution = DISTRIBUTION_RING;
+                ok = line >> group.inner >> group.outer && group.inner >= 0.0f && group.outer > group.inner;
+            }
+            else if (ok && distribution == "clusters") {
+                group.distribution = DISTRIBUTION_CLUSTERS;
+                ok = line >> group.clusters >> group.inner >> group.outer &&
+                     group.clusters > 0 && group.inner > 0.0f && group.outer >= 0.0f;
+            }
+            else {
+                ok = false;
+            }
+            scenario.groups.push_back(group);
+        }
+
+        if (!ok) {
+            error = path + ":" + std::to_string(line_number) + ": bad value for '" + key + "'";
+            return false;
+        }
+    }
+
+    if (scenario.groups.empty()) {
+        error = path + ": no objects to place";
+        return false;
+    }
+    return true;
+}
+
+
+int GetScenarioPopulation(const Scenario &scenario, int step)
+{
+    if (scenario.steps <= 1) {
+        return scenario.end_population;
+    }
+    double t = (double) step / (double) (scenario.steps - 1);
+    double population = scenario.start_population * std::pow((double) scenario.end_population / scenario.start_population, t);
+    return (int) std::floor(population + 0.5);
+}
+
+
+void GetScenarioCounts(const Scenario &scenario, int population, std::vector<int> &counts)
+{
+    int num_groups = (int) scenario.groups.size();
+    counts.assign(num_groups, 0);
+
+    float total_share = 0.0f;
+    for (int i = 0; i < num_groups; i++) {
+        total_share += scenario.groups[i].share;
+    }
+    if (total_share <= 0.0f) {
+        return;
+    }
+
+    // Whole parts first, then what is left over goes to the groups with
+    // the largest remainders, earlier groups winning ties
+    std::vector<std::pair<double, int> > remainders(num_groups);
+    int placed = 0;
+    for (int i = 0; i < num_groups; i++) {
+        double exact = (double) population * scenario.groups[i].share / total_share;
+        counts[i] = (int) exact;
+        placed += counts[i];
+        remainders[i] = std::make_pair(-(exact - counts[i]), i);
+    }
+    std::sort(remainders.begin(), remainders.end());
+    for (int i = 0; placed < population; i = (i + 1) % num_groups) {
+        counts[remainders[i].second]++;
+        placed++;
+    }
+}
+
+
+static float Random(float low, float high)
+{
+    return low + (high - low) * (float) rand() / (float) RAND_MAX;
+}
+
+
+// Random point in a disc, spread evenly over its area
+static glm::vec2 RandomInDisc(float inner, float outer)
+{
+    float angle = Random(0.0f, 6.2831853f);
+    float radius = std::sqrt(Random(inner * inner, outer * outer));
+    return glm::vec2(std::cos(angle), std::sin(angle)) * radius;
+}
+
+
+glm::vec2 PickScenarioOffset(const ScenarioGroup &group)
+{
+    switch (group.distribution) {
+        case DISTRIBUTION_UNIFORM:
+            return glm::vec2(Random(-group.outer, group.outer), Random(-group.outer, group.outer));
+
+        case DISTRIBUTION_DISC:
+            return RandomInDisc(0.0f, group.outer);
+
+        case DISTRIBUTION_RING:
+            return RandomInDisc(group.inner, group.outer);
+
+        default: {
+            // Cluster centres sit on a sunflower spiral filling the disc,
+            // so they are the same for every run and evenly spaced
+            int cluster = rand() % group.clusters;
+            float angle = cluster * 2.3999632f;
+            float radius = group.outer * std::sqrt((cluster + 0.5f) / group.clusters);
+            glm::vec2 centre = glm::vec2(std::cos(angle), std::sin(angle)) * radius;
+            return centre + RandomInDisc(0.0f, group.inner);
+        }
+    }
+}
+
+} // namespace game
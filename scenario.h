@@ -0,0 +1,98 @@
+#ifndef SCENARIO_H_
+#define SCENARIO_H_
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace game {
+
+    // Kinds of object a scenario places
+    enum ScenarioObject {
+        SCENARIO_ENEMY,        // chasing enemy
+        SCENARIO_SHOOTER,      // projectile shooting enemy
+        SCENARIO_ORBIT_PAIR,   // orbit enemy and its blade; two objects
+        SCENARIO_BULLET,       // player bullet in flight
+        SCENARIO_ENEMY_BULLET, // enemy bullet in flight
+        SCENARIO_BOMB,
+        SCENARIO_BONE,
+        SCENARIO_POTION,
+        NUM_SCENARIO_OBJECTS
+    };
+
+    // How the objects of a group are spread around the player
+    enum ScenarioDistribution {
+        DISTRIBUTION_UNIFORM,  // square of half size outer
+        DISTRIBUTION_DISC,     // disc of radius outer
+        DISTRIBUTION_RING,     // between radius inner and outer
+        DISTRIBUTION_CLUSTERS  // clusters of radius inner, their centres within outer
+    };
+
+    // Objects of one kind and how they are placed
+    struct ScenarioGroup {
+        int object;       // one of ScenarioObject
+        float share;      // part of the population, relative to the other groups
+        int distribution; // one of ScenarioDistribution
+        float inner;
+        float outer;
+        int clusters;     // number of clusters, for DISTRIBUTION_CLUSTERS
+    };
+
+    // A rectangle of cells the chasing enemies must path around
+    struct ScenarioObstacle {
+        glm::vec2 centre;    // relative to the player
+        glm::vec2 half_size;
+    };
+
+    // A load test: what to place and how the population grows
+    // The population steps geometrically from start to end, holding each
+    // step for a number of seconds, and is shared between the groups
+    struct Scenario {
+        std::string name;
+        unsigned int seed;
+        std::vector<ScenarioGroup> groups;
+        std::vector<ScenarioObstacle> obstacles;
+
+        int start_population;
+        int end_population;
+        int steps;
+        double seconds_per_step;
+
+        bool spawning;     // keep the spawn director running alongside
+        bool invulnerable; // nothing hurts the player, so the run is not cut short
+    };
+
+    // Read a scenario file; on failure returns false and describes the problem in error
+    // The file has one setting per line, with # starting a comment:
+    //   name <word>
+    //   seed <number>
+    //   ramp <start population> <end population> <steps> <seconds per step>
+    //   spawning on|off
+    //   invulnerable on|off
+    //   <object> <share> uniform <half size>
+    //   <object> <share> disc <radius>
+    //   <object> <share> ring <inner radius> <outer radius>
+    //   <object> <share> clusters <count> <cluster radius> <radius>
+    //   obstacle <x> <y> <half width> <half height>
+    // where object is enemy, shooter, orbit_pair, bullet, enemy_bullet,
+    // bomb, bone or potion. Obstacles are placed around the player when
+    // the run starts and block the flow field the chasers follow
+    bool LoadScenario(const std::string &path, Scenario &scenario, std::string &error);
+
+    // Name of a ScenarioObject as written in scenario files
+    const char *GetScenarioObjectName(int object);
+
+    // Population at a step of the ramp
+    int GetScenarioPopulation(const Scenario &scenario, int step);
+
+    // Number of objects of each group at the given population
+    // Rounded so the counts add up to the population exactly
+    void GetScenarioCounts(const Scenario &scenario, int population, std::vector<int> &counts);
+
+    // Random place for an object of the group, relative to the player
+    // Uses rand(), so the placement follows the seed given to srand()
+    glm::vec2 PickScenarioOffset(const ScenarioGroup &group);
+
+} // namespace game
+
+#endif // SCENARIO_H_
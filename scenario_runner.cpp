@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "scenario_runner.h"
+
+namespace game {
+
+constexpr double ScenarioRunner::SETTLE_TIME;
+
+
+ScenarioRunner::ScenarioRunner(const Scenario &scenario)
+    : scenario_(scenario)
+{
+    step_ = -1;
+    step_time_ = 0.0;
+    field_builds_ = 0;
+}
+
+
+void ScenarioRunner::Update(Simulation &simulation, double delta_time)
+{
+    if (IsFinished()) {
+        return;
+    }
+
+    if (step_ < 0) {
+        simulation.SetSpawning(scenario_.spawning);
+        simulation.SetInvulnerable(scenario_.invulnerable);
+        for (int i = 0; i < (int) scenario_.obstacles.size(); i++) {
+            simulation.PlaceScenarioObstacle(scenario_.obstacles[i]);
+        }
+        field_builds_ = simulation.GetFlowField().GetNumBuilds();
+        srand(scenario_.seed);
+        step_ = 0;
+    }
+    else {
+        // Half a tick of slack, so rounding in the sum of ticks cannot
+        // push the end of a step one tick late
+        step_time_ += delta_time;
+        if (step_time_ < scenario_.seconds_per_step - 0.5 * delta_time) {
+            return;
+        }
+        FinishStep(simulation);
+        step_++;
+        step_time_ = 0.0;
+        if (IsFinished()) {
+            return;
+        }
+    }
+
+    // Top up every kind of object to its share of the new population
+    // Groups placing the same kind split what is missing by their counts
+    GetScenarioCounts(scenario_, GetScenarioPopulation(scenario_, step_), counts_);
+    for (int object = 0; object < NUM_SCENARIO_OBJECTS; object++) {
+        int wanted = 0;
+        for (int i = 0; i < (int) scenario_.groups.size(); i++) {
+            wanted += scenario_.groups[i].object == object ? counts_[i] : 0;
+        }
+        int missing = wanted - simulation.CountScenarioObjects(object);
+        for (int i = 0; i < (int) scenario_.groups.size() && missing > 0; i++) {
+            if (scenario_.groups[i].object != object) {
+                continue;
+            }
+            // The last group of the kind takes whatever is left
+            int count = wanted == counts_[i] ? missing : (int) ((long long) missing * counts_[i] / wanted);
+            simulation.PlaceScenarioObjects(scenario_.groups[i], count);
+            missing -= count;
+            wanted -= counts_[i];
+        }
+    }
+}
+
+
+void ScenarioRunner::ReportTick(double seconds)
+{
+    if (step_ >= 0 && !IsFinished() && step_time_ >= SETTLE_TIME) {
+        tick_times_.push_back(seconds);
+    }
+}
+
+
+void ScenarioRunner::FinishStep(const Simulation &simulation)
+{
+    RampStep step = RampStep();
+    step.population = GetScenarioPopulation(scenario_, step_);
+    step.objects = simulation.GetNumObjects();
+    step.ticks = (int) tick_times_.size();
+    step.field_builds = simulation.GetFlowField().GetNumBuilds() - field_builds_;
+    field_builds_ += step.field_builds;
+    if (!tick_times_.empty()) {
+        std::sort(tick_times_.begin(), tick_times_.end());
+        double total = 0.0;
+        for (int i = 0; i < (int) tick_times_.size(); i++) {
+            total += tick_times_[i];
+        }
+        step.mean_ms = total * 1000.0 / tick_times_.size();
+        step.median_ms = tick_times_[tick_times_.size() / 2] * 1000.0;
+        step.p99_ms = tick_times_[std::min(tick_times_.size() - 1, tick_times_.size() * 99 / 100)] * 1000.0;
+        step.max_ms = tick_times_.back() * 1000.0;
+    }
+    steps_.push_back(step);
+    tick_times_.clear();
+}
+
+
+void ScenarioRunner::PrintCurve(void) const
+{
+    printf("scenario %s\n", scenario_.name.c_str());
+    printf("%10s %10s %7s %10s %10s %10s %10s %8s\n", "population", "objects", "ticks", "mean ms", "median ms", "p99 ms", "max ms", "fields");
+    for (int i = 0; i < (int) steps_.size(); i++) {
+        const RampStep &s = steps_[i];
+        printf("%10d %10d %7d %10.3f %10.3f %10.3f %10.3f %8d\n", s.population, s.objects, s.ticks, s.mean_ms, s.median_ms, s.p99_ms, s.max_ms,
+               s.field_builds);
+    }
+}
+
+
+bool ScenarioRunner::WriteCurve(const std::string &path) const
+{
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "population,objects,ticks,mean_ms,median_ms,p99_ms,max_ms,field_builds\n");
+    for (int i = 0; i < (int) steps_.size(); i++) {
+        const RampStep &s = steps_[i];
+        fprintf(file, "%d,%d,%d,%.4f,%.4f,%.4f,%.4f,%d\n", s.population, s.objects, s.ticks, s.mean_ms, s.median_ms, s.p99_ms, s.max_ms,
+                s.field_builds);
+    }
+    fclose(file);
+    return true;
+}
+
+} // namespace game
@@ -0,0 +1,84 @@
+#ifndef SCENARIO_RUNNER_H_
+#define SCENARIO_RUNNER_H_
+
+#include <string>
+#include <vector>
+
+#include "scenario.h"
+#include "simulation.h"
+
+namespace game {
+
+    // Frame times measured while the population held at one step of a ramp
+    struct RampStep {
+        int population;   // objects the scenario asked for
+        int objects;      // objects in the world at the end of the step
+        int ticks;        // ticks measured
+        double mean_ms;
+        double median_ms;
+        double p99_ms;
+        double max_ms;
+        int field_builds; // flow fields completed during the step
+    };
+
+    // Drives a simulation through the population ramp of a scenario
+    // At the start of each step the world is topped up so every kind of
+    // object reaches its share of the step's population; objects destroyed
+    // since are replaced. Tick times are gathered for each step once the
+    // new objects have settled, giving a curve of frame time against
+    // population. Used by both the headless simulation and the game
+    class ScenarioRunner {
+
+        public:
+            // Constructor
+            ScenarioRunner(const Scenario &scenario);
+
+            // Call before each tick; places objects when a step begins
+            // The first call also applies the scenario's settings and seed
+            void Update(Simulation &simulation, double delta_time);
+
+            // Report how long the last tick took, in seconds
+            void ReportTick(double seconds);
+
+            // True once every step has been held for its time
+            bool IsFinished(void) const { return step_ >= scenario_.steps; }
+
+            // Name of the scenario
+            const std::string &GetName(void) const { return scenario_.name; }
+
+            // Completed steps, in order
+            const std::vector<RampStep> &GetSteps(void) const { return steps_; }
+
+            // Print the curve, one line per step
+            void PrintCurve(void) const;
+
+            // Write the curve as comma separated values; returns false if the file cannot be written
+            bool WriteCurve(const std::string &path) const;
+
+            // Seconds at the start of each step whose ticks are not measured
+            static constexpr double SETTLE_TIME = 0.5;
+
+        private:
+            Scenario scenario_;
+
+            // Current step, or -1 before the first, and the time spent in it
+            int step_;
+            double step_time_;
+
+            // Tick times of the current step, in seconds
+            std::vector<double> tick_times_;
+
+            std::vector<RampStep> steps_;
+            std::vector<int> counts_;
+
+            // Flow fields completed before the current step
+            int field_builds_;
+
+            // Summarize the current step's ticks into the curve
+            void FinishStep(const Simulation &simulation);
+
+    }; // class ScenarioRunner
+
+} // namespace game
+
+#endif // SCENARIO_RUNNER_H_
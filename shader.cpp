@@ -22,10 +22,22 @@ void Shader::Init(const char *vertPath, const char *fragPath)
     // Load shader program source code
     // Vertex program
     std::string vp = LoadTextFile(vertPath);
-    const char *source_vp = vp.c_str();
     // Fragment program
     std::string fp = LoadTextFile(fragPath);
-    const char *source_fp = fp.c_str();
+
+    InitFromSource(vp.c_str(), fp.c_str());
+}
+
+
+void Shader::InitFromSource(const char *source_vp, const char *source_fp, ShaderCache *cache, const char *name)
+{
+    // Skip compiling when the driver takes back a program it linked before
+    if (cache) {
+        shader_program_ = cache->Load(source_vp, source_fp, name);
+        if (shader_program_) {
+            return;
+        }
+    }
 
     // Create a shader from vertex program source code
     GLuint vs = glCreateShader(GL_VERTEX_SHADER);
@@ -59,6 +71,9 @@ void Shader::Init(const char *vertPath, const char *fragPath)
     shader_program_ = glCreateProgram();
     glAttachShader(shader_program_, vs);
     glAttachShader(shader_program_, fs);
+    if (cache) {
+        cache->PrepareLink(shader_program_);
+    }
     glLinkProgram(shader_program_);
 
     // Check if shaders were linked successfully
@@ -73,6 +88,10 @@ void Shader::Init(const char *vertPath, const char *fragPath)
     // and linked
     glDeleteShader(vs);
     glDeleteShader(fs);
+
+    if (cache) {
+        cache->Store(shader_program_, source_vp, source_fp, name);
+    }
 }
 
 
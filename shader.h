@@ -5,6 +5,8 @@
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
+#include "shader_cache.h"
+
 namespace game {
 
     // A class that stores a pair of vertex, fragment shaders
@@ -17,6 +19,11 @@ namespace game {
             // Initialize shader with source files
             void Init(const char *vertPath, const char *fragPath);
 
+            // Initialize shader with the zero terminated source code of each program
+            // With a cache, the linked program comes from it when it holds one
+            // for these sources, and goes into it otherwise; name labels its log
+            void InitFromSource(const char *vertSource, const char *fragSource, ShaderCache *cache = nullptr, const char *name = "");
+
             // Enable or disable this specific shader
             void Enable();
             void Disable();
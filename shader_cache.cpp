@@ -0,0 +1,200 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "shader_cache.h"
+
+namespace game {
+
+// Start of each cache file, followed by the driver string and the binary
+struct ShaderCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t binary_format;
+    uint64_t key;
+    uint32_t driver_length;
+    uint32_t binary_length;
+};
+
+static const char cache_magic_g[8] = { 'G', '2', '5', '0', '1', 'S', 'H', 'D' };
+static const uint32_t cache_version_g = 1;
+
+
+// FNV-1a over a zero terminated string and its terminator
+static uint64_t HashString(uint64_t hash, const char *text)
+{
+    do {
+        hash ^= (unsigned char) *text;
+        hash *= 1099511628211ull;
+    } while (*text++);
+    return hash;
+}
+
+
+static std::string GetGLString(GLenum name)
+{
+    const GLubyte *value = glGetString(name);
+    return value ? std::string((const char *) value) : std::string();
+}
+
+
+ShaderCache::ShaderCache(void)
+{
+    enabled_ = false;
+    hits_ = 0;
+    misses_ = 0;
+}
+
+
+void ShaderCache::Init(const std::string &directory)
+{
+    directory_ = directory;
+    driver_ = GetGLString(GL_VENDOR) + "|" + GetGLString(GL_RENDERER) + "|" + GetGLString(GL_VERSION);
+
+    // Drivers may have the entry points and still offer no binary format
+    GLint formats = 0;
+    if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    }
+    enabled_ = formats > 0;
+    if (!enabled_) {
+        std::cout << "Shader cache: the driver cannot save program binaries, compiling every shader" << std::endl;
+        return;
+    }
+
+#if defined(_WIN32)
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(), 0755);
+#endif
+}
+
+
+uint64_t ShaderCache::GetKey(const char *vertex_source, const char *fragment_source) const
+{
+    uint64_t hash = 14695981039346656037ull;
+    hash = HashString(hash, vertex_source);
+    hash = HashString(hash, fragment_source);
+    return HashString(hash, driver_.c_str());
+}
+
+
+std::string ShaderCache::GetPath(uint64_t key) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long) key);
+    return directory_ + "/" + name;
+}
+
+
+GLuint ShaderCache::Load(const char *vertex_source, const char *fragment_source, const char *name)
+{
+    if (!enabled_) {
+        return 0;
+    }
+    uint64_t key = GetKey(vertex_source, fragment_source);
+    std::string path = GetPath(key);
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cout << "Shader cache: miss for " << name << std::endl;
+        misses_++;
+        return 0;
+    }
+
+    // The driver string is checked as well as the hash, so a collision cannot hand over a foreign binary
+    ShaderCacheHeader header;
+    std::string driver;
+    std::vector<unsigned char> binary;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, cache_magic_g, sizeof(cache_magic_g)) == 0 &&
+                 header.version == cache_version_g && header.key == key && header.driver_length == driver_.size() &&
+                 header.binary_length > 0;
+    if (valid) {
+        driver.resize(header.driver_length);
+        binary.resize(header.binary_length);
+        valid = fread(&driver[0], 1, driver.size(), file) == driver.size() && driver == driver_ &&
+                fread(binary.data(), 1, binary.size(), file) == binary.size();
+    }
+    fclose(file);
+
+    GLuint program = 0;
+    if (valid) {
+        program = glCreateProgram();
+        glProgramBinary(program, header.binary_format, binary.data(), (GLsizei) binary.size());
+        GLint status;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (status != GL_TRUE) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+    if (!program) {
+        std::cout << "Shader cache: stale entry for " << name << ", compiling it again" << std::endl;
+        remove(path.c_str());
+        misses_++;
+        return 0;
+    }
+    std::cout << "Shader cache: hit for " << name << std::endl;
+    hits_++;
+    return program;
+}
+
+
+void ShaderCache::PrepareLink(GLuint program) const
+{
+    if (enabled_) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+}
+
+
+void ShaderCache::Store(GLuint program, const char *vertex_source, const char *fragment_source, const char *name)
+{
+    if (!enabled_) {
+        return;
+    }
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    std::vector<unsigned char> binary(length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) {
+        return;
+    }
+
+    ShaderCacheHeader header;
+    memcpy(header.magic, cache_magic_g, sizeof(cache_magic_g));
+    header.version = cache_version_g;
+    header.binary_format = format;
+    header.key = GetKey(vertex_source, fragment_source);
+    header.driver_length = (uint32_t) driver_.size();
+    header.binary_length = (uint32_t) written;
+
+    // Written aside and renamed into place, so a crash never leaves half a file to load
+    std::string path = GetPath(header.key);
+    std::string temporary = path + ".tmp";
+    FILE *file = fopen(temporary.c_str(), "wb");
+    bool ok = file != NULL;
+    if (ok) {
+        ok = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(driver_.data(), 1, driver_.size(), file) == driver_.size() &&
+             fwrite(binary.data(), 1, (std::size_t) written, file) == (std::size_t) written;
+        ok = fclose(file) == 0 && ok;
+    }
+    remove(path.c_str());
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cout << "Shader cache: cannot save " << name << " to " << path << std::endl;
+        remove(temporary.c_str());
+    }
+}
+
+} // namespace game
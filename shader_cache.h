@@ -0,0 +1,57 @@
+#ifndef SHADER_CACHE_H_
+#define SHADER_CACHE_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+
+namespace game {
+
+    // Linked shader programs kept on disk between runs
+    // Each file holds the binary the driver gave back for a program, named
+    // by a hash of the program's sources and of the driver's vendor,
+    // renderer and version, so editing a shader or updating the driver
+    // simply misses. A binary the driver no longer accepts is deleted and
+    // the program compiled from source again
+    class ShaderCache {
+
+        public:
+            // Constructor
+            ShaderCache(void);
+
+            // Keep the binaries in directory, made if missing
+            // Needs a GL context; the cache stays off if the driver cannot give binaries back
+            void Init(const std::string &directory);
+
+            bool IsEnabled(void) const { return enabled_; }
+
+            // A program linked from the binary cached for these sources, or 0 on a miss
+            // name only labels the log
+            GLuint Load(const char *vertex_source, const char *fragment_source, const char *name);
+
+            // Call before linking a program that will be stored
+            void PrepareLink(GLuint program) const;
+
+            // Save the binary of a program just linked from these sources
+            void Store(GLuint program, const char *vertex_source, const char *fragment_source, const char *name);
+
+            int GetNumHits(void) const { return hits_; }
+            int GetNumMisses(void) const { return misses_; }
+
+        private:
+            std::string directory_;
+            std::string driver_;
+            bool enabled_;
+            int hits_;
+            int misses_;
+
+            // Hash of the sources and the driver, and the file it names
+            uint64_t GetKey(const char *vertex_source, const char *fragment_source) const;
+            std::string GetPath(uint64_t key) const;
+
+    }; // class ShaderCache
+
+} // namespace game
+
+#endif // SHADER_CACHE_H_
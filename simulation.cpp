@@ -0,0 +1,1123 @@
+#include <string>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/matrix_transform.hpp> 
+#include <iostream>
+#include <cstdlib>
+#include <ctime>
+#include <algorithm>
+#include <chrono>
+
+#include "clock.h"
+#include "memory_stats.h"
+#include "profiler.h"
+#include "simulation.h"
+#include "projectile_shooting_enemy.h"
+#include "orbit_enemy.h"
+
+namespace game {
+
+// Rotation that points an object upwards
+static const float pi_over_two = glm::pi<float>() / 2.0f;
+
+// Cells on each side of the path field around the player, and their size
+static const int flow_field_size_g = 128;
+static const float flow_field_cell_size_g = 1.0f;
+
+
+Simulation::Simulation(void)
+    : flow_field_(flow_field_size_g, flow_field_cell_size_g)
+{
+    // Don't do work in the constructor, leave it for the Setup() function
+    player_ = nullptr;
+    grass_particle_system_ = nullptr;
+    current_time_ = 0.0;
+    score = 0;
+    lastShotTime_ = -shotCooldown_;
+    lastBombTime_ = -bombCooldown_;
+    game_over_ = false;
+    spawning_ = true;
+    invulnerable_ = false;
+    logging_ = true;
+    kernel_path_ = GetBestKernelPath();
+}
+
+
+Simulation::~Simulation()
+{
+    // Free memory for all objects
+    for (int i = 0; i < game_objects_.size(); i++){
+        delete game_objects_[i];
+    }
+    for (int i = 0; i < bullets_.size(); i++) {
+        delete bullets_[i];
+    }
+    for (int i = 0; i < explosions_.size(); i++) {
+        delete explosions_[i];
+    }
+    for (int i = 0; i < collectibles_.size(); i++) {
+        delete collectibles_[i];
+    }
+    for (int i = 0; i < potions_.size(); i++) {
+        delete potions_[i];
+    }
+    for (int i = 0; i < discs_.size(); i++) {
+        delete discs_[i]->sparkles_;
+        delete discs_[i];
+    }
+    for (int i = 0; i < bombs_.size(); i++) {
+        delete bombs_[i];
+    }
+    delete grass_particle_system_;
+}
+
+
+void Simulation::Setup(const SimulationResources &resources)
+{
+    res_ = resources;
+
+    // Spawn intervals, population caps and despawn distances
+    // The two enemy kinds take turns, one every two seconds between them
+    spawn_director_.SetInterval(SPAWN_ENEMY, 4.0);
+    spawn_director_.SetInterval(SPAWN_SHOOTER, 4.0);
+    spawn_director_.SetFirstSpawn(SPAWN_SHOOTER, 2.0);
+    spawn_director_.SetInterval(SPAWN_BONE, 15.0);
+    spawn_director_.SetInterval(SPAWN_POTION, 15.0);
+    spawn_director_.SetCap(SPAWN_ENEMY, 30);
+    spawn_director_.SetCap(SPAWN_SHOOTER, 20);
+    spawn_director_.SetCap(SPAWN_BONE, 10);
+    spawn_director_.SetCap(SPAWN_POTION, 10);
+    spawn_director_.SetDespawnDistance(SPAWN_ENEMY, 60.0f);
+    spawn_director_.SetDespawnDistance(SPAWN_SHOOTER, 60.0f);
+    spawn_director_.SetDespawnDistance(SPAWN_BONE, 80.0f);
+    spawn_director_.SetDespawnDistance(SPAWN_POTION, 80.0f);
+
+    // Start the worker threads used for collision detection
+    jobs_.Init();
+    frame_arenas_.Init(jobs_.GetNumThreads());
+    collision_system_.Init(&jobs_);
+
+    // Setup the game world
+
+    // Setup the player object (position, texture, vertex count)
+    // Note that, in this specific implementation, the player object should always be the first object in the game object vector 
+    player_ = new PlayerGameObject(glm::vec3(0.0f, 0.0f, -1.0f), res_.sprite, res_.sprite_shader, res_.tex[0]);
+    game_objects_.push_back(player_);
+    game_objects_[0]->SetRotation(pi_over_two);
+
+
+    // Setup enemy objects
+
+    // Setup collectible objects
+    
+    // Bones
+    collectibles_.push_back(new CollectibleGameObject(glm::vec3(2.0f, 2.0f, 0.0f), res_.sprite, res_.sprite_shader, res_.tex[7]));
+    collectibles_[0]->SetScale(glm::vec2(0.5f, 0.5f));
+    collectibles_.push_back(new CollectibleGameObject(glm::vec3(-2.0f, -2.0f, 0.0f), res_.sprite, res_.sprite_shader, res_.tex[7]));
+    collectibles_[1]->SetScale(glm::vec2(0.5f, 0.5f));
+    collectibles_.push_back(new CollectibleGameObject(glm::vec3(-2.0f, 3.0f, 0.0f), res_.sprite, res_.sprite_shader, res_.tex[7]));
+    collectibles_[2]->SetScale(glm::vec2(0.5f, 0.5f));
+    collectibles_.push_back(new CollectibleGameObject(glm::vec3(4.0f, 1.0f, 0.0f), res_.sprite, res_.sprite_shader, res_.tex[7]));
+    collectibles_[3]->SetScale(glm::vec2(0.5f, 0.5f));
+    collectibles_.push_back(new CollectibleGameObject(glm::vec3(-1.0f, -3.0f, 0.0f), res_.sprite, res_.sprite_shader, res_.tex[7]));
+    collectibles_[4]->SetScale(glm::vec2(0.5f, 0.5f));
+    collectibles_.push_back(new CollectibleGameObject(glm::vec3(3.0f, -2.0f, 0.0f), res_.sprite, res_.sprite_shader, res_.tex[7]));
+    collectibles_[5]->SetScale(glm::vec2(0.5f, 0.5f));
+
+    // Potions
+    potions_.push_back(new PotionCollectibleGameObject(glm::vec3(5.0f, 4.0f, 0.0f), res_.sprite, res_.sprite_shader, res_.tex[17]));
+    potions_[0]->SetScale(glm::vec2(0.6f, 0.6f));
+    potions_.push_back(new PotionCollectibleGameObject(glm::vec3(-3.0f, 1.0f, 0.0f), res_.sprite, res_.sprite_shader, res_.tex[17]));
+    potions_[1]->SetScale(glm::vec2(0.6f, 0.6f));
+    potions_.push_back(new PotionCollectibleGameObject(glm::vec3(-4.0f, -3.0f, 0.0f), res_.sprite, res_.sprite_shader, res_.tex[17]));
+    potions_[2]->SetScale(glm::vec2(0.6f, 0.6f));
+
+    // Randomize positions for discs
+    srand(time(NULL));
+
+    // Discs
+    for (int i = 0; i < 3; ++i) {
+        float x = (rand() % 41) - 30.0f; // Random x value between -30 and 30
+        float y = (rand() % 41) - 30.0f; // Random y value between -30 and 30
+        float z = -1.0f; // Fixed z value
+
+        SpawnOrbitEnemy(glm::vec3(x, y, z));
+        discs_.push_back(new DiscCollectibleGameObject(glm::vec3(x, y, z), res_.sprite, res_.sprite_shader, res_.tex[13 + i]));
+        discs_[i]->SetScale(glm::vec2(0.7f, 0.7f));
+
+        if (logging_) {
+            std::cout << "Disc " << i << " at: " << x << " " << y << std::endl;
+        }
+    }
+
+    // Disc particle effects
+    GameObject* disc_particles = new SparkleParticleSystem(glm::vec3(0.0f, 0.0f, EFFECTS_DEPTH), res_.sparkle_particles, res_.sparkle_particle_shader, res_.tex[8], discs_[0]);
+    disc_particles->SetScale(glm::vec2(0.1f, 0.1f));
+    disc_particles->SetRotation(-pi_over_two);
+    disc_particles->SetCollidable(false);
+    discs_[0]->sparkles_ = disc_particles; // Add pointer to the particle system to the disc object
+
+    disc_particles = new SparkleParticleSystem(glm::vec3(0.0f, 0.0f, EFFECTS_DEPTH), res_.sparkle_particles, res_.sparkle_particle_shader, res_.tex[8], discs_[1]);
+    disc_particles->SetScale(glm::vec2(0.1f, 0.1f));
+    disc_particles->SetRotation(-pi_over_two);
+    disc_particles->SetCollidable(false);
+    discs_[1]->sparkles_ = disc_particles; // Add pointer to the particle system to the disc object
+
+    disc_particles = new SparkleParticleSystem(glm::vec3(0.0f, 0.0f, EFFECTS_DEPTH), res_.sparkle_particles, res_.sparkle_particle_shader, res_.tex[8], discs_[2]);
+    disc_particles->SetScale(glm::vec2(0.1f, 0.1f));
+    disc_particles->SetRotation(-pi_over_two);
+    disc_particles->SetCollidable(false);
+    discs_[2]->sparkles_ = disc_particles; // Add pointer to the particle system to the disc object
+
+    // Setup particle system
+    GameObject* particles = new ParticleSystem(glm::vec3(0.0f, 0.0f, EFFECTS_DEPTH), res_.particles, res_.particle_shader, res_.tex[10], game_objects_[0]);
+    particles->SetScale(glm::vec2(0.4f, 0.4f));
+    particles->SetRotation(-pi_over_two);
+    particles->SetCollidable(false);
+    grass_particle_system_ = dynamic_cast<ParticleSystem*>(particles);
+}
+
+
+void Simulation::Step(double delta_time, const InputState &input)
+{
+    PROFILE_SCOPE("simulation step");
+    ALLOCATION_TAG(TAG_SIMULATION);
+
+    // Nothing from the last tick is used any more
+    frame_arenas_.Reset();
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Snapshots are drawn between where objects were and where they end up
+    SavePositions();
+
+    // Handle user input
+    HandleControls(delta_time, input);
+
+    // Update all the game objects
+    Update(delta_time);
+
+    // Spawning adapts to how long ticks take
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    spawn_director_.ReportFrameTime(elapsed.count());
+}
+
+
+void Simulation::HandleControls(double delta_time, const InputState &input)
+{
+    // Get player game object
+    GameObject *player = game_objects_[0];
+    // Get current position and angle
+    glm::vec3 curpos = player->GetPosition();
+    float angle = player->GetRotation();
+    // Compute current bearing direction
+    glm::vec3 dir = player->GetBearing();
+    // Adjust motion increment and angle increment 
+    // if translation or rotation is too slow
+    float speed = delta_time*1500.0;
+    float motion_increment = 0.001*speed;
+    float angle_increment = (glm::pi<float>() / 1200.0f)*speed;
+
+    //Reset Player velocity to 0 between keystrokes
+    dynamic_cast<PlayerGameObject*>(player)->SetVelocity(glm::vec3(0.0f, 0.0f, 0.0f));
+    //Reset Player speed to base speed
+    dynamic_cast<PlayerGameObject*>(player)->SetSpeed(1.0f);
+
+    // Check for player movement input and make changes accordingly
+    if (input.forward) {
+        dynamic_cast<PlayerGameObject*>(player)->Drive(1);
+    }
+    if (input.backward) {
+        dynamic_cast<PlayerGameObject*>(player)->Drive(-1);
+    }
+    if (input.turn_right) {
+        player->SetRotation(angle - angle_increment);
+    }
+    if (input.turn_left) {
+        player->SetRotation(angle + angle_increment);
+    }
+    if (input.strafe_left) {
+        dynamic_cast<PlayerGameObject*>(player)->Strafe(-1);
+    }
+    if (input.strafe_right) {
+        dynamic_cast<PlayerGameObject*>(player)->Strafe(1);
+    }
+    if (input.boost) {
+		// Speed boost the player
+        dynamic_cast<PlayerGameObject*>(player)->SetSpeed(2.0f);
+	}
+    if (input.fire) {
+        float bulletAngle = atan2((-1)*input.aim.y, input.aim.x);
+        glm::vec3 direction = CalculateDirectionVector(bulletAngle);
+        SpawnBullet(player->GetPosition(), direction, res_.tex[9], 7.0f, true);
+    }
+    if (input.next_broadphase) {
+        SetBroadphase((GetBroadphase() + 1) % NUM_BROADPHASES);
+        if (logging_) {
+            std::cout << "Broadphase: " << GetBroadphaseName(GetBroadphase()) << std::endl;
+        }
+    }
+    if (input.drop_bomb) {
+
+        //if can shoot
+        if (current_time_ - lastBombTime_ >= bombCooldown_) {
+            DropBombAtLocation(player->GetPosition());
+            lastBombTime_ = current_time_;
+        }
+
+    }
+}
+
+
+void Simulation::Update(double delta_time)
+{
+    // Get player game object
+    PlayerGameObject* player = dynamic_cast<PlayerGameObject*>(game_objects_[0]);
+    //std::cout << "Player position: " << player->GetPosition().x << " " << player->GetPosition().y << std::endl;
+
+
+    // Animate player
+    if (player->animationTimer_.Finished()) {
+        player->animationTimer_.Start(player->animationSpeed_);
+
+        // Check if player is moving
+        if (player->animationSpeed_ != 0.0f) {
+            // Change player texture
+            if (player->currentFrame_ == 0) {
+                game_objects_[0]->SetTexture(res_.tex[1]);
+                player->currentFrame_ = 1;
+            }
+            else {
+                game_objects_[0]->SetTexture(res_.tex[0]);
+                player->currentFrame_ = 0;
+            }
+        }
+        else {
+			// Set player texture to still
+			game_objects_[0]->SetTexture(res_.tex[2]);
+        }
+	}
+
+    // Update time; timers everywhere read it through the game clock
+    current_time_ += delta_time;
+    SetClockTime(current_time_);
+
+    // Despawn what has drifted far away and spawn within the budget
+    if (spawning_) {
+        ManagePopulation(delta_time);
+    }
+
+    // Move all bullets in one batch, then age them and remove the expired ones
+    MoveBullets(delta_time);
+    for (int i = 0; i < bullets_.size(); ) {
+        BulletGameObject* current_game_object = bullets_[i];
+        current_game_object->Age(delta_time);
+
+        if (current_game_object->IsMarkedForDeletion()) {
+            delete current_game_object;
+            bullets_.erase(bullets_.begin() + i);
+        }
+        else {
+            i++;
+        }
+    }
+
+    // Check for expired bone collectibles
+    for (int i = 0; i < collectibles_.size(); i++) {
+        CollectibleGameObject* current_game_object = collectibles_[i];
+        // Update the current game object; pickups sleep until touched
+        if (!current_game_object->IsSleeping()) {
+            current_game_object->Update(delta_time);
+        }
+
+        if (current_game_object->IsMarkedForDeletion()) {
+            // Find the object in the bullets vector
+            auto it = std::find(collectibles_.begin(), collectibles_.end(), current_game_object);
+
+            // If found, remove it
+            if (it != collectibles_.end()) {
+                delete* it; // Free memory if objects are dynamically allocated
+                collectibles_.erase(it);
+            }
+        }
+    }
+
+    // Check for expired potion collectibles
+    for (int i = 0; i < potions_.size(); i++) {
+		PotionCollectibleGameObject* current_game_object = potions_[i];
+		// Update the current game object; pickups sleep until touched
+		if (!current_game_object->IsSleeping()) {
+		    current_game_object->Update(delta_time);
+		}
+
+		if (current_game_object->IsMarkedForDeletion()) {
+			// Find the object in the potions vector
+			auto it = std::find(potions_.begin(), potions_.end(), current_game_object);
+
+			// If found, remove it
+			if (it != potions_.end()) {
+				delete* it; // Free memory if objects are dynamically allocated
+				potions_.erase(it);
+			}
+		}
+	}
+
+    // Check for expired disc collectibles
+    for (int i = 0; i < discs_.size(); i++) {
+		DiscCollectibleGameObject* current_game_object = discs_[i];
+		// Update the current game object; pickups sleep until touched
+		if (!current_game_object->IsSleeping()) {
+		    current_game_object->Update(delta_time);
+		}
+
+		if (current_game_object->IsMarkedForDeletion()) {
+			// Find the object in the discs vector
+			auto it = std::find(discs_.begin(), discs_.end(), current_game_object);
+
+			// If found, remove it
+			if (it != discs_.end()) {
+                delete discs_[i]->sparkles_; // Delete the associated particle system
+				delete* it; // Free memory if objects are dynamically allocated
+				discs_.erase(it);
+			}
+		}
+	}
+
+    // Update all game objects
+
+    for (BombGameObject* bomb : bombs_) {
+        bomb->Update(delta_time);
+    }
+
+    //Check for any finished explosions
+    while (explosions_.size() > 0 && explosions_[0]->explosion_timer_.Finished()) {
+        delete explosions_[0];
+        explosions_.erase(explosions_.begin());
+        if (logging_) {
+            std::cout << "Explosion finished!" << std::endl;
+        }
+    }
+
+    // The player updates every tick; everything else at a rate set by its
+    // distance from the player
+    player->Update(delta_time);
+    update_scheduler_.Schedule(game_objects_, 1, glm::vec2(player->GetPosition().x, player->GetPosition().y), delta_time);
+    SteerScheduledEnemies();
+    update_scheduler_.Run();
+
+    // Let every enemy know where the player is and which way leads there
+    flow_field_.Update(glm::vec2(player->GetPosition().x, player->GetPosition().y));
+    for (int i = 1; i < game_objects_.size(); i++) {
+        EnemyGameObject* enemy = dynamic_cast<EnemyGameObject*>(game_objects_[i]);
+        if (enemy) {
+            enemy->updatePlayerPos(player->GetPosition());
+            enemy->SetChaseTarget(flow_field_.GetChaseTarget(enemy->GetPosition(), player->GetPosition()));
+        }
+    }
+
+    // Check for collisions between all objects and respond to them
+    HandleCollisions();
+
+    // Blasts find their victims with the spatial index built for the collisions
+    HandleBombExplosions();
+
+    // Remove the destroyed and despawned enemies from the game
+    RemoveDestroyedObjects();
+}
+
+
+int Simulation::GetSpawnType(GameObject* object) const
+{
+    // Orbiting enemies and their blades guard the discs and are not managed
+    if (dynamic_cast<OrbitEnemy*>(object)) {
+        return -1;
+    }
+    if (dynamic_cast<ProjectileShootingEnemy*>(object)) {
+        return SPAWN_SHOOTER;
+    }
+    EnemyGameObject* enemy = dynamic_cast<EnemyGameObject*>(object);
+    if (enemy && !enemy->isOrbititnObject) {
+        return SPAWN_ENEMY;
+    }
+    return -1;
+}
+
+
+void Simulation::SavePositions(void)
+{
+    for (int i = 0; i < game_objects_.size(); i++) {
+        game_objects_[i]->SavePosition();
+    }
+    for (int i = 0; i < bullets_.size(); i++) {
+        bullets_[i]->SavePosition();
+    }
+    for (int i = 0; i < explosions_.size(); i++) {
+        explosions_[i]->SavePosition();
+    }
+    for (int i = 0; i < collectibles_.size(); i++) {
+        collectibles_[i]->SavePosition();
+    }
+    for (int i = 0; i < potions_.size(); i++) {
+        potions_[i]->SavePosition();
+    }
+    for (int i = 0; i < discs_.size(); i++) {
+        discs_[i]->SavePosition();
+    }
+    for (BombGameObject* bomb : bombs_) {
+        bomb->SavePosition();
+    }
+}
+
+
+void Simulation::MoveBullets(double delta_time)
+{
+    PROFILE_SCOPE("move bullets");
+
+    bullet_batch_.Resize((int) bullets_.size());
+    for (int i = 0; i < bullets_.size(); i++) {
+        glm::vec3 position = bullets_[i]->GetPosition();
+        glm::vec3 velocity = bullets_[i]->GetVelocity();
+        bullet_batch_.Set(i, position.x, position.y, position.z, velocity.x, velocity.y, velocity.z);
+    }
+
+    IntegrateBullets(bullet_batch_, (float) delta_time, kernel_path_);
+
+    for (int i = 0; i < bullets_.size(); i++) {
+        bullets_[i]->SetPosition(glm::vec3(bullet_batch_.x[i], bullet_batch_.y[i], bullet_batch_.z[i]));
+    }
+}
+
+
+void Simulation::SteerScheduledEnemies(void)
+{
+    PROFILE_SCOPE("steer enemies");
+
+    // The flock is every enemy chasing the player; those the scheduler
+    // picked for this tick are steered now
+    flock_.Clear();
+    chasers_.clear();
+    for (int i = 1; i < game_objects_.size(); i++) {
+        EnemyGameObject* enemy = dynamic_cast<EnemyGameObject*>(game_objects_[i]);
+        if (enemy && enemy->state_ == INTERCEPTING_ && !enemy->IsDisabled()) {
+            enemy->flock_index_ = flock_.Add(glm::vec2(enemy->GetPosition().x, enemy->GetPosition().y),
+                                             glm::vec2(enemy->velocity.x, enemy->velocity.y));
+            if (enemy->IsUpdateDue()) {
+                chasers_.push_back(enemy);
+            }
+        }
+    }
+    flock_.Build();
+
+    // Forces from the neighbours; each job writes only its own enemies
+    jobs_.ParallelFor((int) chasers_.size(), 64, [&](int begin, int end, int) {
+        for (int i = begin; i < end; i++) {
+            glm::vec2 force = flock_.GetForce(chasers_[i]->flock_index_);
+            chasers_[i]->SetSteeringForce(glm::vec3(force.x, force.y, 0.0f));
+        }
+    });
+
+    // Enemies catching up over several steps steer themselves; the rest
+    // are packed to the front of chasers_ as they go into the batch
+    chase_batch_.Resize((int) chasers_.size());
+    int batched = 0;
+    for (int i = 0; i < chasers_.size(); i++) {
+        EnemyGameObject* enemy = chasers_[i];
+        double delta_time = enemy->GetPendingTime();
+        if (delta_time > UpdateScheduler::MAX_CATCH_UP_STEP) {
+            continue;
+        }
+
+        glm::vec3 position = enemy->GetPosition();
+        chase_batch_.Set(batched, position.x, position.y, position.z,
+                         enemy->velocity.x, enemy->velocity.y, enemy->velocity.z,
+                         enemy->chase_target_.x, enemy->chase_target_.y, enemy->chase_target_.z,
+                         enemy->steering_force_.x, enemy->steering_force_.y, enemy->steering_force_.z,
+                         enemy->speed, (float) delta_time);
+        chasers_[batched++] = enemy;
+    }
+    chase_batch_.Resize(batched);
+
+    SteerChasers(chase_batch_, kernel_path_);
+
+    for (int i = 0; i < batched; i++) {
+        chasers_[i]->ApplySteering(glm::vec3(chase_batch_.x[i], chase_batch_.y[i], chase_batch_.z[i]),
+                                   glm::vec3(chase_batch_.vx[i], chase_batch_.vy[i], chase_batch_.vz[i]),
+                                   chase_batch_.angle[i]);
+    }
+}
+
+
+void Simulation::ManagePopulation(double delta_time)
+{
+    PROFILE_SCOPE("manage population");
+    ALLOCATION_TAG(TAG_SPAWNING);
+
+    glm::vec2 player_position(player_->GetPosition().x, player_->GetPosition().y);
+    auto distance_squared = [&](GameObject* object) {
+        glm::vec2 offset = glm::vec2(object->GetPosition().x, object->GetPosition().y) - player_position;
+        return glm::dot(offset, offset);
+    };
+
+    // Count what is alive and despawn what is too far away
+    // Despawned objects are taken out by the same code as destroyed ones
+    int population[NUM_SPAWN_TYPES] = { 0 };
+    for (int i = 1; i < game_objects_.size(); i++) {
+        int type = GetSpawnType(game_objects_[i]);
+        if (type < 0 || game_objects_[i]->IsMarkedForDeletion()) {
+            continue;
+        }
+        if (spawn_director_.ShouldDespawn(type, distance_squared(game_objects_[i]))) {
+            game_objects_[i]->MarkForDeletion();
+            spawn_director_.CountDespawn(type);
+        }
+        else {
+            population[type]++;
+        }
+    }
+    for (int i = 0; i < collectibles_.size(); i++) {
+        if (collectibles_[i]->IsMarkedForDeletion()) {
+            continue;
+        }
+        if (spawn_director_.ShouldDespawn(SPAWN_BONE, distance_squared(collectibles_[i]))) {
+            collectibles_[i]->MarkForDeletion();
+            spawn_director_.CountDespawn(SPAWN_BONE);
+        }
+        else {
+            population[SPAWN_BONE]++;
+        }
+    }
+    for (int i = 0; i < potions_.size(); i++) {
+        if (potions_[i]->IsMarkedForDeletion()) {
+            continue;
+        }
+        if (spawn_director_.ShouldDespawn(SPAWN_POTION, distance_squared(potions_[i]))) {
+            potions_[i]->MarkForDeletion();
+            spawn_director_.CountDespawn(SPAWN_POTION);
+        }
+        else {
+            population[SPAWN_POTION]++;
+        }
+    }
+
+    int spawns[NUM_SPAWN_TYPES];
+    spawn_director_.Update(delta_time, population, spawns);
+
+    // New objects appear around the player
+    if (spawns[SPAWN_ENEMY]) {
+        glm::vec3 position(player_position.x + rand() % 25 - 12, player_position.y + rand() % 25 - 12, 0.0f);
+        if (logging_) {
+            std::cout << "New enemy at: " << position.x << " " << position.y << std::endl;
+        }
+        game_objects_.push_back(new EnemyGameObject(position, res_.sprite, res_.sprite_shader, res_.tex[3]));
+        game_objects_.back()->SetRotation(pi_over_two);
+        spawn_director_.CountSpawn(SPAWN_ENEMY);
+    }
+    if (spawns[SPAWN_SHOOTER]) {
+        glm::vec3 position(player_position.x + rand() % 25 - 12, player_position.y + rand() % 25 - 12, 0.0f);
+        if (logging_) {
+            std::cout << "New enemy at: " << position.x << " " << position.y << std::endl;
+        }
+        game_objects_.push_back(new ProjectileShootingEnemy(this, position, res_.sprite, res_.sprite_shader, res_.tex[12], res_.tex[5]));
+        spawn_director_.CountSpawn(SPAWN_SHOOTER);
+    }
+    if (spawns[SPAWN_BONE]) {
+        glm::vec3 position(player_position.x + rand() % 35 - 17, player_position.y + rand() % 35 - 17, 0.0f);
+        collectibles_.push_back(new CollectibleGameObject(position, res_.sprite, res_.sprite_shader, res_.tex[7]));
+        collectibles_.back()->SetScale(glm::vec2(0.5f, 0.5f));
+        spawn_director_.CountSpawn(SPAWN_BONE);
+    }
+    if (spawns[SPAWN_POTION]) {
+        glm::vec3 position(player_position.x + rand() % 35 - 17, player_position.y + rand() % 35 - 17, 0.0f);
+        potions_.push_back(new PotionCollectibleGameObject(position, res_.sprite, res_.sprite_shader, res_.tex[17]));
+        potions_.back()->SetScale(glm::vec2(0.6f, 0.6f));
+        spawn_director_.CountSpawn(SPAWN_POTION);
+    }
+}
+
+
+void Simulation::AddCollisionProxy(GameObject* object, int kind, bool swept)
+{
+    CollisionProxy proxy;
+    proxy.object = object;
+    proxy.position = glm::vec2(object->GetPosition().x, object->GetPosition().y);
+    proxy.shape = object->GetWorldCollisionShape();
+    if (swept) {
+        // Cover the path from the start of the tick, so fast objects and
+        // long ticks cannot step over what lies between
+        glm::vec2 motion(object->GetMotion().x, object->GetMotion().y);
+        proxy.position -= 0.5f * motion;
+        proxy.shape = proxy.shape.Swept(motion);
+    }
+    proxy.kind = kind;
+    proxy.collidable = object->IsCollidable();
+    collision_proxies_.push_back(proxy);
+}
+
+
+void Simulation::HandleCollisions(void)
+{
+    PROFILE_SCOPE("collisions");
+    ALLOCATION_TAG(TAG_COLLISION);
+
+    // Gather everything that can collide, always in the same order so the
+    // contacts come out the same every run
+    collision_proxies_.clear();
+    AddCollisionProxy(player_, COLLIDER_PLAYER);
+    for (int i = 1; i < game_objects_.size(); i++) {
+        if (dynamic_cast<OrbitEnemy*>(game_objects_[i])) {
+            AddCollisionProxy(game_objects_[i], COLLIDER_ORBIT_ENEMY);
+        }
+        else if (dynamic_cast<EnemyGameObject*>(game_objects_[i])) {
+            AddCollisionProxy(game_objects_[i], COLLIDER_ENEMY);
+        }
+    }
+    for (int i = 0; i < bullets_.size(); i++) {
+        AddCollisionProxy(bullets_[i], bullets_[i]->isFriendly ? COLLIDER_FRIENDLY_BULLET : COLLIDER_ENEMY_BULLET, true);
+    }
+    for (int i = 0; i < collectibles_.size(); i++) {
+        AddCollisionProxy(collectibles_[i], COLLIDER_BONE);
+    }
+    for (int i = 0; i < potions_.size(); i++) {
+        AddCollisionProxy(potions_[i], COLLIDER_POTION);
+    }
+    for (int i = 0; i < discs_.size(); i++) {
+        AddCollisionProxy(discs_[i], COLLIDER_DISC);
+    }
+
+    // The same objects answer this tick's area queries
+    spatial_index_.Build(collision_proxies_);
+
+    // Enemies near the player start chasing it; orbiting enemies guard
+    // their disc and never chase on sight. Their blades are disabled and
+    // moved by the OrbitEnemy, so they are left asleep
+    glm::vec2 player_position(player_->GetPosition().x, player_->GetPosition().y);
+    spatial_index_.QueryRadius(player_position, CollisionSystem::AGGRO_DISTANCE, QueryMask(COLLIDER_ENEMY), query_hits_);
+    for (int i = 0; i < query_hits_.size(); i++) {
+        EnemyGameObject* enemy = static_cast<EnemyGameObject*>(query_hits_[i].object);
+        if (enemy->IsDisabled()) {
+            continue;
+        }
+        enemy->state_ = INTERCEPTING_;
+        enemy->Wake();
+    }
+
+    // Detection runs in parallel; the contacts come back sorted
+    collision_system_.FindContacts(collision_proxies_, contacts_);
+
+    // Apply the responses one at a time, in contact order
+    for (int i = 0; i < contacts_.size(); i++) {
+        const CollisionProxy& a = collision_proxies_[contacts_[i].a];
+        const CollisionProxy& b = collision_proxies_[contacts_[i].b];
+        const CollisionProxy& first = (a.kind == COLLIDER_PLAYER || b.kind == COLLIDER_FRIENDLY_BULLET) ? a : b;
+        const CollisionProxy& second = (&first == &a) ? b : a;
+
+        // Enemies destroyed earlier this frame take no further part
+        if (first.object->IsMarkedForDeletion() || second.object->IsMarkedForDeletion()) {
+            continue;
+        }
+
+        // Anything touched is awake from now on
+        first.object->Wake();
+        second.object->Wake();
+
+        switch (contacts_[i].type) {
+            case CONTACT_PLAYER_HIT:
+                // Make player take damage
+                if (!player_->isInvincible_) {
+                    if (DamagePlayer()) {
+                        break;
+                    }
+                }
+                DestroyEnemy(dynamic_cast<EnemyGameObject*>(second.object));
+                if (logging_) {
+                    std::cout << "Player current HP: " << player_->hp_ << std::endl;
+                }
+                break;
+
+            case CONTACT_BULLET_HIT:
+                DestroyEnemy(dynamic_cast<EnemyGameObject*>(first.object));
+                break;
+
+            case CONTACT_PLAYER_SHOT:
+                if (!player_->isInvincible_) {
+                    DamagePlayer();
+                }
+                break;
+
+            case CONTACT_PICKUP:
+                if (!second.object->IsCollidable()) {
+                    break;
+                }
+                second.object->MarkForDeletion();
+                second.object->SetCollidable(false);
+                if (second.kind == COLLIDER_BONE) {
+                    if (logging_) {
+                        std::cout << "Collectible collected!" << std::endl;
+                    }
+                    player_->objectsCollected_++;
+                }
+                else if (second.kind == COLLIDER_POTION) {
+                    if (logging_) {
+                        std::cout << "Potion collected!" << std::endl;
+                    }
+                    // Check if player is at full health
+                    if (player_->hp_ < 3) {
+                        player_->hp_++;
+                    }
+                }
+                else if (second.kind == COLLIDER_DISC) {
+                    player_->goalObjectsCollected_++;
+                    if (logging_) {
+                        std::cout << "Disc collected!" << std::endl;
+                        std::cout << "Goal objects collected: " << player_->goalObjectsCollected_ << std::endl;
+                    }
+                    if (player_->goalObjectsCollected_ == 3) {
+                        if (logging_) {
+                            std::cout << "Player has won!" << std::endl;
+                        }
+                        game_over_ = true;
+                    }
+                }
+                break;
+        }
+    }
+}
+
+
+bool Simulation::DamagePlayer(void)
+{
+    if (invulnerable_) {
+        return false;
+    }
+    player_->takeDamage();
+    if (logging_) {
+        std::cout << "Player took damage! " << std::endl << "Current HP: " << player_->hp_ << std::endl;
+    }
+
+    player_->isInvincible_ = true;
+    player_->invincibilityTimer_.Start(1.5f);
+
+    if (player_->hp_ <= 0) {
+        //Add explosion
+        explosions_.push_back(new ExplosionGameObject(player_->GetPosition(), res_.sprite, res_.sprite_shader, res_.tex[6]));
+        if (logging_) {
+            std::cout << "Player has died!" << std::endl;
+        }
+        game_over_ = true;
+        return true;
+    }
+    return false;
+}
+
+
+void Simulation::DestroyEnemy(EnemyGameObject* enemy)
+{
+    score += 100;
+    if (logging_) {
+        std::cout << "Explosion Started" << std::endl;
+    }
+    explosions_.push_back(new ExplosionGameObject(enemy->GetPosition(), res_.sprite, res_.sprite_shader, res_.tex[6]));
+    enemy->isOrbititnObject = false;
+
+    // Taken out of game_objects_ once all the responses have been applied
+    enemy->MarkForDeletion();
+}
+
+
+void Simulation::BuildSnapshot(RenderSnapshot &snapshot)
+{
+    PROFILE_SCOPE("build snapshot");
+    ALLOCATION_TAG(TAG_SNAPSHOT);
+
+    snapshot.time = current_time_;
+    snapshot.camera_position = player_->GetPosition();
+    snapshot.camera_motion = player_->GetMotion();
+
+    // Gather the objects to draw along with their layers
+    // The order here does not matter; the command buffer sorts the draws
+    ArenaVector<std::pair<GameObject*, int> > render_list(ArenaAllocator<std::pair<GameObject*, int> >(&frame_arenas_.Get(0)));
+    render_list.reserve(explosions_.size() + bullets_.size() + game_objects_.size() + collectibles_.size() +
+                        potions_.size() + 2 * discs_.size() + bombs_.size() + 1);
+    for (int i = 0; i < explosions_.size(); i++) {
+        render_list.push_back(std::make_pair((GameObject*) explosions_[i], (int) LAYER_WORLD));
+    }
+    for (int i = 0; i < bullets_.size(); i++) {
+        render_list.push_back(std::make_pair((GameObject*) bullets_[i], (int) LAYER_WORLD));
+    }
+    for (int i = 1; i < game_objects_.size(); i++) {
+        render_list.push_back(std::make_pair(game_objects_[i], (int) LAYER_WORLD));
+    }
+    for (int i = 0; i < collectibles_.size(); i++) {
+        render_list.push_back(std::make_pair((GameObject*) collectibles_[i], (int) LAYER_WORLD));
+    }
+    for (int i = 0; i < potions_.size(); i++) {
+        render_list.push_back(std::make_pair((GameObject*) potions_[i], (int) LAYER_WORLD));
+    }
+    render_list.push_back(std::make_pair((GameObject*) grass_particle_system_, (int) LAYER_EFFECTS));
+    for (int i = 0; i < discs_.size(); i++) {
+        render_list.push_back(std::make_pair((GameObject*) discs_[i]->sparkles_, (int) LAYER_EFFECTS));
+        render_list.push_back(std::make_pair((GameObject*) discs_[i], (int) LAYER_FOREGROUND));
+    }
+    for (BombGameObject* bomb : bombs_) {
+        render_list.push_back(std::make_pair((GameObject*) bomb, (int) LAYER_FOREGROUND));
+    }
+    render_list.push_back(std::make_pair(game_objects_[0], (int) LAYER_FOREGROUND));
+
+    // Record the draws on the worker threads, then sort them into commands
+    RenderCommandBuffer &commands = snapshot.commands;
+    commands.Reset(jobs_.GetNumThreads());
+    jobs_.ParallelFor((int) render_list.size(), 64, [&](int begin, int end, int thread_index) {
+        DrawList &draw_list = commands.GetDrawList(thread_index);
+        for (int i = begin; i < end; i++) {
+            draw_list.SetOrder(i);
+            render_list[i].first->Render(draw_list, render_list[i].second, current_time_);
+        }
+    });
+    commands.Compile();
+
+    // Values for the HUD
+    snapshot.hud.score = score;
+    snapshot.hud.health = player_->hp_;
+    snapshot.hud.collectibles = player_->objectsCollected_;
+    snapshot.hud.invincible = player_->isInvincible_;
+    snapshot.hud.invincibility_time_left = player_->invincibilityTimer_.TimeLeft();
+    snapshot.hud.coordinates = glm::vec2(player_->GetPosition().x, player_->GetPosition().y);
+    snapshot.hud.discs = player_->goalObjectsCollected_;
+
+    snapshot.list_sizes[LIST_GAME_OBJECTS] = (int) game_objects_.size();
+    snapshot.list_sizes[LIST_BULLETS] = (int) bullets_.size();
+    snapshot.list_sizes[LIST_COLLECTIBLES] = (int) collectibles_.size();
+    snapshot.list_sizes[LIST_POTIONS] = (int) potions_.size();
+    snapshot.list_sizes[LIST_DISCS] = (int) discs_.size();
+    snapshot.list_sizes[LIST_BOMBS] = (int) bombs_.size();
+    snapshot.list_sizes[LIST_EXPLOSIONS] = (int) explosions_.size();
+}
+
+
+//spawns bullet
+void Simulation::SpawnBullet(glm::vec3 position, glm::vec3 direction, GLuint texture, float speed, bool isFriendlyProjectile) {
+
+    position.z = 0.0f;
+
+    //if can shoot
+    if (current_time_ - lastShotTime_ >= shotCooldown_) {
+        GLuint bulletTexture = texture; 
+        float bulletSpeed = speed;
+        BulletGameObject * bullet = new BulletGameObject(position, res_.sprite, res_.sprite_shader, bulletTexture, direction, bulletSpeed, isFriendlyProjectile);
+        bullets_.push_back(bullet);
+        if (isFriendlyProjectile) { lastShotTime_ = current_time_; }
+        //make enemy bullets smaller
+        if (!isFriendlyProjectile) { bullets_.back()->SetScale(glm::vec2(0.4f, 0.4f)); }
+        
+    }
+
+}
+
+void Simulation::SpawnOrbitEnemy(const glm::vec3& location) {
+    // Create a standard EnemyGameObject that will orbit around the OrbitEnemy
+    EnemyGameObject* orbitingObject = new EnemyGameObject(location, res_.sprite, res_.sprite_shader, res_.tex[18]);
+    orbitingObject->SetDisabled(true); // Disable its independent behavior
+    orbitingObject->Sleep(); // Moved by the OrbitEnemy, so it needs no updates of its own
+    orbitingObject->isOrbititnObject = true;
+    orbitingObject->SetRotation(pi_over_two);
+
+    // Add the orbiting object to the game's collection of game objects
+    game_objects_.push_back(orbitingObject);
+    game_objects_.back()->SetScale(glm::vec2(0.7f, 0.7f));
+
+    // Create the OrbitEnemy that will handle the orbiting
+    OrbitEnemy* orbitEnemy = new OrbitEnemy(this, location, res_.sprite, res_.sprite_shader, res_.tex[11], orbitingObject);
+
+    // Add the OrbitEnemy to the game's collection of game objects
+    game_objects_.push_back(orbitEnemy);
+    orbit_enemies_.push_back(orbitEnemy);
+}
+
+void Simulation::DropBombAtLocation(const glm::vec3& location) {
+    float blastRadius = 2.0f; // Example blast radius
+    float timeToExplode = 3.0f; // Bomb will explode after 3 seconds
+    GLuint texture = res_.tex[16];
+
+    BombGameObject* bomb = new BombGameObject(location, res_.sprite, res_.sprite_shader, texture, blastRadius, timeToExplode);
+    bombs_.push_back(bomb);
+}
+
+void Simulation::HandleBombExplosions() {
+    PROFILE_SCOPE("bomb explosions");
+
+    for (int i = 0; i < bombs_.size(); ++i) {
+        BombGameObject* bomb = bombs_[i];
+        if (bomb && bomb->HasExploded()) {
+            // Destroy the enemies within the blast radius
+            glm::vec3 bombPosition = bomb->GetPosition();
+            spatial_index_.QueryRadius(glm::vec2(bombPosition.x, bombPosition.y), bomb->GetBlastRadius(), QUERY_ENEMIES, query_hits_);
+            for (int j = 0; j < query_hits_.size(); j++) {
+                EnemyGameObject* curr_enemy = static_cast<EnemyGameObject*>(query_hits_[j].object);
+                if (!curr_enemy->IsMarkedForDeletion()) {
+                    DestroyEnemy(curr_enemy);
+                }
+            }
+
+            explosions_.push_back(new ExplosionGameObject(bomb->GetPosition(), res_.sprite, res_.sprite_shader, res_.tex[6]));
+            explosions_.back()->SetScale(glm::vec2(3.0f, 3.0f));
+            // Remove the bomb from the game
+            delete bomb;
+            bombs_[i] = nullptr;  // Avoid dangling pointer
+            bombs_.erase(bombs_.begin() + i);
+            --i; // Decrement index to account for the removed element
+        }
+    }
+    // Remove all nullptr entries after handling explosions
+    bombs_.erase(std::remove(bombs_.begin(), bombs_.end(), nullptr), bombs_.end());
+}
+
+
+void Simulation::RemoveDestroyedObjects(void)
+{
+    // Orbiting enemies let go of blades about to be deleted, and leave the
+    // list themselves when they are
+    int kept = 0;
+    for (int i = 0; i < orbit_enemies_.size(); i++) {
+        OrbitEnemy* orbit_enemy = orbit_enemies_[i];
+        if (orbit_enemy->GetOrbitObject() && orbit_enemy->GetOrbitObject()->IsMarkedForDeletion()) {
+            orbit_enemy->ReleaseOrbitObject();
+        }
+        if (!orbit_enemy->IsMarkedForDeletion()) {
+            orbit_enemies_[kept++] = orbit_enemy;
+        }
+    }
+    orbit_enemies_.resize(kept);
+
+    // The player at index 0 is never removed
+    kept = 1;
+    for (int i = 1; i < game_objects_.size(); i++) {
+        if (game_objects_[i]->IsMarkedForDeletion()) {
+            delete game_objects_[i];
+        }
+        else {
+            game_objects_[kept++] = game_objects_[i];
+        }
+    }
+    game_objects_.resize(kept);
+}
+
+
+
+
+int Simulation::CountScenarioObjects(int object) const
+{
+    int count = 0;
+    switch (object) {
+        case SCENARIO_ENEMY:
+        case SCENARIO_SHOOTER:
+            for (int i = 1; i < game_objects_.size(); i++) {
+                count += GetSpawnType(game_objects_[i]) == (object == SCENARIO_ENEMY ? SPAWN_ENEMY : SPAWN_SHOOTER) ? 1 : 0;
+            }
+            return count;
+        case SCENARIO_ORBIT_PAIR:
+            for (int i = 1; i < game_objects_.size(); i++) {
+                count += dynamic_cast<OrbitEnemy*>(game_objects_[i]) ? 2 : 0;
+            }
+            return count;
+        case SCENARIO_BULLET:
+        case SCENARIO_ENEMY_BULLET:
+            for (int i = 0; i < bullets_.size(); i++) {
+                count += bullets_[i]->isFriendly == (object == SCENARIO_BULLET) ? 1 : 0;
+            }
+            return count;
+        case SCENARIO_BOMB:
+            return (int) bombs_.size();
+        case SCENARIO_BONE:
+            return (int) collectibles_.size();
+        case SCENARIO_POTION:
+            return (int) potions_.size();
+        default:
+            return 0;
+    }
+}
+
+
+void Simulation::PlaceScenarioObstacle(const ScenarioObstacle &obstacle)
+{
+    glm::vec2 centre = glm::vec2(player_->GetPosition().x, player_->GetPosition().y) + obstacle.centre;
+    flow_field_.SetBlocked(centre - obstacle.half_size, centre + obstacle.half_size, true);
+}
+
+
+void Simulation::PlaceScenarioObjects(const ScenarioGroup &group, int count)
+{
+    ALLOCATION_TAG(TAG_SPAWNING);
+
+    glm::vec3 player_position = player_->GetPosition();
+
+    // Orbit pairs are two objects each
+    if (group.object == SCENARIO_ORBIT_PAIR) {
+        count /= 2;
+    }
+
+    for (int i = 0; i < count; i++) {
+        glm::vec2 offset = PickScenarioOffset(group);
+        glm::vec3 position(player_position.x + offset.x, player_position.y + offset.y, 0.0f);
+
+        switch (group.object) {
+            case SCENARIO_ENEMY:
+                game_objects_.push_back(new EnemyGameObject(position, res_.sprite, res_.sprite_shader, res_.tex[3]));
+                game_objects_.back()->SetRotation(pi_over_two);
+                break;
+            case SCENARIO_SHOOTER:
+                game_objects_.push_back(new ProjectileShootingEnemy(this, position, res_.sprite, res_.sprite_shader, res_.tex[12], res_.tex[5]));
+                break;
+            case SCENARIO_ORBIT_PAIR:
+                SpawnOrbitEnemy(position);
+                break;
+            case SCENARIO_BULLET:
+            case SCENARIO_ENEMY_BULLET: {
+                // Fired in a random direction, at the speed of the player's or an enemy's shots
+                bool friendly = group.object == SCENARIO_BULLET;
+                glm::vec3 direction = CalculateDirectionVector((float) (rand() % 360) * glm::pi<float>() / 180.0f);
+                bullets_.push_back(new BulletGameObject(position, res_.sprite, res_.sprite_shader, friendly ? res_.tex[9] : res_.tex[5],
+                                                        direction, friendly ? 7.0f : 3.0f, friendly));
+                if (!friendly) { bullets_.back()->SetScale(glm::vec2(0.4f, 0.4f)); }
+                break;
+            }
+            case SCENARIO_BOMB:
+                DropBombAtLocation(position);
+                break;
+            case SCENARIO_BONE:
+                collectibles_.push_back(new CollectibleGameObject(position, res_.sprite, res_.sprite_shader, res_.tex[7]));
+                collectibles_.back()->SetScale(glm::vec2(0.5f, 0.5f));
+                break;
+            case SCENARIO_POTION:
+                potions_.push_back(new PotionCollectibleGameObject(position, res_.sprite, res_.sprite_shader, res_.tex[17]));
+                potions_.back()->SetScale(glm::vec2(0.6f, 0.6f));
+                break;
+        }
+    }
+}
+
+
+int Simulation::GetNumObjects(void) const
+{
+    return (int) (game_objects_.size() + explosions_.size() + bullets_.size() + collectibles_.size() +
+                  discs_.size() + potions_.size() + bombs_.size());
+}
+
+
+void Simulation::AddBullet(BulletGameObject* bullet) {
+    bullets_.push_back(bullet);
+}
+
+glm::vec3 Simulation::CalculateDirectionVector(float angleRadians) {
+    return glm::vec3(cos(angleRadians), sin(angleRadians), 0.0f);
+}
+
+float Simulation::GetRotationAngleFromDirection(glm::vec3 direction) {
+    // Normalize the direction vector
+    glm::vec3 normalizedDirection = glm::normalize(direction);
+
+    // Calculate the angle in radians from the normalized direction vector
+    float angleRadians = atan2(normalizedDirection.y, normalizedDirection.x);
+
+    return angleRadians;
+}
+
+} // namespace game
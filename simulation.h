@@ -0,0 +1,283 @@
+#ifndef SIMULATION_H_
+#define SIMULATION_H_
+
+#include <atomic>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "geometry.h"
+#include "game_object.h"
+#include "explosion_game_object.h"
+#include "timer.h"
+#include "player_game_object.h"
+#include "enemy_game_object.h"
+#include "bullet_game_object.h"
+#include "collectible_game_object.h"
+#include "disc_collectible_game_object.h"
+#include "potion_collectible_game_object.h"
+#include "particle_system.h"
+#include "sparkle_particle_system.h"
+#include "bomb_game_object.h"
+#include "arena.h"
+#include "job_system.h"
+#include "collision_system.h"
+#include "update_scheduler.h"
+#include "spawn_director.h"
+#include "batch_kernels.h"
+#include "flow_field.h"
+#include "flock.h"
+#include "spatial_index.h"
+#include "render_snapshot.h"
+#include "scenario.h"
+
+namespace game {
+
+    class OrbitEnemy;
+
+    // State of the player's controls, sampled on the window thread
+    struct InputState {
+        bool forward;
+        bool backward;
+        bool turn_left;
+        bool turn_right;
+        bool strafe_left;
+        bool strafe_right;
+        bool boost;
+        bool fire;
+        bool drop_bomb;
+        bool next_broadphase; // switch to the next collision broadphase
+
+        // Cursor position relative to the centre of the window, in pixels
+        glm::vec2 aim;
+    };
+
+    // Graphics resources the game objects are created with
+    // Owned by the Game; the simulation only hands them out
+    struct SimulationResources {
+        Geometry *sprite;
+        Geometry *particles;
+        Geometry *sparkle_particles;
+        Shader *sprite_shader;
+        Shader *particle_shader;
+        Shader *sparkle_particle_shader;
+        GLuint *tex;
+    };
+
+    // Holds the game world and advances it one tick at a time
+    // Runs on its own thread and never touches the window or OpenGL; what
+    // should be drawn is copied out into render snapshots
+    class Simulation {
+
+        public:
+            // Constructor and destructor
+            Simulation(void);
+            ~Simulation();
+
+            // Set up the game world (game objects, etc.)
+            void Setup(const SimulationResources &resources);
+
+            // Advance the world by one tick
+            void Step(double delta_time, const InputState &input);
+
+            // Copy what should be drawn this tick into a snapshot
+            void BuildSnapshot(RenderSnapshot &snapshot);
+
+            // Spawn and despawn counters and the current spawn rate
+            const SpawnDirector &GetSpawnDirector(void) const { return spawn_director_; }
+
+            // Objects by position, for area queries; rebuilt during each tick's collision pass
+            const SpatialIndex &GetSpatialIndex(void) const { return spatial_index_; }
+            const FrameArenas &GetFrameArenas(void) const { return frame_arenas_; }
+
+            // Path field the chasing enemies follow; obstacles are set on it
+            FlowField &GetFlowField(void) { return flow_field_; }
+            const FlowField &GetFlowField(void) const { return flow_field_; }
+
+            // Instruction set of the bullet and steering batches; defaults to the best available
+            void SetKernelPath(int path) { kernel_path_ = path; }
+
+            // How collision pairs are found; one of BroadphaseType
+            void SetBroadphase(int type) { collision_system_.SetBroadphase(type); }
+            int GetBroadphase(void) const { return collision_system_.GetBroadphaseType(); }
+
+            // Let the spawn director spawn and despawn; on unless a load test owns the population
+            void SetSpawning(bool spawning) { spawning_ = spawning; }
+
+            // Nothing hurts the player, so load tests are not cut short
+            void SetInvulnerable(bool invulnerable) { invulnerable_ = invulnerable; }
+
+            // Print spawns, pickups, damage and explosions to std::cout; on
+            // unless a long headless run would be buried by them
+            void SetLogging(bool logging) { logging_ = logging; }
+
+            // Number of live objects of a ScenarioObject kind; orbit pairs count as two
+            int CountScenarioObjects(int object) const;
+
+            // Place objects of a scenario group around the player
+            void PlaceScenarioObjects(const ScenarioGroup &group, int count);
+
+            // Block the flow field under a scenario obstacle, placed around the player
+            void PlaceScenarioObstacle(const ScenarioObstacle &obstacle);
+
+            // Number of objects in the world, of every kind
+            int GetNumObjects(void) const;
+
+            // True once the player has won or died
+            bool IsGameOver(void) const { return game_over_; }
+
+            //math function
+            glm::vec3 CalculateDirectionVector(float angleRadians);
+
+            //math function
+            float GetRotationAngleFromDirection(glm::vec3 direction);
+
+            //spawn bullet with given inputs
+            void SpawnBullet(glm::vec3 position, glm::vec3 direction, GLuint texture, float speed, bool isFriendlyProjectile);
+
+            //add bullet to vector
+            void AddBullet(BulletGameObject* bullet);
+
+            //spawn orbit enemy at given location
+            void SpawnOrbitEnemy(const glm::vec3& location);
+
+        private:
+            // Graphics resources for new game objects
+            SimulationResources res_;
+
+            // Player object
+            PlayerGameObject *player_;
+
+            // List of game objects
+            std::vector<GameObject*> game_objects_;
+
+            //List of explosion objects
+            std::vector<ExplosionGameObject*> explosions_;
+
+            // list for bullets
+            std::vector<BulletGameObject*> bullets_;
+
+            // List of bone collectible objects
+            std::vector<CollectibleGameObject*> collectibles_;
+
+            // List of disc collectible objects
+            std::vector<DiscCollectibleGameObject*> discs_;
+
+            // list of potions
+            std::vector<PotionCollectibleGameObject*> potions_;
+
+            //list of bombs
+            std::vector<BombGameObject*> bombs_;
+
+            // Orbiting enemies, also in game_objects_, so their blades can be let go of before deletion
+            std::vector<OrbitEnemy*> orbit_enemies_;
+
+            // Grass Particle System
+            ParticleSystem* grass_particle_system_;
+
+            // Worker threads for per-frame jobs
+            JobSystem jobs_;
+
+            // Scratch memory of the current tick, one arena per job thread
+            // Reset when a tick starts, once the last one and its snapshot are done
+            FrameArenas frame_arenas_;
+
+            // Decides which objects update each tick
+            UpdateScheduler update_scheduler_;
+
+            // Bullets and chasing enemies gathered into arrays for the batch kernels
+            // The arrays and the list of chasers keep their capacity between ticks
+            BulletBatch bullet_batch_;
+            ChaseBatch chase_batch_;
+            std::vector<EnemyGameObject*> chasers_;
+            int kernel_path_;
+
+            // The chasing enemies, for separation, alignment and cohesion
+            Flock flock_;
+
+            // Shared path to the player for every chasing enemy
+            FlowField flow_field_;
+
+            // Collision detection, and the proxies and contacts of the current frame
+            CollisionSystem collision_system_;
+            std::vector<CollisionProxy> collision_proxies_;
+            std::vector<Contact> contacts_;
+
+            // Area queries over the collision proxies, and their results
+            SpatialIndex spatial_index_;
+            std::vector<QueryHit> query_hits_;
+
+            // Keep track of time
+            double current_time_;
+
+            // Decides when to spawn and despawn enemies and collectibles
+            SpawnDirector spawn_director_;
+
+            //total score
+            int score;
+
+            double lastShotTime_; // Time since the last shot was fired
+            const float shotCooldown_ = 1.0f; // Cooldown period in seconds
+
+            double lastBombTime_;
+            const float bombCooldown_ = 3.5f; // Cooldown period in seconds
+
+            // Load test switches
+            bool spawning_;
+            bool invulnerable_;
+            bool logging_;
+
+            // Set when the game has ended; read from the window thread
+            std::atomic<bool> game_over_;
+
+            // Handle user input
+            void HandleControls(double delta_time, const InputState &input);
+
+            // Update all the game objects
+            void Update(double delta_time);
+
+            //drops bomb at location
+            void DropBombAtLocation(const glm::vec3& location);
+
+            //handles updates for the bombs
+            void HandleBombExplosions();
+
+            // Despawn distant objects and spawn new ones within the population budget
+            void ManagePopulation(double delta_time);
+
+            // Remember where everything was at the start of the tick
+            void SavePositions(void);
+
+            // Move all bullets in one batch
+            void MoveBullets(double delta_time);
+
+            // Steer the intercepting enemies picked by the scheduler, around
+            // their neighbours and in one batch
+            void SteerScheduledEnemies(void);
+
+            // Spawn type of a game object, or -1 if it is not managed by the spawn director
+            int GetSpawnType(GameObject* object) const;
+
+            // Find collisions between objects and apply their responses
+            void HandleCollisions(void);
+
+            // Add an object to the list of collision proxies for this frame
+            // Swept objects collide along the whole path they took this tick
+            void AddCollisionProxy(GameObject* object, int kind, bool swept = false);
+
+            // Damage the player; returns true if the player died
+            bool DamagePlayer(void);
+
+            // Blow up an enemy and award points for it
+            void DestroyEnemy(EnemyGameObject* enemy);
+
+            // Delete the enemies destroyed or despawned this tick and take them out of game_objects_
+            // Runs once the collisions and blasts are done, since the spatial index still holds them until then
+            void RemoveDestroyedObjects(void);
+
+    }; // class Simulation
+
+} // namespace game
+
+#endif // SIMULATION_H_
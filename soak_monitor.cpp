@@ -0,0 +1,176 @@
+#include <cstdio>
+
+#include "soak_monitor.h"
+
+namespace game {
+
+const int SoakMonitor::MIN_SAMPLES;
+
+static const char *series_names_g[NUM_SOAK_SERIES] = {
+    "resident bytes", "live allocations", "unowned objects",
+    "game objects", "bullets", "collectibles", "potions", "discs", "bombs", "explosions"
+};
+
+static const char *subsystems_g[NUM_SOAK_SERIES] = {
+    "process memory", "heap", "object deletion",
+    "enemies and spawning", "bullets", "collectibles", "potions", "discs", "bombs", "explosions"
+};
+
+// Growth below which a series never fails, whatever its mean
+static const double growth_floors_g[NUM_SOAK_SERIES] = {
+    8.0 * 1024 * 1024, 2000.0, 16.0,
+    64.0, 64.0, 16.0, 16.0, 1.0, 4.0, 16.0
+};
+
+// Growth, as a share of the mean, above which a series fails
+static const double growth_share_g = 0.1;
+
+
+const char *GetSoakSeriesName(int series)
+{
+    return series >= 0 && series < NUM_SOAK_SERIES ? series_names_g[series] : "unknown";
+}
+
+
+const char *GetSoakSubsystem(int series)
+{
+    return series >= 0 && series < NUM_SOAK_SERIES ? subsystems_g[series] : "unknown";
+}
+
+
+SoakMonitor::SoakMonitor(double warmup)
+{
+    warmup_ = warmup;
+}
+
+
+void SoakMonitor::AddSample(double time, const double values[NUM_SOAK_SERIES])
+{
+    Sample sample;
+    sample.time = time;
+    for (int i = 0; i < NUM_SOAK_SERIES; i++) {
+        sample.values[i] = values[i];
+    }
+    samples_.push_back(sample);
+}
+
+
+int SoakMonitor::GetFirstJudged(void) const
+{
+    int first = 0;
+    while (first < (int) samples_.size() && samples_[first].time < warmup_) {
+        first++;
+    }
+    return first;
+}
+
+
+std::vector<SoakGrowth> SoakMonitor::FindGrowth(void) const
+{
+    std::vector<SoakGrowth> growing;
+    int first = GetFirstJudged();
+    int count = (int) samples_.size() - first;
+    if (count < MIN_SAMPLES) {
+        return growing;
+    }
+
+    double mean_time = 0.0;
+    for (int i = first; i < (int) samples_.size(); i++) {
+        mean_time += samples_[i].time;
+    }
+    mean_time /= count;
+    double span = samples_.back().time - samples_[first].time;
+
+    for (int series = 0; series < NUM_SOAK_SERIES; series++) {
+        // Least squares line through the samples
+        double mean = 0.0;
+        for (int i = first; i < (int) samples_.size(); i++) {
+            mean += samples_[i].values[series];
+        }
+        mean /= count;
+        double covariance = 0.0, variance = 0.0;
+        for (int i = first; i < (int) samples_.size(); i++) {
+            double dt = samples_[i].time - mean_time;
+            covariance += dt * (samples_[i].values[series] - mean);
+            variance += dt * dt;
+        }
+        if (variance <= 0.0) {
+            continue;
+        }
+        double slope = covariance / variance;
+        double growth = slope * span;
+        if (growth > growth_floors_g[series] && growth > growth_share_g * mean) {
+            SoakGrowth found;
+            found.series = series;
+            found.first = mean + slope * (samples_[first].time - mean_time);
+            found.growth = growth;
+            found.per_hour = slope * 3600.0;
+            growing.push_back(found);
+        }
+    }
+    return growing;
+}
+
+
+bool SoakMonitor::IsConclusive(void) const
+{
+    return (int) samples_.size() - GetFirstJudged() >= MIN_SAMPLES;
+}
+
+
+bool SoakMonitor::PrintReport(void) const
+{
+    int first = GetFirstJudged();
+    int count = (int) samples_.size() - first;
+    printf("soak: %d samples over %.2f hours of game time, %d after the %.0f s warmup\n",
+           (int) samples_.size(), samples_.empty() ? 0.0 : samples_.back().time / 3600.0, count, warmup_);
+    if (count < MIN_SAMPLES) {
+        printf("soak: too few samples after the warmup to judge; run longer\n");
+        return false;
+    }
+
+    printf("%-18s %14s %14s %14s\n", "series", "first", "last", "max");
+    for (int series = 0; series < NUM_SOAK_SERIES; series++) {
+        double max = 0.0;
+        for (int i = first; i < (int) samples_.size(); i++) {
+            max = samples_[i].values[series] > max ? samples_[i].values[series] : max;
+        }
+        printf("%-18s %14.0f %14.0f %14.0f\n", series_names_g[series], samples_[first].values[series], samples_.back().values[series], max);
+    }
+
+    std::vector<SoakGrowth> growing = FindGrowth();
+    for (int i = 0; i < (int) growing.size(); i++) {
+        const SoakGrowth &found = growing[i];
+        printf("soak FAILED: %s grew by %.0f from %.0f (%.1f per hour); look at %s\n", series_names_g[found.series],
+               found.growth, found.first, found.per_hour, subsystems_g[found.series]);
+    }
+    if (growing.empty()) {
+        printf("soak passed: nothing grew\n");
+    }
+    return growing.empty();
+}
+
+
+bool SoakMonitor::WriteSamples(const std::string &path) const
+{
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "seconds");
+    for (int series = 0; series < NUM_SOAK_SERIES; series++) {
+        fprintf(file, ",%s", series_names_g[series]);
+    }
+    fprintf(file, "\n");
+    for (int i = 0; i < (int) samples_.size(); i++) {
+        fprintf(file, "%.1f", samples_[i].time);
+        for (int series = 0; series < NUM_SOAK_SERIES; series++) {
+            fprintf(file, ",%.0f", samples_[i].values[series]);
+        }
+        fprintf(file, "\n");
+    }
+    fclose(file);
+    return true;
+}
+
+} // namespace game
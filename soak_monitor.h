@@ -0,0 +1,82 @@
+#ifndef SOAK_MONITOR_H_
+#define SOAK_MONITOR_H_
+
+#include <string>
+#include <vector>
+
+#include "render_snapshot.h"
+
+namespace game {
+
+    // Figures sampled during a soak test
+    // The first few are process wide; the rest are the simulation's object
+    // lists, in ObjectList order
+    enum SoakSeries {
+        SOAK_RESIDENT_BYTES,   // memory of the process in RAM
+        SOAK_LIVE_ALLOCATIONS, // heap blocks not yet freed
+        SOAK_UNOWNED_OBJECTS,  // game objects alive that no list of the simulation holds
+        SOAK_FIRST_LIST,
+        NUM_SOAK_SERIES = SOAK_FIRST_LIST + NUM_OBJECT_LISTS
+    };
+
+    // Name of a series, and the part of the game to look at when it grows
+    const char *GetSoakSeriesName(int series);
+    const char *GetSoakSubsystem(int series);
+
+    // A series that kept growing after the warmup
+    struct SoakGrowth {
+        int series;
+        double first;     // fitted value at the first sample after the warmup
+        double growth;    // fitted growth from then to the last sample
+        double per_hour;  // the same per hour of game time
+    };
+
+    // Collects samples over a long run and finds the figures that trend upward
+    // Samples taken during the warmup, while the world fills up, are kept
+    // but not judged. After it, a straight line is fitted to each series,
+    // and a series fails when the line rises by more than a tenth of its
+    // mean and by more than a floor set for its kind, so the normal
+    // coming and going of objects does not count
+    class SoakMonitor {
+
+        public:
+            // Constructor; warmup is in seconds of game time
+            SoakMonitor(double warmup);
+
+            // Add the figures at the given time, one per SoakSeries
+            void AddSample(double time, const double values[NUM_SOAK_SERIES]);
+
+            int GetNumSamples(void) const { return (int) samples_.size(); }
+
+            // Series growing after the warmup; empty when there are too few samples to tell
+            std::vector<SoakGrowth> FindGrowth(void) const;
+
+            // Whether enough samples came after the warmup to judge growth
+            bool IsConclusive(void) const;
+
+            // Print each series and whether it grew; returns false if any did,
+            // or if the run was too short to tell
+            bool PrintReport(void) const;
+
+            // Write every sample as CSV, one row per sample
+            bool WriteSamples(const std::string &path) const;
+
+            // Samples needed after the warmup before growth is judged
+            static const int MIN_SAMPLES = 8;
+
+        private:
+            struct Sample {
+                double time;
+                double values[NUM_SOAK_SERIES];
+            };
+            std::vector<Sample> samples_;
+            double warmup_;
+
+            // Index of the first sample after the warmup
+            int GetFirstJudged(void) const;
+
+    }; // class SoakMonitor
+
+} // namespace game
+
+#endif // SOAK_MONITOR_H_
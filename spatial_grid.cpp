@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cmath>
+#include <new>
+
+#include "spatial_grid.h"
+
+namespace game {
+
+SpatialGrid::SpatialGrid(float cell_size)
+    : lookup_arena_(16 * 1024), cell_lookup_(0, std::hash<uint64_t>(), std::equal_to<uint64_t>(), LookupAllocator(&lookup_arena_))
+{
+    cell_size_ = cell_size;
+    cell_start_.push_back(0);
+}
+
+
+void SpatialGrid::Clear(void)
+{
+    entries_.clear();
+    ids_.clear();
+    cell_start_.clear();
+    cell_start_.push_back(0);
+    cell_coords_.clear();
+    ResetLookup();
+}
+
+
+void SpatialGrid::Insert(int id, const glm::vec2 &position)
+{
+    glm::ivec2 coords = GetCoords(position);
+    Entry entry;
+    entry.key = MakeKey(coords.x, coords.y);
+    entry.id = id;
+    entries_.push_back(entry);
+}
+
+
+void SpatialGrid::Build(void)
+{
+    // Sort by cell, keeping insertion order inside a cell so results do not
+    // depend on the sort implementation
+    std::sort(entries_.begin(), entries_.end(), [](const Entry &a, const Entry &b) {
+        return a.key != b.key ? a.key < b.key : a.id < b.id;
+    });
+
+    ids_.resize(entries_.size());
+    cell_start_.clear();
+    cell_coords_.clear();
+    ResetLookup();
+    cell_lookup_.reserve(entries_.size());
+
+    for (int i = 0; i < (int) entries_.size(); i++) {
+        if (i == 0 || entries_[i].key != entries_[i - 1].key) {
+            uint64_t key = entries_[i].key;
+            cell_lookup_[key] = (int) cell_start_.size();
+            cell_start_.push_back(i);
+            cell_coords_.push_back(glm::ivec2((int) (uint32_t) (key >> 32), (int) (uint32_t) key));
+        }
+        ids_[i] = entries_[i].id;
+    }
+    cell_start_.push_back((int) entries_.size());
+}
+
+
+void SpatialGrid::ResetLookup(void)
+{
+    // The old lookup is destroyed while its arena still holds it, and the
+    // new one made after the reset, since some libraries allocate even for
+    // an empty map
+    cell_lookup_.~CellLookup();
+    lookup_arena_.Reset();
+    new (&cell_lookup_) CellLookup(0, std::hash<uint64_t>(), std::equal_to<uint64_t>(), LookupAllocator(&lookup_arena_));
+}
+
+
+int SpatialGrid::FindCell(int cx, int cy) const
+{
+    auto it = cell_lookup_.find(MakeKey(cx, cy));
+    if (it == cell_lookup_.end()) {
+        return -1;
+    }
+    return it->second;
+}
+
+
+glm::ivec2 SpatialGrid::GetCoords(const glm::vec2 &position) const
+{
+    return glm::ivec2((int) std::floor(position.x / cell_size_), (int) std::floor(position.y / cell_size_));
+}
+
+
+uint64_t SpatialGrid::MakeKey(int cx, int cy)
+{
+    return ((uint64_t) (uint32_t) cx << 32) | (uint64_t) (uint32_t) cy;
+}
+
+} // namespace game
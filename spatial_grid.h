@@ -0,0 +1,87 @@
+#ifndef SPATIAL_GRID_H_
+#define SPATIAL_GRID_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "arena.h"
+
+namespace game {
+
+    // A uniform grid that buckets points by the cell they fall in
+    // Rebuilt from scratch every frame: Clear(), Insert() each item, then Build()
+    class SpatialGrid {
+
+        public:
+            // Constructor
+            SpatialGrid(float cell_size = 2.0f);
+
+            // Remove all items
+            void Clear(void);
+
+            // Add an item to the grid; id is returned by the cell queries
+            void Insert(int id, const glm::vec2 &position);
+
+            // Sort the items into their cells; call after the last Insert()
+            void Build(void);
+
+            // Number of occupied cells after Build()
+            int GetNumCells(void) const { return (int) cell_start_.size() - 1; }
+
+            // Items in an occupied cell, given by index in [0, GetNumCells())
+            const int *GetCellItems(int cell) const { return &ids_[cell_start_[cell]]; }
+            int GetCellSize(int cell) const { return cell_start_[cell + 1] - cell_start_[cell]; }
+
+            // Grid coordinates of an occupied cell
+            glm::ivec2 GetCellCoords(int cell) const { return cell_coords_[cell]; }
+
+            // Index of the occupied cell at the given grid coordinates, or -1 if empty
+            int FindCell(int cx, int cy) const;
+
+            // Grid coordinates of a world position
+            glm::ivec2 GetCoords(const glm::vec2 &position) const;
+
+            // Getters
+            float GetCellLength(void) const { return cell_size_; }
+
+            // Change the cell size; takes effect from the next Clear()
+            void SetCellLength(float cell_size) { cell_size_ = cell_size; }
+
+        private:
+            // Pack grid coordinates into a single sortable key
+            static uint64_t MakeKey(int cx, int cy);
+
+            float cell_size_;
+
+            // Items as inserted
+            struct Entry {
+                uint64_t key;
+                int id;
+            };
+            std::vector<Entry> entries_;
+
+            // Items sorted by cell, and where each cell starts in that list
+            std::vector<int> ids_;
+            std::vector<int> cell_start_;
+            std::vector<glm::ivec2> cell_coords_;
+
+            // Lookup from cell key to occupied cell index
+            // Its nodes live in an arena of the grid's own, reset with each
+            // rebuild, so building the grid does not touch the heap once the
+            // arena has grown to fit. The grid is read until it is rebuilt,
+            // which may be in the next tick, so a tick's arena will not do
+            typedef ArenaAllocator<std::pair<const uint64_t, int> > LookupAllocator;
+            typedef std::unordered_map<uint64_t, int, std::hash<uint64_t>, std::equal_to<uint64_t>, LookupAllocator> CellLookup;
+            Arena lookup_arena_;
+            CellLookup cell_lookup_;
+
+            // Empty the lookup and reset its arena
+            void ResetLookup(void);
+
+    }; // class SpatialGrid
+
+} // namespace game
+
+#endif // SPATIAL_GRID_H_
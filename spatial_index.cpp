@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cmath>
+
+#include "spatial_index.h"
+
+namespace game {
+
+SpatialIndex::SpatialIndex(float cell_size)
+    : grid_(cell_size)
+{
+    bounds_low_ = glm::ivec2(0, 0);
+    bounds_high_ = glm::ivec2(-1, -1);
+}
+
+
+void SpatialIndex::Build(const std::vector<CollisionProxy> &proxies)
+{
+    entries_.resize(proxies.size());
+    grid_.Clear();
+    bounds_low_ = glm::ivec2(0, 0);
+    bounds_high_ = glm::ivec2(-1, -1);
+
+    for (int i = 0; i < (int) proxies.size(); i++) {
+        entries_[i].object = proxies[i].object;
+        entries_[i].position = proxies[i].position;
+        entries_[i].kind = proxies[i].kind;
+        grid_.Insert(i, proxies[i].position);
+
+        glm::ivec2 coords = grid_.GetCoords(proxies[i].position);
+        if (i == 0) {
+            bounds_low_ = bounds_high_ = coords;
+        }
+        else {
+            bounds_low_ = glm::ivec2(std::min(bounds_low_.x, coords.x), std::min(bounds_low_.y, coords.y));
+            bounds_high_ = glm::ivec2(std::max(bounds_high_.x, coords.x), std::max(bounds_high_.y, coords.y));
+        }
+    }
+    grid_.Build();
+}
+
+
+template <typename Visitor>
+void SpatialIndex::VisitCells(const glm::ivec2 &low, const glm::ivec2 &high, Visitor visit) const
+{
+    // Nothing lies outside the bounds of the entries
+    int x0 = std::max(low.x, bounds_low_.x);
+    int y0 = std::max(low.y, bounds_low_.y);
+    int x1 = std::min(high.x, bounds_high_.x);
+    int y1 = std::min(high.y, bounds_high_.y);
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+
+    // Large areas are cheaper to cover by walking the occupied cells
+    long long area = (long long) (x1 - x0 + 1) * (long long) (y1 - y0 + 1);
+    if (area > grid_.GetNumCells()) {
+        for (int cell = 0; cell < grid_.GetNumCells(); cell++) {
+            glm::ivec2 coords = grid_.GetCellCoords(cell);
+            if (coords.x < x0 || coords.x > x1 || coords.y < y0 || coords.y > y1) {
+                continue;
+            }
+            const int *items = grid_.GetCellItems(cell);
+            for (int i = 0; i < grid_.GetCellSize(cell); i++) {
+                visit(items[i]);
+            }
+        }
+        return;
+    }
+
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            int cell = grid_.FindCell(cx, cy);
+            if (cell < 0) {
+                continue;
+            }
+            const int *items = grid_.GetCellItems(cell);
+            for (int i = 0; i < grid_.GetCellSize(cell); i++) {
+                visit(items[i]);
+            }
+        }
+    }
+}
+
+
+static bool ById(const QueryHit &a, const QueryHit &b)
+{
+    return a.id < b.id;
+}
+
+
+void SpatialIndex::QueryRadius(const glm::vec2 &centre, float radius, unsigned int kinds, std::vector<QueryHit> &hits) const
+{
+    hits.clear();
+    float radius_squared = radius * radius;
+    glm::vec2 extent(radius, radius);
+
+    VisitCells(grid_.GetCoords(centre - extent), grid_.GetCoords(centre + extent), [&](int id) {
+        const Entry &entry = entries_[id];
+        if (!(kinds & QueryMask(entry.kind))) {
+            return;
+        }
+        glm::vec2 offset = entry.position - centre;
+        float distance_squared = glm::dot(offset, offset);
+        if (distance_squared <= radius_squared) {
+            QueryHit hit;
+            hit.object = entry.object;
+            hit.kind = entry.kind;
+            hit.id = id;
+            hit.distance_squared = distance_squared;
+            hits.push_back(hit);
+        }
+    });
+
+    std::sort(hits.begin(), hits.end(), ById);
+}
+
+
+void SpatialIndex::QueryAABB(const glm::vec2 &low, const glm::vec2 &high, unsigned int kinds, std::vector<QueryHit> &hits) const
+{
+    hits.clear();
+
+    VisitCells(grid_.GetCoords(low), grid_.GetCoords(high), [&](int id) {
+        const Entry &entry = entries_[id];
+        if (!(kinds & QueryMask(entry.kind))) {
+            return;
+        }
+        if (entry.position.x >= low.x && entry.position.y >= low.y &&
+            entry.position.x <= high.x && entry.position.y <= high.y) {
+            QueryHit hit;
+            hit.object = entry.object;
+            hit.kind = entry.kind;
+            hit.id = id;
+            hit.distance_squared = 0.0f;
+            hits.push_back(hit);
+        }
+    });
+
+    std::sort(hits.begin(), hits.end(), ById);
+}
+
+
+bool SpatialIndex::QueryNearest(const glm::vec2 &point, float max_distance, unsigned int kinds, QueryHit &hit) const
+{
+    glm::ivec2 centre = grid_.GetCoords(point);
+    float cell = grid_.GetCellLength();
+    float best = max_distance * max_distance;
+    bool found = false;
+
+    auto consider = [&](int id) {
+        const Entry &entry = entries_[id];
+        if (!(kinds & QueryMask(entry.kind))) {
+            return;
+        }
+        glm::vec2 offset = entry.position - point;
+        float distance_squared = glm::dot(offset, offset);
+        // Ties go to the first proxy, so the answer does not depend on visiting order
+        if (distance_squared < best || (distance_squared == best && (!found || id < hit.id))) {
+            best = distance_squared;
+            found = true;
+            hit.object = entry.object;
+            hit.kind = entry.kind;
+            hit.id = id;
+            hit.distance_squared = distance_squared;
+        }
+    };
+
+    // Search rings of cells outwards. Everything beyond ring r is at least
+    // r cells away, so the search stops once the best hit is closer than that
+    int max_ring = (int) std::ceil(max_distance / cell) + 1;
+    for (int ring = 0; ring <= max_ring; ring++) {
+        float reach = (ring - 1) * cell;
+        if (ring > 0 && reach > 0.0f && reach * reach > best) {
+            break;
+        }
+
+        // Rings entirely outside the entries' bounds hold nothing, and neither do any farther out
+        if (centre.x - ring < bounds_low_.x && centre.x + ring > bounds_high_.x &&
+            centre.y - ring < bounds_low_.y && centre.y + ring > bounds_high_.y) {
+            break;
+        }
+
+        if (ring == 0) {
+            VisitCells(centre, centre, consider);
+            continue;
+        }
+        // Top and bottom rows, then the columns between them
+        VisitCells(glm::ivec2(centre.x - ring, centre.y - ring), glm::ivec2(centre.x + ring, centre.y - ring), consider);
+        VisitCells(glm::ivec2(centre.x - ring, centre.y + ring), glm::ivec2(centre.x + ring, centre.y + ring), consider);
+        VisitCells(glm::ivec2(centre.x - ring, centre.y - ring + 1), glm::ivec2(centre.x - ring, centre.y + ring - 1), consider);
+        VisitCells(glm::ivec2(centre.x + ring, centre.y - ring + 1), glm::ivec2(centre.x + ring, centre.y + ring - 1), consider);
+    }
+
+    return found;
+}
+
+} // namespace game
@@ -0,0 +1,77 @@
+#ifndef SPATIAL_INDEX_H_
+#define SPATIAL_INDEX_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "collision_system.h"
+#include "spatial_grid.h"
+
+namespace game {
+
+    // Filters for the kinds of object a query returns: one bit per ColliderKind
+    inline unsigned int QueryMask(int kind) { return 1u << kind; }
+    const unsigned int QUERY_ALL = ~0u;
+    const unsigned int QUERY_ENEMIES = (1u << COLLIDER_ENEMY) | (1u << COLLIDER_ORBIT_ENEMY);
+    const unsigned int QUERY_PICKUPS = (1u << COLLIDER_BONE) | (1u << COLLIDER_POTION) | (1u << COLLIDER_DISC);
+
+    // An object found by a query
+    struct QueryHit {
+        GameObject *object;
+        int kind;
+        int id;                 // index of the object's proxy
+        float distance_squared; // from the query point; 0 for area queries
+    };
+
+    // Answers "what is near here" questions about the world
+    // Built once a tick from the collision proxies, then queried by
+    // anything that needs objects in an area: bomb blasts, aggro checks
+    // and the like. Queries only visit the grid cells their area touches,
+    // so their cost follows the number of objects nearby rather than the
+    // size of the world. Hits come back in the order the proxies were
+    // given, so responses to them are applied the same way every run
+    class SpatialIndex {
+
+        public:
+            // Constructor
+            SpatialIndex(float cell_size = 4.0f);
+
+            // Index the proxies; they are copied, so the list can change afterwards
+            void Build(const std::vector<CollisionProxy> &proxies);
+
+            // Objects of the given kinds within radius of centre
+            void QueryRadius(const glm::vec2 &centre, float radius, unsigned int kinds, std::vector<QueryHit> &hits) const;
+
+            // Objects of the given kinds inside the box [low, high]
+            void QueryAABB(const glm::vec2 &low, const glm::vec2 &high, unsigned int kinds, std::vector<QueryHit> &hits) const;
+
+            // Closest object of the given kinds within max_distance of point
+            // Returns false if there is none
+            bool QueryNearest(const glm::vec2 &point, float max_distance, unsigned int kinds, QueryHit &hit) const;
+
+            // Number of indexed objects
+            int GetSize(void) const { return (int) entries_.size(); }
+
+        private:
+            struct Entry {
+                GameObject *object;
+                glm::vec2 position;
+                int kind;
+            };
+
+            // Visit the entries of the cells in [low, high] (grid coordinates)
+            template <typename Visitor>
+            void VisitCells(const glm::ivec2 &low, const glm::ivec2 &high, Visitor visit) const;
+
+            std::vector<Entry> entries_;
+            SpatialGrid grid_;
+
+            // Grid coordinates covering every entry
+            glm::ivec2 bounds_low_;
+            glm::ivec2 bounds_high_;
+
+    }; // class SpatialIndex
+
+} // namespace game
+
+#endif // SPATIAL_INDEX_H_
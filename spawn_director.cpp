@@ -0,0 +1,73 @@
+#include <algorithm>
+
+#include "spawn_director.h"
+
+namespace game {
+
+// Lowest the spawn rate is scaled down to while over budget
+static const float min_rate_scale_g = 0.1f;
+
+// How fast the rate scale falls while over budget and recovers when under, per second
+static const float rate_drop_g = 0.5f;
+static const float rate_recovery_g = 0.1f;
+
+// Weight of a new sample in the smoothed tick time
+static const double frame_time_smoothing_g = 0.05;
+
+
+SpawnDirector::SpawnDirector(void)
+{
+    for (int i = 0; i < NUM_SPAWN_TYPES; i++) {
+        interval_[i] = 1.0;
+        cap_[i] = 0;
+        despawn_distance_[i] = 0.0f;
+        clock_[i] = 0.0;
+    }
+    frame_time_ = 0.0;
+    frame_budget_ = 0.008;
+    rate_scale_ = 1.0f;
+    counters_ = SpawnCounters();
+}
+
+
+void SpawnDirector::ReportFrameTime(double seconds)
+{
+    frame_time_ += (seconds - frame_time_) * frame_time_smoothing_g;
+}
+
+
+void SpawnDirector::Update(double delta_time, const int population[NUM_SPAWN_TYPES], int spawns[NUM_SPAWN_TYPES])
+{
+    // Back off while ticks take too long; recover once there is headroom
+    if (frame_time_ > frame_budget_) {
+        rate_scale_ = std::max(min_rate_scale_g, rate_scale_ - rate_drop_g * (float) delta_time);
+    }
+    else if (frame_time_ < 0.8 * frame_budget_) {
+        rate_scale_ = std::min(1.0f, rate_scale_ + rate_recovery_g * (float) delta_time);
+    }
+
+    for (int i = 0; i < NUM_SPAWN_TYPES; i++) {
+        spawns[i] = 0;
+
+        // A full population holds its clock, so nothing piles up to spawn
+        // in a burst as soon as there is room again
+        if (population[i] >= cap_[i]) {
+            continue;
+        }
+
+        clock_[i] += delta_time * rate_scale_;
+        if (clock_[i] >= interval_[i]) {
+            clock_[i] -= interval_[i];
+            spawns[i] = 1;
+        }
+    }
+}
+
+
+bool SpawnDirector::ShouldDespawn(int type, float distance_squared) const
+{
+    float distance = despawn_distance_[type];
+    return distance > 0.0f && distance_squared > distance * distance;
+}
+
+} // namespace game
@@ -0,0 +1,80 @@
+#ifndef SPAWN_DIRECTOR_H_
+#define SPAWN_DIRECTOR_H_
+
+namespace game {
+
+    // Kinds of objects the director spawns
+    enum SpawnType {
+        SPAWN_ENEMY,
+        SPAWN_SHOOTER,
+        SPAWN_BONE,
+        SPAWN_POTION,
+        NUM_SPAWN_TYPES
+    };
+
+    // Running totals of spawned and despawned objects, by type
+    struct SpawnCounters {
+        int spawned[NUM_SPAWN_TYPES];
+        int despawned[NUM_SPAWN_TYPES];
+    };
+
+    // Keeps the population of spawned objects within budget
+    // Each type has a spawn interval, a population cap and a distance from
+    // the player past which it is despawned. Spawning slows down while the
+    // measured tick time is over budget and recovers once it is back under
+    class SpawnDirector {
+
+        public:
+            // Constructor
+            SpawnDirector(void);
+
+            // Configuration of a type
+            void SetInterval(int type, double seconds) { interval_[type] = seconds; }
+            void SetFirstSpawn(int type, double seconds) { clock_[type] = interval_[type] - seconds; }
+            void SetCap(int type, int cap) { cap_[type] = cap; }
+            void SetDespawnDistance(int type, float distance) { despawn_distance_[type] = distance; }
+
+            // Tick time the population should fit in, in seconds
+            void SetFrameBudget(double seconds) { frame_budget_ = seconds; }
+
+            // Report how long the last tick took to simulate
+            void ReportFrameTime(double seconds);
+
+            // Advance the spawn clocks and decide how many of each type to spawn now
+            // population holds the current number of objects of each type
+            void Update(double delta_time, const int population[NUM_SPAWN_TYPES], int spawns[NUM_SPAWN_TYPES]);
+
+            // True if an object of the given type this far from the player should go
+            bool ShouldDespawn(int type, float distance_squared) const;
+
+            // Record spawns and despawns done by the caller
+            void CountSpawn(int type) { counters_.spawned[type]++; }
+            void CountDespawn(int type) { counters_.despawned[type]++; }
+
+            // Getters
+            const SpawnCounters &GetCounters(void) const { return counters_; }
+            double GetFrameTime(void) const { return frame_time_; }
+            float GetRateScale(void) const { return rate_scale_; }
+
+        private:
+            double interval_[NUM_SPAWN_TYPES];
+            int cap_[NUM_SPAWN_TYPES];
+            float despawn_distance_[NUM_SPAWN_TYPES];
+
+            // Time gathered towards the next spawn of each type
+            double clock_[NUM_SPAWN_TYPES];
+
+            // Smoothed tick time and the budget it is held to
+            double frame_time_;
+            double frame_budget_;
+
+            // Multiplier on the spawn rate, lowered while over budget
+            float rate_scale_;
+
+            SpawnCounters counters_;
+
+    }; // class SpawnDirector
+
+} // namespace game
+
+#endif // SPAWN_DIRECTOR_H_
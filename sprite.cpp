@@ -59,6 +59,7 @@ void Sprite::SetGeometry(GLuint shader_program)
     // No blending
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
     glDisable(GL_BLEND);
 
     // Bind buffers
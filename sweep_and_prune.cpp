@@ -0,0 +1,108 @@
+#include <algorithm>
+
+#include "collision_system.h"
+#include "sweep_and_prune.h"
+
+namespace game {
+
+SweepAndPrune::SweepAndPrune(void)
+{
+    num_swaps_ = 0;
+}
+
+
+SweepAndPrune::Interval SweepAndPrune::MakeInterval(const std::vector<CollisionProxy> &proxies, int id)
+{
+    const CollisionProxy &proxy = proxies[id];
+    float reach = proxy.shape.bounding_radius;
+    Interval interval;
+    interval.min_x = proxy.position.x - reach;
+    interval.max_x = proxy.position.x + reach;
+    interval.min_y = proxy.position.y - reach;
+    interval.max_y = proxy.position.y + reach;
+    interval.id = id;
+    return interval;
+}
+
+
+int SweepAndPrune::Build(const std::vector<CollisionProxy> &proxies)
+{
+    int count = (int) proxies.size();
+
+    // Proxy index of each object this frame
+    index_of_.clear();
+    for (int i = 0; i < count; i++) {
+        if (proxies[i].object) {
+            index_of_[proxies[i].object] = i;
+        }
+    }
+
+    // Objects still around keep their place from last frame
+    intervals_.clear();
+    placed_.assign(count, 0);
+    for (int i = 0; i < (int) previous_order_.size(); i++) {
+        auto found = index_of_.find(previous_order_[i]);
+        if (found == index_of_.end() || placed_[found->second]) {
+            continue;
+        }
+        placed_[found->second] = 1;
+        intervals_.push_back(MakeInterval(proxies, found->second));
+    }
+    int carried = (int) intervals_.size();
+
+    // Repair their order for this frame's movement. If things moved so far
+    // that the repair is no longer cheap, sort them from scratch instead
+    num_swaps_ = 0;
+    int swap_limit = 8 * carried + 64;
+    for (int i = 1; i < carried && num_swaps_ <= swap_limit; i++) {
+        Interval moving = intervals_[i];
+        int j = i;
+        while (j > 0 && Before(moving, intervals_[j - 1])) {
+            intervals_[j] = intervals_[j - 1];
+            j--;
+            num_swaps_++;
+        }
+        intervals_[j] = moving;
+    }
+    if (num_swaps_ > swap_limit) {
+        std::sort(intervals_.begin(), intervals_.end(), Before);
+    }
+
+    // New objects are sorted on their own and merged in
+    for (int i = 0; i < count; i++) {
+        if (!placed_[i]) {
+            intervals_.push_back(MakeInterval(proxies, i));
+        }
+    }
+    std::sort(intervals_.begin() + carried, intervals_.end(), Before);
+    std::inplace_merge(intervals_.begin(), intervals_.begin() + carried, intervals_.end(), Before);
+
+    previous_order_.resize(count);
+    for (int i = 0; i < count; i++) {
+        previous_order_[i] = proxies[intervals_[i].id].object;
+    }
+    return count;
+}
+
+
+void SweepAndPrune::FindPairs(const std::vector<CollisionProxy> &proxies, int begin, int end, std::vector<ProxyPair> &pairs) const
+{
+    int count = (int) intervals_.size();
+    for (int i = begin; i < end; i++) {
+        const Interval &a = intervals_[i];
+
+        // Everything that starts before this interval ends overlaps it along x
+        for (int j = i + 1; j < count && intervals_[j].min_x <= a.max_x; j++) {
+            const Interval &b = intervals_[j];
+            if (b.min_y > a.max_y || a.min_y > b.max_y) {
+                continue;
+            }
+            ProxyPair pair;
+            pair.a = std::min(a.id, b.id);
+            pair.b = std::max(a.id, b.id);
+            pairs.push_back(pair);
+        }
+    }
+}
+
+} // namespace game
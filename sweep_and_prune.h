@@ -0,0 +1,63 @@
+#ifndef SWEEP_AND_PRUNE_H_
+#define SWEEP_AND_PRUNE_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "broadphase.h"
+#include "game_object.h"
+
+namespace game {
+
+    // Broadphase that sorts the proxies' bounds along x and sweeps the list
+    // for overlapping intervals
+    // Objects move little between frames, so the list is kept in last
+    // frame's order and repaired with an insertion sort, which costs about
+    // one pass when little has changed. Objects new this frame are sorted
+    // on their own and merged in. Unlike the grid it has no cell size to
+    // get wrong, so it copes well with tight clusters and mixed sizes. Each
+    // proxy in sorted order is a unit of work
+    class SweepAndPrune : public Broadphase {
+
+        public:
+            // Constructor
+            SweepAndPrune(void);
+
+            int Build(const std::vector<CollisionProxy> &proxies) override;
+            void FindPairs(const std::vector<CollisionProxy> &proxies, int begin, int end, std::vector<ProxyPair> &pairs) const override;
+
+            // Moves the insertion sort made in the last Build()
+            int GetNumSwaps(void) const { return num_swaps_; }
+
+        private:
+            // Bounds of a proxy
+            struct Interval {
+                float min_x;
+                float max_x;
+                float min_y;
+                float max_y;
+                int id;
+            };
+
+            static Interval MakeInterval(const std::vector<CollisionProxy> &proxies, int id);
+
+            // Sort order along x; ties go to the lower index so the order is repeatable
+            static bool Before(const Interval &a, const Interval &b) { return a.min_x != b.min_x ? a.min_x < b.min_x : a.id < b.id; }
+
+            // Proxies sorted by the low end of their x interval
+            std::vector<Interval> intervals_;
+
+            // Objects in the order they were sorted last frame
+            std::vector<GameObject*> previous_order_;
+
+            // Scratch space for matching objects with this frame's proxies
+            std::unordered_map<GameObject*, int> index_of_;
+            std::vector<char> placed_;
+
+            int num_swaps_;
+
+    }; // class SweepAndPrune
+
+} // namespace game
+
+#endif // SWEEP_AND_PRUNE_H_
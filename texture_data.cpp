@@ -0,0 +1,372 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "texture_data.h"
+
+namespace game {
+
+static_assert(sizeof(TextureHeader) % 16 == 0, "texture header keeps the levels aligned");
+
+// Levels start on this boundary within a blob
+static const std::size_t level_alignment_g = 16;
+
+static const char *format_names_g[NUM_TEXTURE_FORMATS] = { "RGBA8", "BC1", "BC3" };
+
+
+const char *GetTextureFormatName(int format)
+{
+    return format >= 0 && format < NUM_TEXTURE_FORMATS ? format_names_g[format] : "unknown";
+}
+
+
+void PremultiplyAlpha(unsigned char *pixels, int width, int height)
+{
+    for (int i = 0; i < width * height; i++) {
+        unsigned char *texel = pixels + i * 4;
+        for (int c = 0; c < 3; c++) {
+            texel[c] = (unsigned char) ((texel[c] * texel[3] + 127) / 255);
+        }
+    }
+}
+
+
+bool HasTransparency(const unsigned char *pixels, int width, int height)
+{
+    for (int i = 0; i < width * height; i++) {
+        if (pixels[i * 4 + 3] != 255) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+std::size_t GetLevelSize(int format, int width, int height)
+{
+    std::size_t blocks = (std::size_t) ((width + 3) / 4) * ((height + 3) / 4);
+    switch (format) {
+        case TEXTURE_BC1:
+            return blocks * 8;
+        case TEXTURE_BC3:
+            return blocks * 16;
+        default:
+            return (std::size_t) width * height * 4;
+    }
+}
+
+
+// Half the size of a level, averaging each 2x2 group of texels
+static void Downsample(const std::vector<unsigned char> &source, int width, int height, std::vector<unsigned char> &level)
+{
+    int half_width = std::max(1, width / 2);
+    int half_height = std::max(1, height / 2);
+    level.resize((std::size_t) half_width * half_height * 4);
+    for (int y = 0; y < half_height; y++) {
+        int y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+        for (int x = 0; x < half_width; x++) {
+            int x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+            for (int c = 0; c < 4; c++) {
+                int sum = source[(y0 * width + x0) * 4 + c] + source[(y0 * width + x1) * 4 + c] +
+                          source[(y1 * width + x0) * 4 + c] + source[(y1 * width + x1) * 4 + c];
+                level[(y * half_width + x) * 4 + c] = (unsigned char) ((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+
+static uint16_t PackColor(const int rgb[3])
+{
+    return (uint16_t) (((rgb[0] * 31 + 127) / 255) << 11 | ((rgb[1] * 63 + 127) / 255) << 5 | ((rgb[2] * 31 + 127) / 255));
+}
+
+
+static void UnpackColor(uint16_t packed, int rgb[3])
+{
+    int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+
+// The four colours of a block between its two endpoints; with three_colour
+// the third is the midpoint and the fourth transparent black, as BC1 decodes
+// blocks whose first endpoint is not the larger
+static void MakePalette(uint16_t c0, uint16_t c1, bool three_colour, int palette[4][4])
+{
+    UnpackColor(c0, palette[0]);
+    UnpackColor(c1, palette[1]);
+    for (int c = 0; c < 3; c++) {
+        if (three_colour) {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+        else {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+    }
+    palette[0][3] = palette[1][3] = palette[2][3] = 255;
+    palette[3][3] = three_colour ? 0 : 255;
+}
+
+
+// Encode the colour of a 4x4 block: endpoints at the corners of the
+// block's bounding box, pulled in a little, and the nearest of the four
+// palette colours for each texel
+static void EncodeColorBlock(const unsigned char block[16][4], unsigned char *out)
+{
+    int low[3] = { 255, 255, 255 }, high[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 3; c++) {
+            low[c] = std::min(low[c], (int) block[i][c]);
+            high[c] = std::max(high[c], (int) block[i][c]);
+        }
+    }
+    for (int c = 0; c < 3; c++) {
+        int inset = (high[c] - low[c]) / 16;
+        low[c] += inset;
+        high[c] -= inset;
+    }
+    uint16_t c0 = PackColor(high), c1 = PackColor(low);
+    if (c0 < c1) {
+        std::swap(c0, c1);
+    }
+
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        int palette[4][4];
+        MakePalette(c0, c1, false, palette);
+        for (int i = 0; i < 16; i++) {
+            int best = 0, best_distance = 1 << 30;
+            for (int p = 0; p < 4; p++) {
+                int distance = 0;
+                for (int c = 0; c < 3; c++) {
+                    int d = block[i][c] - palette[p][c];
+                    distance += d * d;
+                }
+                if (distance < best_distance) {
+                    best = p;
+                    best_distance = distance;
+                }
+            }
+            indices |= (uint32_t) best << (2 * i);
+        }
+    }
+    out[0] = (unsigned char) (c0 & 255);
+    out[1] = (unsigned char) (c0 >> 8);
+    out[2] = (unsigned char) (c1 & 255);
+    out[3] = (unsigned char) (c1 >> 8);
+    for (int b = 0; b < 4; b++) {
+        out[4 + b] = (unsigned char) (indices >> (8 * b));
+    }
+}
+
+
+// The eight alpha values between two endpoints, first larger
+static void MakeAlphaPalette(int a0, int a1, int palette[8])
+{
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (int i = 1; i < 7; i++) {
+            palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+        }
+    }
+    else {
+        for (int i = 1; i < 5; i++) {
+            palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+
+// Encode the alpha of a 4x4 block: endpoints at its extremes, so fully
+// opaque and fully clear texels stay exact
+static void EncodeAlphaBlock(const unsigned char block[16][4], unsigned char *out)
+{
+    int high = 0, low = 255;
+    for (int i = 0; i < 16; i++) {
+        high = std::max(high, (int) block[i][3]);
+        low = std::min(low, (int) block[i][3]);
+    }
+    uint64_t indices = 0;
+    if (high != low) {
+        int palette[8];
+        MakeAlphaPalette(high, low, palette);
+        for (int i = 0; i < 16; i++) {
+            int best = 0, best_distance = 256;
+            for (int p = 0; p < 8; p++) {
+                int distance = std::abs(block[i][3] - palette[p]);
+                if (distance < best_distance) {
+                    best = p;
+                    best_distance = distance;
+                }
+            }
+            indices |= (uint64_t) best << (3 * i);
+        }
+    }
+    out[0] = (unsigned char) high;
+    out[1] = (unsigned char) low;
+    for (int b = 0; b < 6; b++) {
+        out[2 + b] = (unsigned char) (indices >> (8 * b));
+    }
+}
+
+
+static void CompressLevel(int format, const std::vector<unsigned char> &pixels, int width, int height, unsigned char *out)
+{
+    for (int by = 0; by < height; by += 4) {
+        for (int bx = 0; bx < width; bx += 4) {
+            // Blocks past the edge of small levels repeat the last texel
+            unsigned char block[16][4];
+            for (int i = 0; i < 16; i++) {
+                int x = std::min(bx + i % 4, width - 1);
+                int y = std::min(by + i / 4, height - 1);
+                memcpy(block[i], &pixels[(y * width + x) * 4], 4);
+            }
+            if (format == TEXTURE_BC3) {
+                EncodeAlphaBlock(block, out);
+                out += 8;
+            }
+            EncodeColorBlock(block, out);
+            out += 8;
+        }
+    }
+}
+
+
+void BuildTexture(const unsigned char *pixels, int width, int height, bool compress, std::vector<unsigned char> &blob)
+{
+    int format = TEXTURE_RGBA8;
+    if (compress) {
+        format = HasTransparency(pixels, width, height) ? TEXTURE_BC3 : TEXTURE_BC1;
+    }
+
+    std::vector<unsigned char> level(pixels, pixels + (std::size_t) width * height * 4);
+    PremultiplyAlpha(level.data(), width, height);
+
+    TextureHeader header;
+    memset(&header, 0, sizeof(header));
+    header.format = (uint32_t) format;
+    header.width = (uint32_t) width;
+    header.height = (uint32_t) height;
+
+    std::size_t start = blob.size();
+    blob.resize(start + sizeof(header));
+    std::vector<unsigned char> next;
+    int level_width = width, level_height = height;
+    for (int i = 0; i < MAX_TEXTURE_LEVELS; i++) {
+        std::size_t offset = (blob.size() - start + level_alignment_g - 1) & ~(level_alignment_g - 1);
+        std::size_t size = GetLevelSize(format, level_width, level_height);
+        blob.resize(start + offset + size);
+        if (format == TEXTURE_RGBA8) {
+            memcpy(&blob[start + offset], level.data(), size);
+        }
+        else {
+            CompressLevel(format, level, level_width, level_height, &blob[start + offset]);
+        }
+        header.level_offsets[i] = (uint32_t) offset;
+        header.level_sizes[i] = (uint32_t) size;
+        header.num_levels++;
+
+        if (level_width == 1 && level_height == 1) {
+            break;
+        }
+        Downsample(level, level_width, level_height, next);
+        level.swap(next);
+        level_width = std::max(1, level_width / 2);
+        level_height = std::max(1, level_height / 2);
+    }
+    memcpy(&blob[start], &header, sizeof(header));
+}
+
+
+bool ReadTexture(const unsigned char *blob, std::size_t size, TextureView &view)
+{
+    TextureHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, blob, sizeof(header));
+    if (header.format >= NUM_TEXTURE_FORMATS || header.num_levels < 1 || header.num_levels > MAX_TEXTURE_LEVELS ||
+        header.width < 1 || header.height < 1) {
+        return false;
+    }
+
+    view.format = (int) header.format;
+    view.num_levels = (int) header.num_levels;
+    int width = (int) header.width, height = (int) header.height;
+    for (int i = 0; i < view.num_levels; i++) {
+        std::size_t offset = header.level_offsets[i], level_size = header.level_sizes[i];
+        if (offset > size || level_size > size - offset || level_size != GetLevelSize(view.format, width, height)) {
+            return false;
+        }
+        view.levels[i].data = blob + offset;
+        view.levels[i].size = level_size;
+        view.levels[i].width = width;
+        view.levels[i].height = height;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    return true;
+}
+
+
+void DecompressLevel(int format, const TextureLevel &level, std::vector<unsigned char> &pixels)
+{
+    int width = level.width, height = level.height;
+    pixels.resize((std::size_t) width * height * 4);
+    if (format == TEXTURE_RGBA8) {
+        memcpy(pixels.data(), level.data, pixels.size());
+        return;
+    }
+
+    const unsigned char *in = level.data;
+    for (int by = 0; by < height; by += 4) {
+        for (int bx = 0; bx < width; bx += 4) {
+            int alpha[16];
+            for (int i = 0; i < 16; i++) {
+                alpha[i] = 255;
+            }
+            if (format == TEXTURE_BC3) {
+                int palette[8];
+                MakeAlphaPalette(in[0], in[1], palette);
+                uint64_t indices = 0;
+                for (int b = 0; b < 6; b++) {
+                    indices |= (uint64_t) in[2 + b] << (8 * b);
+                }
+                for (int i = 0; i < 16; i++) {
+                    alpha[i] = palette[(indices >> (3 * i)) & 7];
+                }
+                in += 8;
+            }
+
+            // BC3 colour blocks always use four colours
+            uint16_t c0 = (uint16_t) (in[0] | in[1] << 8), c1 = (uint16_t) (in[2] | in[3] << 8);
+            int palette[4][4];
+            MakePalette(c0, c1, format == TEXTURE_BC1 && c0 <= c1, palette);
+            uint32_t indices = (uint32_t) in[4] | (uint32_t) in[5] << 8 | (uint32_t) in[6] << 16 | (uint32_t) in[7] << 24;
+            in += 8;
+
+            for (int i = 0; i < 16; i++) {
+                int x = bx + i % 4, y = by + i / 4;
+                if (x >= width || y >= height) {
+                    continue;
+                }
+                const int *color = palette[(indices >> (2 * i)) & 3];
+                unsigned char *texel = &pixels[(y * width + x) * 4];
+                for (int c = 0; c < 3; c++) {
+                    texel[c] = (unsigned char) color[c];
+                }
+                texel[3] = (unsigned char) (format == TEXTURE_BC3 ? alpha[i] : color[3]);
+            }
+        }
+    }
+}
+
+} // namespace game
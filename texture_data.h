@@ -0,0 +1,74 @@
+#ifndef TEXTURE_DATA_H_
+#define TEXTURE_DATA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace game {
+
+    // How the texels of a texture are stored
+    enum TextureFormat {
+        TEXTURE_RGBA8,  // four bytes per texel
+        TEXTURE_BC1,    // S3TC DXT1, 8 bytes per 4x4 block, opaque
+        TEXTURE_BC3,    // S3TC DXT5, 16 bytes per 4x4 block, with alpha
+        NUM_TEXTURE_FORMATS
+    };
+
+    // Most mipmap levels a texture can have; enough for 32768 texels a side
+    static const int MAX_TEXTURE_LEVELS = 16;
+
+    // Start of a texture blob, as stored in an ASSET_TEXTURE entry of an
+    // asset archive, followed by each level in turn on a 16 byte boundary
+    // Texels are premultiplied by alpha, rows from the top, and every level
+    // down to 1x1 is there, each a box filtered half of the one before
+    struct TextureHeader {
+        uint32_t format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t num_levels;
+        uint32_t level_offsets[MAX_TEXTURE_LEVELS];  // from the start of the blob
+        uint32_t level_sizes[MAX_TEXTURE_LEVELS];
+    };
+
+    // One level of a texture, viewed where it lies
+    struct TextureLevel {
+        const unsigned char *data;
+        std::size_t size;
+        int width;
+        int height;
+    };
+
+    // Every level of a texture blob
+    struct TextureView {
+        int format;
+        int num_levels;
+        TextureLevel levels[MAX_TEXTURE_LEVELS];
+    };
+
+    // Name of a format, for logs
+    const char *GetTextureFormatName(int format);
+
+    // Multiply the colour of each RGBA8 texel by its alpha
+    void PremultiplyAlpha(unsigned char *pixels, int width, int height);
+
+    // Whether any RGBA8 texel is less than opaque
+    bool HasTransparency(const unsigned char *pixels, int width, int height);
+
+    // Build the blob of a texture from straight RGBA8 pixels: premultiply
+    // them, make the mipmaps and, when compress is set, store each level as
+    // BC1 if the image is opaque and BC3 otherwise. The blob is appended
+    void BuildTexture(const unsigned char *pixels, int width, int height, bool compress, std::vector<unsigned char> &blob);
+
+    // View the levels of a blob; false if it is damaged
+    bool ReadTexture(const unsigned char *blob, std::size_t size, TextureView &view);
+
+    // Expand a level of any format to RGBA8, for GPUs without S3TC
+    void DecompressLevel(int format, const TextureLevel &level, std::vector<unsigned char> &pixels);
+
+    // Bytes a level of the given format and size takes
+    std::size_t GetLevelSize(int format, int width, int height);
+
+} // namespace game
+
+#endif // TEXTURE_DATA_H_
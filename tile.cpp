@@ -1,83 +0,0 @@
-#include <iostream>
-#include <string>
-#include <glm/gtc/type_ptr.hpp>
-
-#include "tile.h"
-
-namespace game {
-
-    Tile::Tile(void) : Geometry()
-    {
-        // Initialize variables with default values
-        vbo_ = 0;
-        ebo_ = 0;
-        size_ = 0;
-    }
-
-
-    void Tile::CreateGeometry(void) {
-
-        // The face of the square is defined by four vertices and two triangles
-
-        // Number of attributes for vertices and faces
-        // const int vertex_att = 7;  // 7 attributes per vertex: 2D (or 3D) position (2), RGB color (3), 2D texture coordinates (2)
-        // const int face_att = 3; // Vertex indices (3)
-
-        GLfloat vertex[] = {
-            // Four vertices of a square
-            // Position      Color                Texture coordinates
-            -0.5f,  0.5f,    1.0f, 0.0f, 0.0f,    0.0f, 0.0f, // Top-left
-             0.5f,  0.5f,    0.0f, 1.0f, 0.0f,    9.0f, 0.0f, // Top-right
-             0.5f, -0.5f,    0.0f, 0.0f, 1.0f,    9.0f, 9.0f, // Bottom-right
-            -0.5f, -0.5f,    1.0f, 1.0f, 1.0f,    0.0f, 9.0f  // Bottom-left
-        };
-
-        // Two triangles referencing the vertices
-        GLuint face[] = {
-            0, 1, 2, // t1
-            2, 3, 0  // t2
-        };
-
-        // Create buffer for vertices
-        glGenBuffers(1, &vbo_);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertex), vertex, GL_STATIC_DRAW);
-
-        // Create buffer for faces (index buffer)
-        glGenBuffers(1, &ebo_);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(face), face, GL_STATIC_DRAW);
-
-        // Set number of elements in array buffer (6 in this case)
-        size_ = sizeof(face) / sizeof(GLuint);
-    }
-
-
-    void Tile::SetGeometry(GLuint shader_program)
-    {
-
-        // No blending
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(GL_LESS);
-        glDisable(GL_BLEND);
-
-        // Bind buffers
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
-
-        // Set attributes for shaders
-        // Should be consistent with how we created the buffers for the square
-        GLint vertex_att = glGetAttribLocation(shader_program, "vertex");
-        glVertexAttribPointer(vertex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
-        glEnableVertexAttribArray(vertex_att);
-
-        GLint color_att = glGetAttribLocation(shader_program, "color");
-        glVertexAttribPointer(color_att, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
-        glEnableVertexAttribArray(color_att);
-
-        GLint tex_att = glGetAttribLocation(shader_program, "uv");
-        glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(5 * sizeof(GLfloat)));
-        glEnableVertexAttribArray(tex_att);
-    }
-
-} // namespace game
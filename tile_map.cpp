@@ -0,0 +1,354 @@
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "tile_map.h"
+
+namespace game {
+
+// Floats per vertex: position (2), color (3), texture coordinates (2)
+static const int vertex_floats_g = 7;
+
+// Colour each tile type is tinted with in the atlas
+static const float tile_tints_g[NUM_TILE_TYPES][3] = {
+    { 1.0f, 1.0f, 1.0f },    // grass
+    { 0.7f, 0.8f, 0.7f },    // dark grass
+    { 1.15f, 1.0f, 0.55f },  // dry grass
+    { 0.95f, 0.7f, 0.45f }   // dirt
+};
+
+// Mix the coordinates of a tile into a well spread 32-bit value
+static unsigned int HashTile(int x, int y, unsigned int seed)
+{
+    unsigned int h = seed;
+    h ^= (unsigned int) x * 0x8da6b343u;
+    h ^= (unsigned int) y * 0xd8163841u;
+    h = (h ^ (h >> 13)) * 0x85ebca6bu;
+    h ^= h >> 16;
+    return h;
+}
+
+
+TileChunk::TileChunk(void) : Geometry()
+{
+    vbo_ = 0;
+    ebo_ = 0;
+    size_ = 0;
+}
+
+
+TileChunk::~TileChunk()
+{
+    // The index buffer belongs to the tile map
+    if (vbo_) {
+        glDeleteBuffers(1, &vbo_);
+    }
+}
+
+
+void TileChunk::CreateGeometry(GLuint shared_ebo, int num_tiles)
+{
+    // Allocate room for a full chunk once; streaming only rewrites it
+    glGenBuffers(1, &vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferData(GL_ARRAY_BUFFER, num_tiles * 4 * vertex_floats_g * sizeof(GLfloat), NULL, GL_STATIC_DRAW);
+    ebo_ = shared_ebo;
+    size_ = 0;
+}
+
+
+void TileChunk::Upload(const std::vector<GLfloat> &vertices)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(GLfloat), vertices.data());
+
+    // Six indices for every four vertices
+    size_ = (int) (vertices.size() / (4 * vertex_floats_g)) * 6;
+}
+
+
+void TileChunk::SetGeometry(GLuint shader_program)
+{
+    // No blending
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+
+    // Bind buffers
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+
+    // Same layout as the sprite geometry
+    GLint vertex_att = glGetAttribLocation(shader_program, "vertex");
+    glVertexAttribPointer(vertex_att, 2, GL_FLOAT, GL_FALSE, vertex_floats_g * sizeof(GLfloat), 0);
+    glEnableVertexAttribArray(vertex_att);
+
+    GLint color_att = glGetAttribLocation(shader_program, "color");
+    glVertexAttribPointer(color_att, 3, GL_FLOAT, GL_FALSE, vertex_floats_g * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(color_att);
+
+    GLint tex_att = glGetAttribLocation(shader_program, "uv");
+    glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, vertex_floats_g * sizeof(GLfloat), (void*)(5 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(tex_att);
+}
+
+
+TileMap::TileMap(int width, int height, float tile_size, unsigned int seed)
+{
+    width_ = width;
+    height_ = height;
+    tile_size_ = tile_size;
+    seed_ = seed;
+    shader_ = nullptr;
+    atlas_ = 0;
+    atlas_inset_ = glm::vec2(0.0f);
+    ebo_ = 0;
+    camera_chunk_ = glm::ivec2(0, 0);
+    streamed_ = false;
+}
+
+
+TileMap::~TileMap()
+{
+    // Free the chunk buffers before the shared index buffer
+    slots_.clear();
+    if (ebo_) {
+        glDeleteBuffers(1, &ebo_);
+    }
+    if (atlas_) {
+        glDeleteTextures(1, &atlas_);
+    }
+}
+
+
+void TileMap::Init(AssetLoader &assets, const std::string &tile_image, Shader *shader)
+{
+    shader_ = shader;
+    atlas_ = CreateAtlas(assets, tile_image);
+
+    // One index buffer serves every chunk: two triangles per tile
+    const int num_tiles = CHUNK_TILES * CHUNK_TILES;
+    std::vector<GLuint> faces;
+    faces.reserve(num_tiles * 6);
+    for (int i = 0; i < num_tiles; i++) {
+        GLuint v = i * 4;
+        GLuint face[] = { v, v + 1, v + 2, v + 2, v + 3, v };
+        faces.insert(faces.end(), face, face + 6);
+    }
+    glGenBuffers(1, &ebo_);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, faces.size() * sizeof(GLuint), faces.data(), GL_STATIC_DRAW);
+
+    // Fixed pool covering the chunks around the camera
+    const int side = 2 * STREAM_RADIUS + 1;
+    slots_.resize(side * side);
+    for (int i = 0; i < (int) slots_.size(); i++) {
+        slots_[i].geometry.CreateGeometry(ebo_, num_tiles);
+        slots_[i].chunk = glm::ivec2(0, 0);
+        slots_[i].loaded = false;
+    }
+    vertices_.reserve(num_tiles * 4 * vertex_floats_g);
+}
+
+
+int TileMap::GetTileType(int x, int y) const
+{
+    // Patches of 4x4 tiles share a type, with grass the most common
+    unsigned int patch = HashTile(x >> 2, y >> 2, seed_) % 100;
+    int type;
+    if (patch < 55) {
+        type = TILE_GRASS;
+    }
+    else if (patch < 75) {
+        type = TILE_DARK_GRASS;
+    }
+    else if (patch < 90) {
+        type = TILE_DRY_GRASS;
+    }
+    else {
+        type = TILE_DIRT;
+    }
+
+    // Break up the plain grass with the odd darker tile
+    if (type == TILE_GRASS && HashTile(x, y, seed_ + 1) % 8 == 0) {
+        type = TILE_DARK_GRASS;
+    }
+    return type;
+}
+
+
+void TileMap::Update(const glm::vec2 &camera_position)
+{
+    // Chunk under the camera; the map is centred on the origin
+    const float chunk_length = CHUNK_TILES * tile_size_;
+    glm::vec2 from_corner = camera_position + 0.5f * tile_size_ * glm::vec2(width_, height_);
+    glm::ivec2 camera_chunk((int) std::floor(from_corner.x / chunk_length), (int) std::floor(from_corner.y / chunk_length));
+    if (streamed_ && camera_chunk == camera_chunk_) {
+        return;
+    }
+    camera_chunk_ = camera_chunk;
+    streamed_ = true;
+
+    const int num_chunks_x = (width_ + CHUNK_TILES - 1) / CHUNK_TILES;
+    const int num_chunks_y = (height_ + CHUNK_TILES - 1) / CHUNK_TILES;
+    auto wanted = [&](const glm::ivec2 &chunk) {
+        return chunk.x >= 0 && chunk.y >= 0 && chunk.x < num_chunks_x && chunk.y < num_chunks_y &&
+               std::abs(chunk.x - camera_chunk.x) <= STREAM_RADIUS && std::abs(chunk.y - camera_chunk.y) <= STREAM_RADIUS;
+    };
+
+    // Release the slots that have fallen out of range
+    for (int i = 0; i < (int) slots_.size(); i++) {
+        if (slots_[i].loaded && !wanted(slots_[i].chunk)) {
+            slots_[i].loaded = false;
+        }
+    }
+
+    // Bake the chunks that came into range into the free slots
+    for (int dy = -STREAM_RADIUS; dy <= STREAM_RADIUS; dy++) {
+        for (int dx = -STREAM_RADIUS; dx <= STREAM_RADIUS; dx++) {
+            glm::ivec2 chunk = camera_chunk + glm::ivec2(dx, dy);
+            if (!wanted(chunk)) {
+                continue;
+            }
+            bool resident = false;
+            int free_slot = -1;
+            for (int i = 0; i < (int) slots_.size(); i++) {
+                if (slots_[i].loaded && slots_[i].chunk == chunk) {
+                    resident = true;
+                    break;
+                }
+                if (!slots_[i].loaded && free_slot < 0) {
+                    free_slot = i;
+                }
+            }
+            if (!resident && free_slot >= 0) {
+                LoadChunk(slots_[free_slot], chunk);
+            }
+        }
+    }
+}
+
+
+void TileMap::LoadChunk(ChunkSlot &slot, const glm::ivec2 &chunk)
+{
+    vertices_.clear();
+
+    int first_x = chunk.x * CHUNK_TILES;
+    int first_y = chunk.y * CHUNK_TILES;
+    int last_x = std::min(first_x + CHUNK_TILES, width_);
+    int last_y = std::min(first_y + CHUNK_TILES, height_);
+
+    for (int y = first_y; y < last_y; y++) {
+        for (int x = first_x; x < last_x; x++) {
+            // Corners relative to the chunk
+            float x0 = (x - first_x) * tile_size_;
+            float y0 = (y - first_y) * tile_size_;
+            float x1 = x0 + tile_size_;
+            float y1 = y0 + tile_size_;
+
+            // Cell of the tile type in the 2x2 atlas
+            int type = GetTileType(x, y);
+            float u0 = (type % 2) * 0.5f + atlas_inset_.x;
+            float u1 = (type % 2 + 1) * 0.5f - atlas_inset_.x;
+            float v0 = (type / 2) * 0.5f + atlas_inset_.y;
+            float v1 = (type / 2 + 1) * 0.5f - atlas_inset_.y;
+
+            GLfloat tile[] = {
+                // Position  Color                Texture coordinates
+                x0, y1,      1.0f, 1.0f, 1.0f,    u0, v0, // Top-left
+                x1, y1,      1.0f, 1.0f, 1.0f,    u1, v0, // Top-right
+                x1, y0,      1.0f, 1.0f, 1.0f,    u1, v1, // Bottom-right
+                x0, y0,      1.0f, 1.0f, 1.0f,    u0, v1  // Bottom-left
+            };
+            vertices_.insert(vertices_.end(), tile, tile + 4 * vertex_floats_g);
+        }
+    }
+
+    slot.geometry.Upload(vertices_);
+    slot.chunk = chunk;
+    slot.loaded = true;
+}
+
+
+void TileMap::Render(DrawList &draw_list) const
+{
+    UniformBlock uniforms;
+    uniforms.motion = glm::vec3(0.0f);
+    uniforms.time = 0.0f;
+    uniforms.ghost = false;
+    uniforms.gold = false;
+    uniforms.animated = false;
+
+    glm::vec2 map_corner = -0.5f * tile_size_ * glm::vec2(width_, height_);
+    for (int i = 0; i < (int) slots_.size(); i++) {
+        const ChunkSlot &slot = slots_[i];
+        if (!slot.loaded) {
+            continue;
+        }
+        glm::vec2 corner = map_corner + (float) (CHUNK_TILES) * tile_size_ * glm::vec2(slot.chunk);
+        uniforms.transformation = glm::translate(glm::mat4(1.0f), glm::vec3(corner.x, corner.y, GROUND_DEPTH));
+        draw_list.Add(LAYER_GROUND, GROUND_DEPTH, (Geometry *) &slot.geometry, shader_, atlas_, uniforms);
+    }
+}
+
+
+GLuint TileMap::CreateAtlas(AssetLoader &assets, const std::string &tile_image)
+{
+    ImageData loaded;
+    const unsigned char *image = nullptr;
+    int width = 1, height = 1;
+    if (assets.LoadImage(tile_image, loaded)) {
+        image = loaded.pixels;
+        width = loaded.width;
+        height = loaded.height;
+    }
+    else {
+        std::cout << "Cannot load texture " << tile_image << std::endl;
+    }
+
+    // One tinted copy of the tile per type, in a 2x2 grid; the pixels are
+    // premultiplied, which tinting the colour keeps
+    int atlas_width = 2 * width;
+    int atlas_height = 2 * height;
+    std::vector<unsigned char> atlas(atlas_width * atlas_height * 4, 255);
+    for (int type = 0; type < NUM_TILE_TYPES; type++) {
+        int cell_x = (type % 2) * width;
+        int cell_y = (type / 2) * height;
+        for (int y = 0; y < height && image; y++) {
+            for (int x = 0; x < width; x++) {
+                const unsigned char *src = image + (y * width + x) * 4;
+                unsigned char *dst = &atlas[((cell_y + y) * atlas_width + cell_x + x) * 4];
+                for (int c = 0; c < 3; c++) {
+                    dst[c] = (unsigned char) std::min(255.0f, src[c] * tile_tints_g[type][c]);
+                }
+                dst[3] = src[3];
+            }
+        }
+    }
+    assets.FreeImage(loaded);
+    atlas_inset_ = glm::vec2(0.5f / atlas_width, 0.5f / atlas_height);
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, atlas_width, atlas_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, atlas.data());
+
+    // Mipmaps for the zoomed out ground, stopping while a cell is still 16
+    // texels across so neighbouring tints barely bleed into each other
+    int max_level = 0;
+    while ((std::min(width, height) >> (max_level + 1)) >= 16) {
+        max_level++;
+    }
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, max_level);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return texture;
+}
+
+} // namespace game
@@ -0,0 +1,116 @@
+#ifndef TILE_MAP_H_
+#define TILE_MAP_H_
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#include "asset_loader.h"
+#include "geometry.h"
+#include "shader.h"
+#include "render_command_buffer.h"
+
+namespace game {
+
+    // Kinds of ground tiles, in the order of their cells in the atlas
+    enum TileType {
+        TILE_GRASS,
+        TILE_DARK_GRASS,
+        TILE_DRY_GRASS,
+        TILE_DIRT,
+        NUM_TILE_TYPES
+    };
+
+    // Vertex buffer holding the baked tiles of one chunk
+    // A chunk is drawn with a single call; its vertices are relative to the
+    // chunk's corner, which the transformation matrix moves into place
+    class TileChunk : public Geometry {
+
+        public:
+            TileChunk(void);
+            ~TileChunk();
+
+            // Create the buffers (called once); all chunks share one index buffer
+            void CreateGeometry(GLuint shared_ebo, int num_tiles);
+
+            // Replace the vertices with a newly baked chunk
+            void Upload(const std::vector<GLfloat> &vertices);
+
+            // Use the geometry
+            void SetGeometry(GLuint shader_program) override;
+
+    }; // class TileChunk
+
+    // A large tiled ground streamed in chunks around the camera
+    // Tile types come from a function of the tile coordinates rather than a
+    // stored array, and only a fixed pool of chunks is resident at a time,
+    // so memory and draw calls do not grow with the size of the world
+    class TileMap {
+
+        public:
+            // Size of the world in tiles, and of each tile in world units
+            TileMap(int width, int height, float tile_size, unsigned int seed);
+            ~TileMap();
+
+            // Build the atlas from a tile image of the assets and create the chunk pool
+            // Must be called on the thread that owns the GL context
+            void Init(AssetLoader &assets, const std::string &tile_image, Shader *shader);
+
+            // Stream chunks in and out around the camera
+            // Must be called on the thread that owns the GL context
+            void Update(const glm::vec2 &camera_position);
+
+            // Record the resident chunks into the ground layer
+            void Render(DrawList &draw_list) const;
+
+            // Type of the tile at the given tile coordinates
+            int GetTileType(int x, int y) const;
+
+            // Number of tiles along the side of a chunk
+            static const int CHUNK_TILES = 8;
+
+            // Chunks kept resident in each direction from the camera's chunk
+            static const int STREAM_RADIUS = 1;
+
+        private:
+            // A slot in the chunk pool and the chunk it currently holds
+            struct ChunkSlot {
+                TileChunk geometry;
+                glm::ivec2 chunk;
+                bool loaded;
+            };
+
+            // Bake the vertices of a chunk into a slot
+            void LoadChunk(ChunkSlot &slot, const glm::ivec2 &chunk);
+
+            // Build the atlas texture from the tile image
+            GLuint CreateAtlas(AssetLoader &assets, const std::string &tile_image);
+
+            int width_;
+            int height_;
+            float tile_size_;
+            unsigned int seed_;
+
+            Shader *shader_;
+            GLuint atlas_;
+
+            // Half a texel in atlas UV units, to keep filtering inside a cell
+            glm::vec2 atlas_inset_;
+
+            GLuint ebo_;
+            std::vector<ChunkSlot> slots_;
+
+            // Scratch buffer for baking chunks
+            std::vector<GLfloat> vertices_;
+
+            // Chunk the camera was in at the last update
+            glm::ivec2 camera_chunk_;
+            bool streamed_;
+
+    }; // class TileMap
+
+} // namespace game
+
+#endif // TILE_MAP_H_
@@ -1,6 +1,6 @@
-#include <GLFW/glfw3.h>
 #include <iostream>
 
+#include "clock.h"
 #include "timer.h"
 
 namespace game {
@@ -19,7 +19,7 @@ Timer::~Timer(void)
 void Timer::Start(float end_time)
 {
     // Set the end time to the current time plus the time to wait
-    float current_time = glfwGetTime();
+    double current_time = GetClockTime();
     if (end_time_ == -1.0f) {
         end_time_ = current_time + end_time;
         // std::cout<<"Timer started with end time: "<<end_time_<<" | Current time is: "<<current_time<<std::endl;
@@ -30,7 +30,7 @@ void Timer::Start(float end_time)
 
 bool Timer::Finished(void)
 {
-    double current_time = glfwGetTime();
+    double current_time = GetClockTime();
 
     //Check if the current time is greater than the end time
     if (current_time >= end_time_ && end_time_ != -1.0f) {
@@ -42,8 +42,8 @@ bool Timer::Finished(void)
 
 float Timer::TimeLeft(void) {
     if (Running()) {
-        float currentTime = glfwGetTime();
-        float timeLeft = end_time_ - currentTime;
+        double currentTime = GetClockTime();
+        float timeLeft = (float) (end_time_ - currentTime);
         return timeLeft > 0 ? timeLeft : 0.0f;
     }
     return 0.0f;
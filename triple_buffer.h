@@ -0,0 +1,58 @@
+#ifndef TRIPLE_BUFFER_H_
+#define TRIPLE_BUFFER_H_
+
+#include <atomic>
+
+namespace game {
+
+    // Hands the latest value from one producer thread to one consumer thread
+    // without either of them ever waiting on the other
+    // The producer fills GetWriteBuffer() and calls Publish(); the consumer
+    // calls Acquire() and reads GetReadBuffer() until its next Acquire()
+    template <typename T>
+    class TripleBuffer {
+
+        public:
+            TripleBuffer(void) : write_(0), read_(1), middle_(2) {}
+
+            // Buffer owned by the producer
+            T &GetWriteBuffer(void) { return buffers_[write_]; }
+
+            // Make the write buffer the newest value and take back a free one
+            void Publish(void) {
+                write_ = middle_.exchange(write_ | NEW_BIT_, std::memory_order_acq_rel) & INDEX_MASK_;
+            }
+
+            // Switch to the newest published value, if there is one
+            // Returns false if nothing was published since the last call
+            bool Acquire(void) {
+                if (!(middle_.load(std::memory_order_relaxed) & NEW_BIT_)) {
+                    return false;
+                }
+                read_ = middle_.exchange(read_, std::memory_order_acq_rel) & INDEX_MASK_;
+                return true;
+            }
+
+            // Buffer owned by the consumer
+            const T &GetReadBuffer(void) const { return buffers_[read_]; }
+
+        private:
+            static const int NEW_BIT_ = 4;
+            static const int INDEX_MASK_ = 3;
+
+            T buffers_[3];
+
+            // Only touched by the producer
+            int write_;
+
+            // Only touched by the consumer
+            int read_;
+
+            // Index of the spare buffer, flagged when it holds a new value
+            std::atomic<int> middle_;
+
+    }; // class TripleBuffer
+
+} // namespace game
+
+#endif // TRIPLE_BUFFER_H_
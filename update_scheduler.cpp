@@ -0,0 +1,109 @@
+#include <algorithm>
+
+#include "update_scheduler.h"
+
+namespace game {
+
+// Passed by reference to std::min, so it needs a definition
+constexpr double UpdateScheduler::MAX_CATCH_UP_STEP;
+
+// Ticks between updates in each band
+static const int band_intervals_g[NUM_UPDATE_BANDS] = { 1, UpdateScheduler::MID_INTERVAL, UpdateScheduler::FAR_INTERVAL };
+
+
+UpdateScheduler::UpdateScheduler(void)
+{
+    budget_ = 1024;
+    tick_ = 0;
+    stats_ = UpdateStats();
+}
+
+
+int UpdateScheduler::GetBand(float distance_squared)
+{
+    if (distance_squared < NEAR_DISTANCE * NEAR_DISTANCE) {
+        return BAND_NEAR;
+    }
+    if (distance_squared < MID_DISTANCE * MID_DISTANCE) {
+        return BAND_MID;
+    }
+    return BAND_FAR;
+}
+
+
+void UpdateScheduler::CatchUp(GameObject *object)
+{
+    // Long gaps are split up so steering does not overshoot in one step
+    while (object->lod_pending_time_ > 0.0) {
+        double step = std::min(object->lod_pending_time_, MAX_CATCH_UP_STEP);
+        object->Update(step);
+        object->lod_pending_time_ -= step;
+    }
+    object->lod_pending_time_ = 0.0;
+    object->lod_ticks_ = 0;
+    object->lod_due_ = false;
+}
+
+
+void UpdateScheduler::Schedule(std::vector<GameObject*> &objects, int first, const glm::vec2 &focus, double delta_time)
+{
+    stats_ = UpdateStats();
+    scheduled_.clear();
+
+    int count = (int) objects.size() - first;
+    if (count <= 0) {
+        tick_++;
+        return;
+    }
+
+    // Start the budgeted updates at a different place each tick so no
+    // object is always the one left over
+    int start = (int) (tick_ % (unsigned int) count);
+    int budget = budget_;
+
+    for (int n = 0; n < count; n++) {
+        GameObject *object = objects[first + (start + n) % count];
+
+        if (object->IsSleeping()) {
+            stats_.sleeping++;
+            continue;
+        }
+
+        object->lod_pending_time_ += delta_time;
+        object->lod_ticks_++;
+
+        glm::vec2 offset = glm::vec2(object->GetPosition().x, object->GetPosition().y) - focus;
+        int band = GetBand(glm::dot(offset, offset));
+        if (object->lod_ticks_ < band_intervals_g[band]) {
+            continue;
+        }
+
+        // Nearby objects are never held back
+        if (band != BAND_NEAR) {
+            if (budget <= 0) {
+                stats_.deferred++;
+                continue;
+            }
+            budget--;
+        }
+
+        object->lod_due_ = true;
+        ScheduledUpdate update;
+        update.object = object;
+        update.delta_time = object->lod_pending_time_;
+        scheduled_.push_back(update);
+        stats_.updated[band]++;
+    }
+
+    tick_++;
+}
+
+
+void UpdateScheduler::Run(void)
+{
+    for (int i = 0; i < (int) scheduled_.size(); i++) {
+        CatchUp(scheduled_[i].object);
+    }
+}
+
+} // namespace game
@@ -0,0 +1,91 @@
+#ifndef UPDATE_SCHEDULER_H_
+#define UPDATE_SCHEDULER_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "game_object.h"
+
+namespace game {
+
+    // Distance bands of the simulation level of detail, nearest first
+    enum UpdateBand {
+        BAND_NEAR,
+        BAND_MID,
+        BAND_FAR,
+        NUM_UPDATE_BANDS
+    };
+
+    // What the scheduler did during the last tick
+    struct UpdateStats {
+        int updated[NUM_UPDATE_BANDS]; // objects updated in each band
+        int deferred;                  // due objects pushed to a later tick by the budget
+        int sleeping;                  // objects skipped because they are asleep
+    };
+
+    // An object picked for an update and the time it will be handed
+    struct ScheduledUpdate {
+        GameObject *object;
+        double delta_time;
+    };
+
+    // Decides which game objects are updated each tick
+    // Objects near the focus point (the player) update every tick. Farther
+    // ones update every few ticks and are handed all the time they missed
+    // in one call, so they end up where they would have been. Sleeping
+    // objects are not updated until something wakes them. Updates of mid
+    // and far objects are limited to a budget per tick; objects over the
+    // budget wait for the next tick and lose no time
+    class UpdateScheduler {
+
+        public:
+            // Constructor
+            UpdateScheduler(void);
+
+            // Largest number of mid and far updates per tick
+            void SetBudget(int budget) { budget_ = budget; }
+
+            // Update objects[first..] for a tick of delta_time around the focus point
+            void Update(std::vector<GameObject*> &objects, int first, const glm::vec2 &focus, double delta_time) { Schedule(objects, first, focus, delta_time); Run(); }
+
+            // Update in two halves, so the caller can work on the picked
+            // objects in between: pick the objects due this tick, then update them
+            void Schedule(std::vector<GameObject*> &objects, int first, const glm::vec2 &focus, double delta_time);
+            void Run(void);
+
+            // Objects picked by the last call to Schedule
+            const std::vector<ScheduledUpdate> &GetScheduled(void) const { return scheduled_; }
+
+            // Statistics of the last call to Schedule
+            const UpdateStats &GetStats(void) const { return stats_; }
+
+            // Outer distance of each band but the last, and ticks between updates in each band
+            static constexpr float NEAR_DISTANCE = 12.0f;
+            static constexpr float MID_DISTANCE = 30.0f;
+            static const int MID_INTERVAL = 3;
+            static const int FAR_INTERVAL = 10;
+
+            // Longest single step handed to an object catching up
+            static constexpr double MAX_CATCH_UP_STEP = 0.25;
+
+        private:
+            // Band of an object at the given squared distance from the focus
+            static int GetBand(float distance_squared);
+
+            // Run the object's updates for all the time it has pending
+            static void CatchUp(GameObject *object);
+
+            int budget_;
+
+            // Ticks run so far; rotates where the budgeted updates start
+            unsigned int tick_;
+
+            UpdateStats stats_;
+
+            std::vector<ScheduledUpdate> scheduled_;
+
+    }; // class UpdateScheduler
+
+} // namespace game
+
+#endif // UPDATE_SCHEDULER_H_